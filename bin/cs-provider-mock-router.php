@@ -0,0 +1,1111 @@
+<?php
+
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler - Provider Stand-in Router
+ *
+ * File: bin/cs-provider-mock-router.php
+ * Purpose: PHP built-in server router that emulates the Google Calendar v3 and
+ * Microsoft Graph event endpoints used by GoogleApiClient/OutlookApiClient, so
+ * fetch/apply throughput can be exercised with no network. Started by
+ * bin/cs-provider-mock; all behavior is configured through CS_MOCK_* env vars.
+ *
+ * Emulated surface:
+ * - Google: calendarList, calendars get/patch, events list (paging + syncToken),
+ *   events insert/get/patch/update/delete, multipart /batch/calendar/v3
+ * - Graph: /me, calendars, events list (@odata.nextLink), events/delta
+ *   (@odata.deltaLink), event get/patch/delete, masterCategories, JSON $batch
+ * - Fault injection: fixed latency + jitter, every-Nth 429/503 with Retry-After
+ */
+
+const CS_MOCK_GOOGLE_PREFIX = '/calendar/v3';
+const CS_MOCK_GOOGLE_BATCH_PATH = '/batch/calendar/v3';
+const CS_MOCK_GRAPH_PREFIX = '/v1.0';
+const CS_MOCK_GOOGLE_BATCH_MAX = 50;
+const CS_MOCK_GRAPH_BATCH_MAX = 20;
+
+$stateDir = getenv('CS_MOCK_STATE_DIR');
+if (!is_string($stateDir) || $stateDir === '' || !is_dir($stateDir)) {
+    mock_send(500, ['error' => ['code' => 500, 'message' => 'CS_MOCK_STATE_DIR is not configured']]);
+    return true;
+}
+
+$method = strtoupper((string)($_SERVER['REQUEST_METHOD'] ?? 'GET'));
+$uri = (string)($_SERVER['REQUEST_URI'] ?? '/');
+$path = rawurldecode((string)parse_url($uri, PHP_URL_PATH));
+$query = [];
+parse_str((string)parse_url($uri, PHP_URL_QUERY), $query);
+$body = (string)file_get_contents('php://input');
+
+if (str_starts_with($path, '/_mock/')) {
+    mock_send(...mock_control($stateDir, $method, $path));
+    return true;
+}
+
+mock_inject_latency();
+
+$fault = mock_next_fault($stateDir, mock_route_kind($path));
+if ($fault !== null) {
+    mock_send(...mock_fault_response($fault, str_starts_with($path, CS_MOCK_GRAPH_PREFIX)));
+    return true;
+}
+
+try {
+    if ($path === CS_MOCK_GOOGLE_BATCH_PATH && $method === 'POST') {
+        $contentType = (string)($_SERVER['CONTENT_TYPE'] ?? $_SERVER['HTTP_CONTENT_TYPE'] ?? '');
+        mock_send_raw(...mock_google_batch($stateDir, $contentType, $body));
+        return true;
+    }
+
+    if (str_starts_with($path, CS_MOCK_GOOGLE_PREFIX . '/')) {
+        $payload = mock_decode_body($body);
+        mock_send(...mock_with_state($stateDir, static fn (array &$state): array => mock_google_route(
+            $state,
+            $method,
+            substr($path, strlen(CS_MOCK_GOOGLE_PREFIX)),
+            $query,
+            $payload
+        )));
+        return true;
+    }
+
+    if ($path === CS_MOCK_GRAPH_PREFIX . '/$batch' && $method === 'POST') {
+        mock_send(...mock_graph_batch($stateDir, mock_decode_body($body)));
+        return true;
+    }
+
+    if (str_starts_with($path, CS_MOCK_GRAPH_PREFIX . '/')) {
+        $payload = mock_decode_body($body);
+        mock_send(...mock_with_state($stateDir, static fn (array &$state): array => mock_graph_route(
+            $state,
+            $method,
+            substr($path, strlen(CS_MOCK_GRAPH_PREFIX)),
+            $query,
+            $payload
+        )));
+        return true;
+    }
+} catch (\RuntimeException $e) {
+    mock_send(500, ['error' => ['code' => 500, 'message' => $e->getMessage()]]);
+    return true;
+}
+
+mock_send(404, ['error' => ['code' => 404, 'message' => "No mock route for {$method} {$path}"]]);
+return true;
+
+// ---------------------------------------------------------------------
+// Transport helpers
+// ---------------------------------------------------------------------
+
+/**
+ * @param array<string,mixed>|null $payload
+ * @param array<string,string> $headers
+ */
+function mock_send(int $status, ?array $payload, array $headers = []): void
+{
+    http_response_code($status);
+    foreach ($headers as $name => $value) {
+        header($name . ': ' . $value);
+    }
+    if ($payload === null) {
+        return;
+    }
+    header('Content-Type: application/json; charset=UTF-8');
+    echo json_encode($payload, JSON_UNESCAPED_SLASHES);
+}
+
+/**
+ * @param array<string,string> $headers
+ */
+function mock_send_raw(int $status, string $body, array $headers): void
+{
+    http_response_code($status);
+    foreach ($headers as $name => $value) {
+        header($name . ': ' . $value);
+    }
+    echo $body;
+}
+
+/**
+ * @return array<string,mixed>|null
+ */
+function mock_decode_body(string $body): ?array
+{
+    if (trim($body) === '') {
+        return null;
+    }
+    $decoded = json_decode($body, true);
+    return is_array($decoded) ? $decoded : null;
+}
+
+function mock_env_int(string $name, int $default): int
+{
+    $raw = getenv($name);
+    return is_string($raw) && is_numeric($raw) ? max(0, (int)$raw) : $default;
+}
+
+function mock_inject_latency(): void
+{
+    $latencyMs = mock_env_int('CS_MOCK_LATENCY_MS', 0);
+    $jitterMs = mock_env_int('CS_MOCK_JITTER_MS', 0);
+    $delayMs = $latencyMs + ($jitterMs > 0 ? random_int(0, $jitterMs) : 0);
+    if ($delayMs > 0) {
+        usleep($delayMs * 1000);
+    }
+}
+
+function mock_route_kind(string $path): string
+{
+    if ($path === CS_MOCK_GOOGLE_BATCH_PATH || $path === CS_MOCK_GRAPH_PREFIX . '/$batch') {
+        return 'batch';
+    }
+    return str_starts_with($path, CS_MOCK_GRAPH_PREFIX) ? 'graph' : 'google';
+}
+
+/**
+ * Count one logical request and decide whether it is throttled.
+ * Batch sub-requests are counted individually so per-part throttling can be exercised.
+ */
+function mock_next_fault(string $stateDir, string $kind): ?int
+{
+    $throttleEvery = mock_env_int('CS_MOCK_THROTTLE_EVERY', 0);
+    $unavailableEvery = mock_env_int('CS_MOCK_UNAVAILABLE_EVERY', 0);
+
+    $fault = null;
+    mock_with_stats($stateDir, static function (array &$stats) use ($kind, $throttleEvery, $unavailableEvery, &$fault): void {
+        $stats['requests'] = (int)($stats['requests'] ?? 0) + 1;
+        $stats['byKind'][$kind] = (int)($stats['byKind'][$kind] ?? 0) + 1;
+        $n = $stats['requests'];
+
+        if ($throttleEvery > 0 && $n % $throttleEvery === 0) {
+            $fault = 429;
+            $stats['throttled'] = (int)($stats['throttled'] ?? 0) + 1;
+        } elseif ($unavailableEvery > 0 && $n % $unavailableEvery === 0) {
+            $fault = 503;
+            $stats['unavailable'] = (int)($stats['unavailable'] ?? 0) + 1;
+        }
+    });
+
+    return $fault;
+}
+
+/**
+ * @return array{0:int,1:array<string,mixed>,2:array<string,string>}
+ */
+function mock_fault_response(int $status, bool $graph): array
+{
+    $retryAfter = (string)mock_env_int('CS_MOCK_RETRY_AFTER', 1);
+    $message = $status === 429 ? 'Rate limit exceeded' : 'Service unavailable';
+
+    $body = $graph
+        ? ['error' => ['code' => $status === 429 ? 'TooManyRequests' : 'ServiceNotAvailable', 'message' => $message]]
+        : ['error' => [
+            'code' => $status,
+            'message' => $message,
+            'errors' => [['reason' => $status === 429 ? 'rateLimitExceeded' : 'backendError', 'message' => $message]],
+        ]];
+
+    return [$status, $body, ['Retry-After' => $retryAfter]];
+}
+
+// ---------------------------------------------------------------------
+// State / stats persistence (flock-serialized so PHP_CLI_SERVER_WORKERS is safe)
+// ---------------------------------------------------------------------
+
+/**
+ * Run $fn against the decoded store under an exclusive lock; the store is
+ * rewritten only when $fn bumped its version.
+ *
+ * @param callable(array<string,mixed>&):array $fn
+ * @return array Whatever $fn returns
+ */
+function mock_with_state(string $stateDir, callable $fn): array
+{
+    $path = $stateDir . '/state.json';
+    $fh = fopen($path, 'c+');
+    if ($fh === false) {
+        throw new \RuntimeException("Unable to open mock state: {$path}");
+    }
+
+    try {
+        flock($fh, LOCK_EX);
+        $raw = stream_get_contents($fh);
+        $state = is_string($raw) && trim($raw) !== '' ? json_decode($raw, true) : null;
+        if (!is_array($state)) {
+            $state = mock_empty_state();
+        }
+
+        $before = (int)($state['version'] ?? 0);
+        $response = $fn($state);
+
+        if ((int)($state['version'] ?? 0) !== $before) {
+            ftruncate($fh, 0);
+            rewind($fh);
+            fwrite($fh, (string)json_encode($state, JSON_UNESCAPED_SLASHES));
+            fflush($fh);
+        }
+
+        return $response;
+    } finally {
+        flock($fh, LOCK_UN);
+        fclose($fh);
+    }
+}
+
+/**
+ * @param callable(array<string,mixed>&):void $fn
+ */
+function mock_with_stats(string $stateDir, callable $fn): void
+{
+    $fh = fopen($stateDir . '/stats.json', 'c+');
+    if ($fh === false) {
+        return;
+    }
+
+    try {
+        flock($fh, LOCK_EX);
+        $raw = stream_get_contents($fh);
+        $stats = is_string($raw) && trim($raw) !== '' ? json_decode($raw, true) : null;
+        if (!is_array($stats)) {
+            $stats = [];
+        }
+        $fn($stats);
+        ftruncate($fh, 0);
+        rewind($fh);
+        fwrite($fh, (string)json_encode($stats, JSON_UNESCAPED_SLASHES));
+        fflush($fh);
+    } finally {
+        flock($fh, LOCK_UN);
+        fclose($fh);
+    }
+}
+
+/**
+ * @return array<string,mixed>
+ */
+function mock_empty_state(): array
+{
+    return [
+        'version' => 0,
+        'google' => ['calendars' => []],
+        'outlook' => ['calendars' => [], 'masterCategories' => []],
+    ];
+}
+
+/**
+ * @return array{0:int,1:array<string,mixed>|null}
+ */
+function mock_control(string $stateDir, string $method, string $path): array
+{
+    if ($path === '/_mock/stats' && $method === 'GET') {
+        $raw = @file_get_contents($stateDir . '/stats.json');
+        $stats = is_string($raw) ? json_decode($raw, true) : null;
+        return [200, is_array($stats) ? $stats : []];
+    }
+
+    if ($path === '/_mock/reset' && $method === 'POST') {
+        $seed = $stateDir . '/seed.json';
+        if (is_file($seed)) {
+            copy($seed, $stateDir . '/state.json');
+        } else {
+            @unlink($stateDir . '/state.json');
+        }
+        @unlink($stateDir . '/stats.json');
+        return [200, ['ok' => true]];
+    }
+
+    return [404, ['error' => ['code' => 404, 'message' => "Unknown control route {$path}"]]];
+}
+
+// ---------------------------------------------------------------------
+// Shared event store helpers
+// ---------------------------------------------------------------------
+
+/**
+ * Strip store-internal bookkeeping before returning a resource.
+ *
+ * @param array<string,mixed> $event
+ * @return array<string,mixed>
+ */
+function mock_public_event(array $event): array
+{
+    unset($event['_v'], $event['_deleted']);
+    return $event;
+}
+
+function mock_new_id(string $prefix = ''): string
+{
+    return $prefix . bin2hex(random_bytes(13));
+}
+
+function mock_now_iso(): string
+{
+    return gmdate('Y-m-d\TH:i:s.000\Z');
+}
+
+/**
+ * Offset-based page token carrying the store version observed on the first page;
+ * that version becomes the sync/delta watermark so writes landing mid-round are
+ * reported again by the next incremental round.
+ */
+function mock_encode_page_token(int $offset, int $version): string
+{
+    return rtrim(strtr(base64_encode($offset . ':' . $version), '+/', '-_'), '=');
+}
+
+/**
+ * @return array{0:int,1:int}|null
+ */
+function mock_decode_page_token(string $token): ?array
+{
+    $raw = base64_decode(strtr($token, '-_', '+/'), true);
+    if (!is_string($raw) || !preg_match('/^(\d+):(\d+)$/', $raw, $m)) {
+        return null;
+    }
+    return [(int)$m[1], (int)$m[2]];
+}
+
+/**
+ * Events ordered by id so offset-based pages stay stable while writes land.
+ *
+ * @param array<string,array<string,mixed>> $events
+ * @return array<int,array<string,mixed>>
+ */
+function mock_sorted_events(array $events): array
+{
+    $list = array_values($events);
+    usort($list, static fn (array $a, array $b): int => strcmp((string)($a['id'] ?? ''), (string)($b['id'] ?? '')));
+    return $list;
+}
+
+// ---------------------------------------------------------------------
+// Google Calendar v3
+// ---------------------------------------------------------------------
+
+/**
+ * @param array<string,mixed> $state
+ * @param array<string,mixed> $query
+ * @param array<string,mixed>|null $payload
+ * @return array{0:int,1:array<string,mixed>|null,2?:array<string,string>}
+ */
+function mock_google_route(array &$state, string $method, string $path, array $query, ?array $payload): array
+{
+    if ($path === '/users/me/calendarList' && $method === 'GET') {
+        $items = [];
+        foreach ($state['google']['calendars'] as $calendar) {
+            $entry = $calendar;
+            unset($entry['events']);
+            $entry['kind'] = 'calendar#calendarListEntry';
+            $entry['accessRole'] = 'owner';
+            $items[] = $entry;
+        }
+        return [200, ['kind' => 'calendar#calendarList', 'items' => $items]];
+    }
+
+    if (!preg_match('#^/calendars/([^/]+)(/events(?:/([^/]+))?)?$#', $path, $m)) {
+        return mock_google_error(404, 'notFound', "Not Found: {$path}");
+    }
+
+    $calendarId = $m[1];
+    if (!is_array($state['google']['calendars'][$calendarId] ?? null)) {
+        return mock_google_error(404, 'notFound', "Calendar not found: {$calendarId}");
+    }
+    $calendar = &$state['google']['calendars'][$calendarId];
+
+    if (($m[2] ?? '') === '') {
+        if ($method === 'GET') {
+            $resource = $calendar;
+            unset($resource['events']);
+            return [200, $resource + ['kind' => 'calendar#calendar']];
+        }
+        if ($method === 'PATCH' && is_array($payload)) {
+            foreach (['summary', 'description', 'timeZone', 'location'] as $key) {
+                if (array_key_exists($key, $payload)) {
+                    $calendar[$key] = $payload[$key];
+                }
+            }
+            $state['version']++;
+            $resource = $calendar;
+            unset($resource['events']);
+            return [200, $resource + ['kind' => 'calendar#calendar']];
+        }
+        return mock_google_error(405, 'methodNotAllowed', "Unsupported {$method} on calendar");
+    }
+
+    $eventId = $m[3] ?? '';
+    if ($eventId === '') {
+        if ($method === 'GET') {
+            return mock_google_list_events($state, $calendar, $query);
+        }
+        if ($method === 'POST' && is_array($payload)) {
+            $state['version']++;
+            $id = is_string($payload['id'] ?? null) && $payload['id'] !== '' ? $payload['id'] : mock_new_id();
+            if (isset($calendar['events'][$id]) && empty($calendar['events'][$id]['_deleted'])) {
+                return mock_google_error(409, 'duplicate', 'The requested identifier already exists.');
+            }
+            $now = mock_now_iso();
+            $event = array_merge($payload, [
+                'kind' => 'calendar#event',
+                'id' => $id,
+                'status' => is_string($payload['status'] ?? null) ? $payload['status'] : 'confirmed',
+                'created' => $now,
+                'updated' => $now,
+                'sequence' => 0,
+            ]);
+            $event['etag'] = '"' . $state['version'] . '"';
+            $event['_v'] = $state['version'];
+            $calendar['events'][$id] = $event;
+            return [200, mock_public_event($event)];
+        }
+        return mock_google_error(405, 'methodNotAllowed', "Unsupported {$method} on events");
+    }
+
+    $event = $calendar['events'][$eventId] ?? null;
+    if (!is_array($event)) {
+        return mock_google_error(404, 'notFound', 'Not Found');
+    }
+    if (!empty($event['_deleted'])) {
+        return mock_google_error(410, 'deleted', 'Resource has been deleted');
+    }
+
+    switch ($method) {
+        case 'GET':
+            return [200, mock_public_event($event)];
+
+        case 'PATCH':
+        case 'PUT':
+            if (!is_array($payload)) {
+                return mock_google_error(400, 'parseError', 'Request body is not valid JSON');
+            }
+            $state['version']++;
+            $keep = array_intersect_key($event, array_flip(['kind', 'id', 'created', 'sequence', '_v']));
+            $event = $method === 'PUT'
+                ? array_merge($payload, $keep)
+                : mock_google_merge_patch($event, $payload);
+            $event['sequence'] = (int)($keep['sequence'] ?? 0) + 1;
+            $event['updated'] = mock_now_iso();
+            $event['etag'] = '"' . $state['version'] . '"';
+            $event['_v'] = $state['version'];
+            $calendar['events'][$eventId] = $event;
+            return [200, mock_public_event($event)];
+
+        case 'DELETE':
+            $state['version']++;
+            $calendar['events'][$eventId] = [
+                'kind' => 'calendar#event',
+                'id' => $eventId,
+                'status' => 'cancelled',
+                'etag' => '"' . $state['version'] . '"',
+                'updated' => mock_now_iso(),
+                '_v' => $state['version'],
+                '_deleted' => true,
+            ];
+            return [204, null];
+    }
+
+    return mock_google_error(405, 'methodNotAllowed', "Unsupported {$method} on event");
+}
+
+/**
+ * Google PATCH semantics: nested objects merge, scalars and arrays replace,
+ * and a null inside a nested object (e.g. an extendedProperties.private key)
+ * removes it.
+ *
+ * @param array<string,mixed> $base
+ * @param array<string,mixed> $patch
+ * @return array<string,mixed>
+ */
+function mock_google_merge_patch(array $base, array $patch, bool $nested = false): array
+{
+    foreach ($patch as $key => $value) {
+        if ($nested && $value === null) {
+            unset($base[$key]);
+            continue;
+        }
+        if (is_array($value) && !array_is_list($value) && is_array($base[$key] ?? null) && !array_is_list($base[$key])) {
+            $base[$key] = mock_google_merge_patch($base[$key], $value, true);
+            continue;
+        }
+        $base[$key] = $value;
+    }
+    return $base;
+}
+
+/**
+ * @param array<string,mixed> $state
+ * @param array<string,mixed> $calendar
+ * @param array<string,mixed> $query
+ * @return array{0:int,1:array<string,mixed>}
+ */
+function mock_google_list_events(array $state, array $calendar, array $query): array
+{
+    $maxResults = min(2500, max(1, (int)($query['maxResults'] ?? 250)));
+    $pageCap = mock_env_int('CS_MOCK_PAGE_SIZE', 0);
+    if ($pageCap > 0) {
+        $maxResults = min($maxResults, $pageCap);
+    }
+
+    $syncToken = is_string($query['syncToken'] ?? null) ? $query['syncToken'] : '';
+    $sinceVersion = 0;
+    if ($syncToken !== '') {
+        if (isset($query['timeMin']) || isset($query['timeMax'])) {
+            return mock_google_error(400, 'invalid', 'syncToken cannot be combined with timeMin/timeMax');
+        }
+        $decoded = mock_decode_page_token($syncToken);
+        if ($decoded === null || $decoded[1] > (int)$state['version']) {
+            return mock_google_error(410, 'fullSyncRequired', 'Sync token is no longer valid, a full sync is required.');
+        }
+        $sinceVersion = $decoded[1];
+    }
+
+    $offset = 0;
+    $snapshotVersion = (int)$state['version'];
+    if (is_string($query['pageToken'] ?? null) && $query['pageToken'] !== '') {
+        $decoded = mock_decode_page_token($query['pageToken']);
+        if ($decoded === null) {
+            return mock_google_error(400, 'invalid', 'Invalid pageToken');
+        }
+        [$offset, $snapshotVersion] = $decoded;
+    }
+
+    $showDeleted = $syncToken !== '' || in_array($query['showDeleted'] ?? null, ['true', '1'], true);
+    $timeMin = is_string($query['timeMin'] ?? null) ? strtotime($query['timeMin']) : false;
+    $timeMax = is_string($query['timeMax'] ?? null) ? strtotime($query['timeMax']) : false;
+
+    $matching = [];
+    foreach (mock_sorted_events(is_array($calendar['events'] ?? null) ? $calendar['events'] : []) as $event) {
+        if ((int)($event['_v'] ?? 0) <= $sinceVersion) {
+            continue;
+        }
+        if (!empty($event['_deleted']) && !$showDeleted) {
+            continue;
+        }
+        if (empty($event['_deleted']) && !mock_google_in_window($event, $timeMin, $timeMax)) {
+            continue;
+        }
+        $matching[] = mock_public_event($event);
+    }
+
+    $page = array_slice($matching, $offset, $maxResults);
+    $out = [
+        'kind' => 'calendar#events',
+        'summary' => $calendar['summary'] ?? '',
+        'timeZone' => $calendar['timeZone'] ?? 'UTC',
+        'updated' => mock_now_iso(),
+        'items' => $page,
+    ];
+
+    if ($offset + $maxResults < count($matching)) {
+        $out['nextPageToken'] = mock_encode_page_token($offset + $maxResults, $snapshotVersion);
+    } else {
+        $out['nextSyncToken'] = mock_encode_page_token(0, $snapshotVersion);
+    }
+
+    return [200, $out];
+}
+
+/**
+ * Recurring masters always overlap; single events are filtered by their start.
+ *
+ * @param array<string,mixed> $event
+ */
+function mock_google_in_window(array $event, int|false $timeMin, int|false $timeMax): bool
+{
+    if (is_array($event['recurrence'] ?? null) && $event['recurrence'] !== []) {
+        return true;
+    }
+
+    $start = $event['start']['dateTime'] ?? $event['start']['date'] ?? null;
+    $end = $event['end']['dateTime'] ?? $event['end']['date'] ?? $start;
+    $startTs = is_string($start) ? strtotime($start) : false;
+    $endTs = is_string($end) ? strtotime($end) : false;
+    if ($startTs === false) {
+        return true;
+    }
+
+    if ($timeMin !== false && ($endTs !== false ? $endTs : $startTs) < $timeMin) {
+        return false;
+    }
+    return $timeMax === false || $startTs < $timeMax;
+}
+
+/**
+ * @return array{0:int,1:array<string,mixed>}
+ */
+function mock_google_error(int $status, string $reason, string $message): array
+{
+    return [$status, ['error' => [
+        'code' => $status,
+        'message' => $message,
+        'errors' => [['domain' => 'global', 'reason' => $reason, 'message' => $message]],
+    ]]];
+}
+
+/**
+ * Google multipart/mixed batch: each part is an application/http request.
+ *
+ * @return array{0:int,1:string,2:array<string,string>}
+ */
+function mock_google_batch(string $stateDir, string $contentType, string $body): array
+{
+    if (!preg_match('/boundary="?([^";]+)"?/i', $contentType, $m)) {
+        return [400, (string)json_encode(mock_google_error(400, 'invalid', 'Missing multipart boundary')[1]), [
+            'Content-Type' => 'application/json',
+        ]];
+    }
+
+    $parts = [];
+    foreach (explode('--' . $m[1], $body) as $chunk) {
+        if (!preg_match('/Content-ID:\s*<([^>]+)>/i', $chunk, $idMatch)) {
+            continue;
+        }
+        $sections = preg_split("/\r?\n\r?\n/", ltrim($chunk), 3);
+        if (!is_array($sections) || count($sections) < 2) {
+            continue;
+        }
+        $requestLines = preg_split("/\r?\n/", trim($sections[1]));
+        if (!is_array($requestLines) || !preg_match('#^([A-Z]+)\s+(\S+)#', $requestLines[0], $lineMatch)) {
+            continue;
+        }
+        $parts[] = [
+            'contentId' => $idMatch[1],
+            'method' => $lineMatch[1],
+            'target' => $lineMatch[2],
+            'body' => isset($sections[2]) ? trim($sections[2]) : '',
+        ];
+    }
+
+    if (count($parts) > CS_MOCK_GOOGLE_BATCH_MAX) {
+        return [400, (string)json_encode(mock_google_error(400, 'invalid', 'Too many requests in batch')[1]), [
+            'Content-Type' => 'application/json',
+        ]];
+    }
+
+    // One state transaction per batch keeps large stores from being re-read per part.
+    $results = mock_with_state($stateDir, static function (array &$state) use ($stateDir, $parts): array {
+        $results = [];
+        foreach ($parts as $part) {
+            $partPath = rawurldecode((string)parse_url($part['target'], PHP_URL_PATH));
+            $partQuery = [];
+            parse_str((string)parse_url($part['target'], PHP_URL_QUERY), $partQuery);
+
+            $fault = mock_next_fault($stateDir, 'google');
+            if ($fault !== null) {
+                $results[] = mock_fault_response($fault, false);
+            } elseif (!str_starts_with($partPath, CS_MOCK_GOOGLE_PREFIX . '/')) {
+                $results[] = mock_google_error(404, 'notFound', "Not Found: {$partPath}");
+            } else {
+                $results[] = mock_google_route(
+                    $state,
+                    $part['method'],
+                    substr($partPath, strlen(CS_MOCK_GOOGLE_PREFIX)),
+                    $partQuery,
+                    mock_decode_body($part['body'])
+                );
+            }
+        }
+        return $results;
+    });
+
+    $boundary = 'batch_mock_' . bin2hex(random_bytes(6));
+    $out = '';
+    foreach ($parts as $i => $part) {
+        $status = $results[$i][0];
+        $payload = $results[$i][1];
+        $headers = $results[$i][2] ?? [];
+
+        $out .= "--{$boundary}\r\n"
+            . "Content-Type: application/http\r\n"
+            . "Content-ID: <response-{$part['contentId']}>\r\n\r\n"
+            . "HTTP/1.1 {$status} " . mock_reason_phrase($status) . "\r\n";
+        foreach ($headers as $name => $value) {
+            $out .= "{$name}: {$value}\r\n";
+        }
+        if ($payload !== null) {
+            $json = (string)json_encode($payload, JSON_UNESCAPED_SLASHES);
+            $out .= "Content-Type: application/json; charset=UTF-8\r\n"
+                . 'Content-Length: ' . strlen($json) . "\r\n\r\n"
+                . $json . "\r\n";
+        } else {
+            $out .= "\r\n";
+        }
+    }
+    $out .= "--{$boundary}--\r\n";
+
+    return [200, $out, ['Content-Type' => 'multipart/mixed; boundary=' . $boundary]];
+}
+
+function mock_reason_phrase(int $status): string
+{
+    return match ($status) {
+        200 => 'OK',
+        201 => 'Created',
+        204 => 'No Content',
+        400 => 'Bad Request',
+        404 => 'Not Found',
+        409 => 'Conflict',
+        410 => 'Gone',
+        429 => 'Too Many Requests',
+        503 => 'Service Unavailable',
+        default => 'Status',
+    };
+}
+
+// ---------------------------------------------------------------------
+// Microsoft Graph v1.0
+// ---------------------------------------------------------------------
+
+/**
+ * @param array<string,mixed> $state
+ * @param array<string,mixed> $query
+ * @param array<string,mixed>|null $payload
+ * @return array{0:int,1:array<string,mixed>|null,2?:array<string,string>}
+ */
+function mock_graph_route(array &$state, string $method, string $path, array $query, ?array $payload): array
+{
+    if ($path === '/me' && $method === 'GET') {
+        return [200, [
+            'id' => 'mock-user',
+            'displayName' => 'Calendar Scheduler Mock',
+            'userPrincipalName' => 'mock@example.invalid',
+        ]];
+    }
+
+    if ($path === '/me/outlook/masterCategories') {
+        if ($method === 'GET') {
+            return [200, ['value' => array_values($state['outlook']['masterCategories'] ?? [])]];
+        }
+        if ($method === 'POST' && is_array($payload)) {
+            $state['version']++;
+            $category = [
+                'id' => mock_new_id(),
+                'displayName' => (string)($payload['displayName'] ?? ''),
+                'color' => (string)($payload['color'] ?? 'none'),
+            ];
+            $state['outlook']['masterCategories'][] = $category;
+            return [201, $category];
+        }
+    }
+
+    if ($path === '/me/calendars' && $method === 'GET') {
+        $items = [];
+        foreach ($state['outlook']['calendars'] as $calendar) {
+            unset($calendar['events']);
+            $items[] = $calendar;
+        }
+        return [200, ['value' => $items]];
+    }
+
+    if (preg_match('#^/me/events/([^/]+)$#', $path, $m)) {
+        foreach (array_keys($state['outlook']['calendars']) as $calendarId) {
+            if (isset($state['outlook']['calendars'][$calendarId]['events'][$m[1]])) {
+                return mock_graph_event($state, (string)$calendarId, $m[1], $method, $query, $payload);
+            }
+        }
+        return mock_graph_error(404, 'ErrorItemNotFound', 'The specified object was not found in the store.');
+    }
+
+    if (!preg_match('#^/me/(?:calendar|calendars/([^/]+))((?:/events|/calendarView)(?:/(delta|[^/]+))?)?$#', $path, $m)) {
+        return mock_graph_error(404, 'ResourceNotFound', "Resource not found for the segment '{$path}'.");
+    }
+
+    $calendarId = ($m[1] ?? '') !== '' ? $m[1] : 'primary';
+    if (!is_array($state['outlook']['calendars'][$calendarId] ?? null)) {
+        return mock_graph_error(404, 'ErrorItemNotFound', "Calendar not found: {$calendarId}");
+    }
+    $calendar = &$state['outlook']['calendars'][$calendarId];
+
+    if (($m[2] ?? '') === '') {
+        if ($method === 'PATCH' && is_array($payload)) {
+            $state['version']++;
+            foreach (['name', 'color', 'hexColor'] as $key) {
+                if (array_key_exists($key, $payload)) {
+                    $calendar[$key] = $payload[$key];
+                }
+            }
+        }
+        $resource = $calendar;
+        unset($resource['events']);
+        return [200, $resource];
+    }
+
+    $tail = $m[3] ?? '';
+    if ($tail === 'delta' && $method === 'GET') {
+        return mock_graph_delta($state, $calendar, $path, $query);
+    }
+    if ($tail === '') {
+        if ($method === 'GET') {
+            return mock_graph_list_events($state, $calendar, $path, $query);
+        }
+        if ($method === 'POST' && is_array($payload)) {
+            $state['version']++;
+            $id = mock_new_id('AAMkAD');
+            $now = gmdate('Y-m-d\TH:i:s.0000000\Z');
+            $event = array_merge($payload, [
+                'id' => $id,
+                'createdDateTime' => $now,
+                'lastModifiedDateTime' => $now,
+                'changeKey' => base64_encode('v' . $state['version']),
+                'type' => is_array($payload['recurrence'] ?? null) ? 'seriesMaster' : 'singleInstance',
+                'isCancelled' => false,
+                '_v' => $state['version'],
+            ]);
+            $calendar['events'][$id] = $event;
+            return [201, mock_graph_public_event($event, $query)];
+        }
+        return mock_graph_error(405, 'ErrorInvalidRequest', "Unsupported {$method} on events");
+    }
+
+    return mock_graph_event($state, $calendarId, $tail, $method, $query, $payload);
+}
+
+/**
+ * @param array<string,mixed> $state
+ * @param array<string,mixed> $query
+ * @param array<string,mixed>|null $payload
+ * @return array{0:int,1:array<string,mixed>|null}
+ */
+function mock_graph_event(array &$state, string $calendarId, string $eventId, string $method, array $query, ?array $payload): array
+{
+    $event = $state['outlook']['calendars'][$calendarId]['events'][$eventId] ?? null;
+    if (!is_array($event) || !empty($event['_deleted'])) {
+        return mock_graph_error(404, 'ErrorItemNotFound', 'The specified object was not found in the store.');
+    }
+
+    if ($method === 'GET') {
+        return [200, mock_graph_public_event($event, $query)];
+    }
+
+    if ($method === 'PATCH') {
+        if (!is_array($payload)) {
+            return mock_graph_error(400, 'BadRequest', 'Empty Payload. JSON content expected.');
+        }
+        $state['version']++;
+        foreach ($payload as $key => $value) {
+            if ($key === 'singleValueExtendedProperties' && is_array($value)) {
+                // Extended properties upsert by id instead of replacing the collection.
+                $byId = [];
+                foreach (is_array($event[$key] ?? null) ? $event[$key] : [] as $prop) {
+                    $byId[(string)($prop['id'] ?? '')] = $prop;
+                }
+                foreach ($value as $prop) {
+                    if (is_array($prop)) {
+                        $byId[(string)($prop['id'] ?? '')] = $prop;
+                    }
+                }
+                $event[$key] = array_values($byId);
+                continue;
+            }
+            $event[$key] = $value;
+        }
+        if (array_key_exists('recurrence', $payload)) {
+            $event['type'] = is_array($payload['recurrence']) ? 'seriesMaster' : 'singleInstance';
+        }
+        $event['lastModifiedDateTime'] = gmdate('Y-m-d\TH:i:s.0000000\Z');
+        $event['changeKey'] = base64_encode('v' . $state['version']);
+        $event['_v'] = $state['version'];
+        $state['outlook']['calendars'][$calendarId]['events'][$eventId] = $event;
+        return [200, mock_graph_public_event($event, $query)];
+    }
+
+    if ($method === 'DELETE') {
+        $state['version']++;
+        $state['outlook']['calendars'][$calendarId]['events'][$eventId] = [
+            'id' => $eventId,
+            '_v' => $state['version'],
+            '_deleted' => true,
+        ];
+        return [204, null];
+    }
+
+    return mock_graph_error(405, 'ErrorInvalidRequest', "Unsupported {$method} on event");
+}
+
+/**
+ * Graph only returns singleValueExtendedProperties when they are $expand-ed.
+ *
+ * @param array<string,mixed> $event
+ * @param array<string,mixed> $query
+ * @return array<string,mixed>
+ */
+function mock_graph_public_event(array $event, array $query): array
+{
+    $expand = is_string($query['$expand'] ?? null) ? $query['$expand'] : '';
+    if (!str_contains($expand, 'singleValueExtendedProperties')) {
+        unset($event['singleValueExtendedProperties']);
+    }
+    return mock_public_event($event);
+}
+
+function mock_graph_link(string $path, array $query): string
+{
+    $host = (string)($_SERVER['HTTP_HOST'] ?? '127.0.0.1');
+    return 'http://' . $host . CS_MOCK_GRAPH_PREFIX . $path
+        . '?' . http_build_query($query, '', '&', PHP_QUERY_RFC3986);
+}
+
+/**
+ * @param array<string,mixed> $state
+ * @param array<string,mixed> $calendar
+ * @param array<string,mixed> $query
+ * @return array{0:int,1:array<string,mixed>}
+ */
+function mock_graph_list_events(array $state, array $calendar, string $path, array $query): array
+{
+    $top = min(1000, max(1, (int)($query['$top'] ?? 10)));
+    $pageCap = mock_env_int('CS_MOCK_PAGE_SIZE', 0);
+    if ($pageCap > 0) {
+        $top = min($top, $pageCap);
+    }
+
+    $offset = 0;
+    $snapshotVersion = (int)$state['version'];
+    if (is_string($query['$skiptoken'] ?? null) && $query['$skiptoken'] !== '') {
+        $decoded = mock_decode_page_token($query['$skiptoken']);
+        if ($decoded === null) {
+            return mock_graph_error(400, 'BadRequest', 'Invalid $skiptoken');
+        }
+        [$offset, $snapshotVersion] = $decoded;
+    }
+
+    $live = [];
+    foreach (mock_sorted_events(is_array($calendar['events'] ?? null) ? $calendar['events'] : []) as $event) {
+        if (empty($event['_deleted'])) {
+            $live[] = mock_graph_public_event($event, $query);
+        }
+    }
+
+    $out = ['value' => array_slice($live, $offset, $top)];
+    if ($offset + $top < count($live)) {
+        $next = $query;
+        $next['$skiptoken'] = mock_encode_page_token($offset + $top, $snapshotVersion);
+        $out['@odata.nextLink'] = mock_graph_link($path, $next);
+    }
+
+    return [200, $out];
+}
+
+/**
+ * Delta round: pages via $skiptoken, ends with a $deltatoken bound to the store version.
+ * Deleted events are reported as @removed entries.
+ *
+ * @param array<string,mixed> $state
+ * @param array<string,mixed> $calendar
+ * @param array<string,mixed> $query
+ * @return array{0:int,1:array<string,mixed>}
+ */
+function mock_graph_delta(array $state, array $calendar, string $path, array $query): array
+{
+    $top = mock_env_int('CS_MOCK_PAGE_SIZE', 0) ?: 100;
+
+    $sinceVersion = 0;
+    if (is_string($query['$deltatoken'] ?? null) && $query['$deltatoken'] !== '') {
+        $decoded = mock_decode_page_token($query['$deltatoken']);
+        if ($decoded === null || $decoded[1] > (int)$state['version']) {
+            return mock_graph_error(410, 'SyncStateNotFound', 'The sync state generation is not found.');
+        }
+        $sinceVersion = $decoded[1];
+    }
+
+    $offset = 0;
+    $snapshotVersion = (int)$state['version'];
+    if (is_string($query['$skiptoken'] ?? null) && $query['$skiptoken'] !== '') {
+        $decoded = mock_decode_page_token($query['$skiptoken']);
+        if ($decoded === null) {
+            return mock_graph_error(400, 'BadRequest', 'Invalid $skiptoken');
+        }
+        [$offset, $snapshotVersion] = $decoded;
+    }
+
+    $changes = [];
+    foreach (mock_sorted_events(is_array($calendar['events'] ?? null) ? $calendar['events'] : []) as $event) {
+        if ((int)($event['_v'] ?? 0) <= $sinceVersion) {
+            continue;
+        }
+        if (!empty($event['_deleted'])) {
+            if ($sinceVersion > 0) {
+                $changes[] = ['id' => $event['id'], '@removed' => ['reason' => 'deleted']];
+            }
+            continue;
+        }
+        $changes[] = mock_graph_public_event($event, $query);
+    }
+
+    $out = ['value' => array_slice($changes, $offset, $top)];
+    $linkQuery = array_diff_key($query, ['$skiptoken' => true, '$deltatoken' => true]);
+    if ($offset + $top < count($changes)) {
+        $out['@odata.nextLink'] = mock_graph_link($path, $linkQuery + [
+            '$deltatoken' => mock_encode_page_token(0, $sinceVersion),
+            '$skiptoken' => mock_encode_page_token($offset + $top, $snapshotVersion),
+        ]);
+    } else {
+        $out['@odata.deltaLink'] = mock_graph_link($path, $linkQuery + [
+            '$deltatoken' => mock_encode_page_token(0, $snapshotVersion),
+        ]);
+    }
+
+    return [200, $out];
+}
+
+/**
+ * @return array{0:int,1:array<string,mixed>}
+ */
+function mock_graph_error(int $status, string $code, string $message): array
+{
+    return [$status, ['error' => ['code' => $code, 'message' => $message]]];
+}
+
+/**
+ * Graph JSON $batch: sub-requests are routed independently (no dependsOn ordering).
+ *
+ * @param array<string,mixed>|null $payload
+ * @return array{0:int,1:array<string,mixed>}
+ */
+function mock_graph_batch(string $stateDir, ?array $payload): array
+{
+    $requests = is_array($payload['requests'] ?? null) ? $payload['requests'] : null;
+    if ($requests === null) {
+        return mock_graph_error(400, 'BadRequest', 'Invalid batch payload.');
+    }
+    if (count($requests) > CS_MOCK_GRAPH_BATCH_MAX) {
+        return mock_graph_error(400, 'BadRequest', 'Number of batch request steps exceeds the maximum value of 20.');
+    }
+
+    $responses = mock_with_state($stateDir, static function (array &$state) use ($stateDir, $requests): array {
+        $responses = [];
+        foreach ($requests as $request) {
+            if (!is_array($request)) {
+                continue;
+            }
+            $url = (string)($request['url'] ?? '');
+            $subPath = rawurldecode((string)parse_url($url, PHP_URL_PATH));
+            $subQuery = [];
+            parse_str((string)parse_url($url, PHP_URL_QUERY), $subQuery);
+
+            $fault = mock_next_fault($stateDir, 'graph');
+            $result = $fault !== null
+                ? mock_fault_response($fault, true)
+                : mock_graph_route(
+                    $state,
+                    strtoupper((string)($request['method'] ?? 'GET')),
+                    $subPath,
+                    $subQuery,
+                    is_array($request['body'] ?? null) ? $request['body'] : null
+                );
+
+            $response = [
+                'id' => (string)($request['id'] ?? ''),
+                'status' => $result[0],
+                'headers' => ($result[2] ?? []) + ['Content-Type' => 'application/json'],
+            ];
+            if ($result[1] !== null) {
+                $response['body'] = $result[1];
+            }
+            $responses[] = $response;
+        }
+        return $responses;
+    });
+
+    return [200, ['responses' => $responses]];
+}
@@ -5,113 +5,43 @@ declare(strict_types=1);
  * Calendar Scheduler — Runtime Bootstrap
  *
  * File: bootstrap.php
- * Purpose: Load all Calendar Scheduler PHP dependencies in a deterministic
- * order for FPP's non-autoload plugin runtime.
+ * Purpose: Register the Calendar Scheduler class autoloader for FPP's
+ * non-Composer plugin runtime. Classes load on first use, so cheap entry
+ * points (ui-api status/prefs, save hook) never compile the engine or the
+ * provider mappers they do not touch.
  */
 
 // -----------------------------------------------------------------------------
-// Platform
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Platform/IniMetadata.php';
-require_once __DIR__ . '/src/Platform/FppSemantics.php';
-require_once __DIR__ . '/src/Platform/HolidayResolver.php';
-require_once __DIR__ . '/src/Platform/SunTimeDisplayEstimator.php';
-require_once __DIR__ . '/src/Platform/FppEventTimestampStore.php';
-
-// -----------------------------------------------------------------------------
-// Adapter
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Adapter/FppScheduleTranslator.php';
-require_once __DIR__ . '/src/Adapter/FppScheduleAdapter.php';
-
-// Calendar — provider-agnostic boundary
-require_once __DIR__ . '/src/Adapter/Calendar/OverrideIntent.php';
-require_once __DIR__ . '/src/Adapter/Calendar/SnapshotEvent.php';
-require_once __DIR__ . '/src/Adapter/Calendar/CalendarSnapshot.php';
-require_once __DIR__ . '/src/Adapter/Calendar/CalendarContracts.php';
-require_once __DIR__ . '/src/Adapter/Calendar/ExecutorApplyRuntime.php';
-require_once __DIR__ . '/src/Adapter/Calendar/MapperShared.php';
-require_once __DIR__ . '/src/Adapter/Calendar/TranslatorShared.php';
-require_once __DIR__ . '/src/Adapter/Calendar/ProviderRuntimeFactory.php';
-
-// Calendar — Google provider
-require_once __DIR__ . '/src/Adapter/Calendar/Google/GoogleConfig.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Google/GoogleApiClient.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Google/GoogleCalendarTranslator.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Google/GoogleEventMetadataSchema.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Google/GoogleEventMapper.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Google/GoogleApply.php';
-
-// Calendar — Outlook provider
-require_once __DIR__ . '/src/Adapter/Calendar/Outlook/OutlookConfig.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Outlook/OutlookApiClient.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Outlook/OutlookCalendarTranslator.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Outlook/OutlookEventMetadataSchema.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Outlook/OutlookEventMapper.php';
-require_once __DIR__ . '/src/Adapter/Calendar/Outlook/OutlookApply.php';
-
-// -----------------------------------------------------------------------------
-// Intent
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Intent/Intent.php';
-require_once __DIR__ . '/src/Intent/IntentNormalizer.php';
-require_once __DIR__ . '/src/Intent/NormalizationContext.php';
-
-// -----------------------------------------------------------------------------
-// Resolution
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Resolution/Dto/ResolutionRole.php';
-require_once __DIR__ . '/src/Resolution/Dto/ResolutionScope.php';
-require_once __DIR__ . '/src/Resolution/Dto/ResolvedSubevent.php';
-require_once __DIR__ . '/src/Resolution/Dto/ResolvedBundle.php';
-require_once __DIR__ . '/src/Resolution/Dto/ResolvedSchedule.php';
-require_once __DIR__ . '/src/Resolution/ResolutionEngineInterface.php';
-require_once __DIR__ . '/src/Resolution/ResolutionEngine.php';
-
-// -----------------------------------------------------------------------------
-// Planner
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Planner/Dto/PlannerIntent.php';
-require_once __DIR__ . '/src/Planner/ResolvedSchedulePlanner.php';
-require_once __DIR__ . '/src/Planner/ResolvedScheduleToIntentAdapter.php';
-require_once __DIR__ . '/src/Planner/OrderingKey.php';
-require_once __DIR__ . '/src/Planner/PlannedEntry.php';
-require_once __DIR__ . '/src/Planner/PlannerResult.php';
-require_once __DIR__ . '/src/Planner/Planner.php';
-require_once __DIR__ . '/src/Planner/ManifestPlanner.php';
-
-// -----------------------------------------------------------------------------
-// Diff & Reconciliation
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Diff/DiffResult.php';
-require_once __DIR__ . '/src/Diff/Diff.php';
-require_once __DIR__ . '/src/Diff/ReconciliationAction.php';
-require_once __DIR__ . '/src/Diff/ReconciliationResult.php';
-require_once __DIR__ . '/src/Diff/Reconciler.php';
-
-// -----------------------------------------------------------------------------
-// Engine
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Engine/SchedulerRunResult.php';
-require_once __DIR__ . '/src/Engine/SchedulerEngine.php';
-
-// -----------------------------------------------------------------------------
-// Apply
-// -----------------------------------------------------------------------------
-
-require_once __DIR__ . '/src/Apply/ApplyTargets.php';
-require_once __DIR__ . '/src/Apply/ApplyOptions.php';
-require_once __DIR__ . '/src/Apply/ApplyEvaluation.php';
-require_once __DIR__ . '/src/Apply/FppScheduleWriter.php';
-require_once __DIR__ . '/src/Apply/ManifestWriter.php';
-require_once __DIR__ . '/src/Apply/ApplyRunner.php';
+// Classmap autoloader
+//
+// src/autoload_classmap.php is generated by bin/cs-classmap and covers files
+// that declare several classes (e.g. CalendarContracts.php). Classes added
+// since the last generation fall back to the one-class-per-file layout.
+// -----------------------------------------------------------------------------
+
+(static function (): void {
+    $srcDir = __DIR__ . '/src';
+    $classmap = is_file($srcDir . '/autoload_classmap.php')
+        ? require $srcDir . '/autoload_classmap.php'
+        : [];
+    // PHP class names are case-insensitive; references do not always match declarations.
+    $classmap = array_change_key_case(is_array($classmap) ? $classmap : [], CASE_LOWER);
+
+    spl_autoload_register(static function (string $class) use ($srcDir, $classmap): void {
+        $path = $classmap[strtolower($class)] ?? null;
+        if ($path === null) {
+            if (strncmp($class, 'CalendarScheduler\\', 18) !== 0) {
+                return;
+            }
+            $path = '/' . str_replace('\\', '/', substr($class, 18)) . '.php';
+            if (!is_file($srcDir . $path)) {
+                return;
+            }
+        }
+
+        require_once $srcDir . $path;
+    });
+})();
 
 // -----------------------------------------------------------------------------
 // Bootstrap complete
@@ -407,6 +407,19 @@
 
   <details>
     <summary><strong>Diagnostics</strong></summary>
+    <div class="form-check cs-small-check mt-2">
+      <input class="form-check-input" type="checkbox" id="csTraceRuns">
+      <label class="form-check-label" for="csTraceRuns">
+        Record run traces (open in chrome://tracing or speedscope)
+      </label>
+    </div>
+    <div class="form-check cs-small-check">
+      <input class="form-check-input" type="checkbox" id="csApplyFullVerify">
+      <label class="form-check-label" for="csApplyFullVerify">
+        Verify applies with a full fetch and plan (slower)
+      </label>
+    </div>
+    <ul class="cs-muted mb-2" id="csTraceList"></ul>
     <pre class="form-control cs-json" id="csDiagnosticJson">{
   "mode": "design-shell",
   "notes": [
@@ -758,6 +771,30 @@
       }
       var body = (payload && payload.diagnostics) ? payload.diagnostics : payload;
       out.textContent = JSON.stringify(body || {}, null, 2);
+      renderTraces(body && body.trace ? body.trace : null);
+      var fullVerify = byId("csApplyFullVerify");
+      if (fullVerify && body && typeof body.applyFullVerify === "boolean") {
+        fullVerify.checked = body.applyFullVerify;
+      }
+    }
+
+    function renderTraces(trace) {
+      var toggle = byId("csTraceRuns");
+      var list = byId("csTraceList");
+      if (!toggle || !list || !trace) {
+        return;
+      }
+      toggle.checked = !!trace.enabled;
+      list.innerHTML = "";
+      (Array.isArray(trace.recent) ? trace.recent : []).forEach(function (t) {
+        var item = document.createElement("li");
+        var link = document.createElement("a");
+        link.href = API_URL + "&action=trace_download&name=" + encodeURIComponent(t.name);
+        link.textContent = t.name;
+        item.appendChild(link);
+        item.appendChild(document.createTextNode(" (" + Math.ceil(Number(t.bytes || 0) / 1024) + " KB)"));
+        list.appendChild(item);
+      });
     }
 
     function refreshDiagnostics() {
@@ -787,6 +824,36 @@
       });
     }
 
+    // Poll a running managed color reset and report its progress until the
+    // returned stop function is called.
+    function watchColorResetProgress(label) {
+      var stopped = false;
+      var timer = null;
+      function poll() {
+        fetchJson({ action: "reset_managed_colors_progress" })
+          .then(function (res) {
+            var progress = (res && typeof res.progress === "object" && res.progress) ? res.progress : null;
+            var total = progress ? Number(progress.total || 0) : 0;
+            if (!stopped && progress && progress.phase === "patch" && total > 0) {
+              setSetupStatus(label + " Updated " + Number(progress.done || 0) + " of " + total + " events.");
+            }
+          })
+          .catch(function () {
+            // Progress is informational; the reset request reports the outcome.
+          })
+          .finally(function () {
+            if (!stopped) {
+              timer = window.setTimeout(poll, 1000);
+            }
+          });
+      }
+      timer = window.setTimeout(poll, 1000);
+      return function () {
+        stopped = true;
+        window.clearTimeout(timer);
+      };
+    }
+
     // Render pending actions table and return count of non-noop rows.
     function renderActions(actions) {
       var tbody = byId("csActionsRows");
@@ -952,6 +1019,10 @@
         if (providerConnected) {
           awaitingPostAuthConnection = false;
         }
+        // Re-attach to an apply started before this page was loaded.
+        if (res.applyJob && res.applyJob.id && !applyInFlight) {
+          trackApply(followApplyJob(res.applyJob));
+        }
         if (!connectionCollapsedLoaded) {
           var uiPrefs = (res && typeof res.ui === "object" && res.ui) ? res.ui : {};
           setConnectionCollapsed(!!uiPrefs.connectionCollapsed);
@@ -1060,8 +1131,10 @@
           // One-time reconciliation after load to migrate legacy custom categories.
           if (providerConnected && enforceManagedColors && !managedColorReconcileDone) {
             managedColorReconcileDone = true;
-            fetchJson({ action: "reset_managed_colors" })
+            var stopReconcileProgress = watchColorResetProgress("Reconciling managed colors.");
+            fetchJson({ action: "reset_managed_colors", refresh: false })
               .then(function (resetRes) {
+                stopReconcileProgress();
                 var summary = (resetRes && typeof resetRes.summary === "object" && resetRes.summary) ? resetRes.summary : {};
                 var updated = Number(summary.updated || 0);
                 var managed = Number(summary.managed || 0);
@@ -1071,6 +1144,7 @@
                 return refreshAll();
               })
               .catch(function () {
+                stopReconcileProgress();
                 managedColorReconcileDone = false;
               });
           }
@@ -1146,13 +1220,98 @@
       });
     }
 
-    function runApply() {
-      return fetchJson({ action: "apply", sync_mode: syncMode }).then(function (res) {
-        renderPreview(res.preview || {});
+    // Apply runs as a server-side job; progress arrives over Server-Sent Events.
+    // A stale interrupted apply is only replayed (or discarded) once confirmed.
+    function runApply(confirmResume) {
+      return fetchJson({ action: "apply", sync_mode: syncMode, confirm_resume: confirmResume === true }).then(function (res) {
+        return followApplyJob(res.job || {});
+      }).catch(function (err) {
+        var message = String(err && err.message ? err.message : "");
+        if (confirmResume === true || message.indexOf("Resume refused") !== 0) {
+          throw err;
+        }
+        if (message.indexOf("confirm to resume") !== -1
+          && window.confirm(message + "\n\nResume the interrupted apply anyway?")) {
+          return runApply(true);
+        }
+        if (window.confirm("Discard the interrupted apply and plan again from the current state?")) {
+          return fetchJson({ action: "discard_pending_apply" }).then(function () {
+            return runApply(false);
+          });
+        }
+        throw err;
+      });
+    }
+
+    function applyStageText(event) {
+      switch (event.stage) {
+        case "resume":
+          return "Finishing interrupted apply...";
+        case "fetch":
+          return "Fetching calendar and FPP schedule...";
+        case "plan":
+          return "Planning " + Number(event.actions || 0) + " change(s)...";
+        case "fpp_commit":
+          return event.status === "done" ? "FPP schedule committed." : "Committing FPP schedule...";
+        case "mutation":
+          return "Calendar changes " + Number(event.done || 0) + " of " + Number(event.total || 0) + "...";
+        case "manifest":
+          return "Saving manifest...";
+        case "verify":
+          return event.mode === "touched" ? "Checking changed events..." : "Verifying result...";
+        default:
+          return "Applying...";
+      }
+    }
+
+    function followApplyJob(job) {
+      return new Promise(function (resolve, reject) {
+        if (!job.id) {
+          reject(new Error("Apply job was not started"));
+          return;
+        }
+        // The server ends each stream after a short window; EventSource
+        // reconnects on its own and resumes after the last event id.
+        var source = new EventSource(API_URL + "&action=apply_progress&job=" + encodeURIComponent(job.id));
+        source.onmessage = function (msg) {
+          var event;
+          try {
+            event = JSON.parse(msg.data);
+          } catch (e) {
+            return;
+          }
+          if (event.stage === "done") {
+            source.close();
+            resolve(event.result || {});
+            return;
+          }
+          if (event.stage === "failed") {
+            source.close();
+            reject(new Error(event.error || "Apply failed"));
+            return;
+          }
+          byId("csPreviewTime").textContent = applyStageText(event);
+        };
+      }).then(function (result) {
+        renderPreview(result.preview || {});
         return refreshDiagnostics();
       });
     }
 
+    function trackApply(work) {
+      applyInFlight = true;
+      setApplyEnabled(false);
+      setButtonsDisabled(true);
+      setLoadingState();
+      return work
+        .catch(function (err) { setError(err.message); })
+        .finally(function () {
+          applyInFlight = false;
+          setButtonsDisabled(false);
+          setApplyEnabled(lastPendingCount > 0);
+        });
+    }
+
     // -----------------------------------------------------------------------
     // Device OAuth modal/polling flow
     // -----------------------------------------------------------------------
@@ -1500,11 +1659,13 @@
       var checked = !!this.checked;
       setButtonsDisabled(true);
       setLoadingState();
+      var stopResetProgress = checked ? watchColorResetProgress("Applying managed colors.") : function () {};
       fetchJson({
         action: "set_ui_pref",
         key: "enforce_managed_colors",
         value: checked
       }).then(function (res) {
+        stopResetProgress();
         var summary = (res && typeof res.summary === "object" && res.summary) ? res.summary : null;
         if (!checked) {
           setSetupStatus("Managed colors are now optional; manual colors are preserved.");
@@ -1519,12 +1680,35 @@
         }
         return refreshAll();
       }).catch(function (err) {
+        stopResetProgress();
         setError(err.message);
       }).finally(function () {
         setButtonsDisabled(false);
       });
     });
 
+    byId("csTraceRuns").addEventListener("change", function () {
+      fetchJson({
+        action: "set_ui_pref",
+        key: "trace_runs",
+        value: !!this.checked
+      }).then(function () {
+        return refreshDiagnostics();
+      }).catch(function (err) {
+        setError(err.message);
+      });
+    });
+
+    byId("csApplyFullVerify").addEventListener("change", function () {
+      fetchJson({
+        action: "set_ui_pref",
+        key: "apply_full_verify",
+        value: !!this.checked
+      }).catch(function (err) {
+        setError(err.message);
+      });
+    });
+
     byId("csUploadDeviceClientBtn").addEventListener("click", function () {
       var input = byId("csDeviceClientFile");
       var file = input && input.files ? input.files[0] : null;
@@ -1668,17 +1852,7 @@
         return;
       }
       resetApplyConfirm();
-      applyInFlight = true;
-      setApplyEnabled(false);
-      setButtonsDisabled(true);
-      setLoadingState();
-      runApply()
-        .catch(function (err) { setError(err.message); })
-        .finally(function () {
-          applyInFlight = false;
-          setButtonsDisabled(false);
-          setApplyEnabled(lastPendingCount > 0);
-        });
+      trackApply(runApply());
     });
 
     window.addEventListener("focus", function () {
@@ -12,14 +12,19 @@ declare(strict_types=1);
 require_once __DIR__ . '/bootstrap.php';
 
 use CalendarScheduler\Platform\FppEventTimestampStore;
+use CalendarScheduler\Platform\HashScheme;
 
 $schedulePath = '/home/fpp/media/config/schedule.json';
 $outputPath = '/home/fpp/media/config/calendar-scheduler/fpp/event-timestamps.json';
 $tombstonesPath = '/home/fpp/media/config/calendar-scheduler/runtime/tombstones.json';
+$manifestPath = '/home/fpp/media/config/calendar-scheduler/manifest.json';
 
 header('Content-Type: application/json');
 
 try {
+    // Timestamps are keyed by identity/state hash; use the manifest's scheme.
+    HashScheme::activate(HashScheme::fromManifestFile($manifestPath));
+
     $store = new FppEventTimestampStore();
     $previous = $store->load($outputPath);
     $previousEvents = is_array($previous['events'] ?? null) ? $previous['events'] : [];
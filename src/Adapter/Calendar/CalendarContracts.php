@@ -13,9 +13,48 @@ interface CalendarApplyRuntime
 
     /**
      * @param array<int,\CalendarScheduler\Diff\ReconciliationAction> $actions
+     * @param CalendarMutationJournal|null $journal Skips acknowledged mutations and records new ones
+     * @param callable(int,int):void|null $onProgress Invoked with (done, total) between
+     *        provider mutations so the caller can report progress and drive
+     *        concurrent non-blocking work (e.g. the FPP commit)
      * @return array<int,CalendarMutationLink>
      */
-    public function applyActions(array $actions): array;
+    public function applyActions(
+        array $actions,
+        ?CalendarMutationJournal $journal = null,
+        ?callable $onProgress = null
+    ): array;
+}
+
+/**
+ * Durable per-mutation acknowledgement log used to resume an interrupted apply.
+ *
+ * Mutations are keyed by (op, manifestEventId, subEventHash, providerEventId),
+ * which the mappers derive deterministically from a persisted plan.
+ */
+interface CalendarMutationJournal
+{
+    /**
+     * Provider event id recorded for an already-completed mutation, or null
+     * when the mutation has not been acknowledged and must be sent.
+     */
+    public function acknowledged(
+        string $op,
+        string $manifestEventId,
+        string $subEventHash,
+        ?string $providerEventId
+    ): ?string;
+
+    /**
+     * Record a completed mutation. Must be durable before returning.
+     */
+    public function acknowledge(
+        string $op,
+        string $manifestEventId,
+        string $subEventHash,
+        ?string $providerEventId,
+        string $resultEventId
+    ): void;
 }
 
 /**
@@ -32,18 +71,71 @@ interface ProviderSnapshotRuntime
 
     public function calendarId(): string;
 
+    /**
+     * Fetch window applied to the provider listing.
+     */
+    public function syncHorizon(): SyncHorizon;
+
     /**
      * @return array<int,array<string,mixed>>
      */
     public function translatedEvents(): array;
 }
 
+/**
+ * Provider runtime boundary for bulk field-level patches (style colors /
+ * categories, managed metadata migration).
+ *
+ * Implementations push field-level PATCH payloads in provider batches under
+ * the client's rate-limit policy.
+ */
+interface ProviderStylePatchRuntime
+{
+    public function providerName(): string;
+
+    public function calendarId(): string;
+
+    /**
+     * @param array<string,array<string,mixed>> $payloadsByEventId
+     * @param callable(int,int):void|null $onBatch
+     * @return array<string,string> Failure messages keyed by provider event id
+     */
+    public function patchEvents(array $payloadsByEventId, ?callable $onBatch = null): array;
+}
+
+/**
+ * Provider runtime boundary for re-reading single events by id, e.g. to
+ * verify only the events an apply touched instead of re-listing the calendar.
+ */
+interface ProviderEventLookupRuntime
+{
+    public function providerName(): string;
+
+    /**
+     * Scheduler metadata of each event, or null when the event no longer
+     * exists (deleted or cancelled).
+     *
+     * @param array<int,string> $eventIds
+     * @return array<string,array{manifestEventId:?string,subEventHash:?string}|null> keyed by event id
+     */
+    public function lookupEvents(string $calendarId, array $eventIds): array;
+}
+
+/**
+ * One completed provider mutation (create, update or delete) and the provider
+ * event it produced or addressed.
+ */
 final class CalendarMutationLink
 {
+    public const OP_CREATE = 'create';
+    public const OP_UPDATE = 'update';
+    public const OP_DELETE = 'delete';
+
     public function __construct(
         public readonly string $op,
         public readonly string $manifestEventId,
         public readonly string $subEventHash,
-        public readonly string $providerEventId
+        public readonly string $providerEventId,
+        public readonly string $calendarId = ''
     ) {}
 }
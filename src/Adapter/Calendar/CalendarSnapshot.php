@@ -29,14 +29,25 @@ final class CalendarSnapshot
     /** @var SnapshotEvent[] */
     private array $snapshotEvents = [];
 
-    public function __construct()
+    private readonly bool $retainSourceRows;
+
+    /**
+     * Snapshot events reference their provider rows by provider event id +
+     * row index; full rows are kept as well only when $retainSourceRows is
+     * set (default: debug mode, CS_DEBUG_CALENDAR=1), as on large calendars
+     * they would double the rows held in memory.
+     */
+    public function __construct(?bool $retainSourceRows = null)
     {
         // Snapshot is provider-agnostic; translation occurs upstream.
+        $this->retainSourceRows = $retainSourceRows ?? getenv('CS_DEBUG_CALENDAR') === '1';
     }
 
     /**
      * Snapshot already-translated calendar provider events into grouped SnapshotEvent objects.
      *
+     * Source references use the keys of $providerEvents as row indexes.
+     *
      * @param array $providerEvents Raw calendar provider events (post-translation)
      * @return SnapshotEvent[]
      */
@@ -47,13 +58,13 @@ final class CalendarSnapshot
         $overrideRows = [];
 
         // First pass: create SnapshotEvent instances for rows where parentUid is null or not set
-        foreach ($providerEvents as $row) {
+        foreach ($providerEvents as $index => $row) {
             if (isset($row['parentUid']) && $row['parentUid'] !== null) {
                 // This is either an override or a cancellation, handle later
                 if (isset($row['status']) && $row['status'] === 'cancelled') {
-                    $cancelledRows[] = $row;
+                    $cancelledRows[$index] = $row;
                 } else {
-                    $overrideRows[] = $row;
+                    $overrideRows[$index] = $row;
                 }
                 continue;
             }
@@ -62,10 +73,11 @@ final class CalendarSnapshot
                 continue;
             }
             $eventsByUid[$uid] = new SnapshotEvent($row);
+            $this->attachSource($eventsByUid[$uid], $row, (int)$index);
         }
 
         // Second pass: collect cancelled rows into cancelledDates on the parent SnapshotEvent
-        foreach ($cancelledRows as $row) {
+        foreach ($cancelledRows as $index => $row) {
             $parentUid = $row['parentUid'] ?? null;
             if ($parentUid === null || !isset($eventsByUid[$parentUid])) {
                 throw new RuntimeException("Cancelled event references missing parent UID: " . var_export($parentUid, true));
@@ -75,24 +87,33 @@ final class CalendarSnapshot
                 throw new RuntimeException("Cancelled event missing originalStartTime");
             }
             $eventsByUid[$parentUid]->addCancelledDate($originalStartTime);
-            $eventsByUid[$parentUid]->addSourceRow($row);
+            $this->attachSource($eventsByUid[$parentUid], $row, (int)$index);
         }
 
         // Third pass: collect override rows into OverrideIntent objects attached to the parent SnapshotEvent
-        foreach ($overrideRows as $row) {
+        foreach ($overrideRows as $index => $row) {
             $parentUid = $row['parentUid'] ?? null;
             if ($parentUid === null || !isset($eventsByUid[$parentUid])) {
                 throw new RuntimeException("Override event references missing parent UID: " . var_export($parentUid, true));
             }
             $overrideIntent = new OverrideIntent($row);
+            $overrideIntent->sourceRef = ['uid' => (string)($row['uid'] ?? ''), 'row' => (int)$index];
             $eventsByUid[$parentUid]->addOverride($overrideIntent);
-            $eventsByUid[$parentUid]->addSourceRow($row);
+            $this->attachSource($eventsByUid[$parentUid], $row, (int)$index);
         }
 
         $this->snapshotEvents = array_values($eventsByUid);
         return $this->snapshotEvents;
     }
 
+    private function attachSource(SnapshotEvent $event, array $row, int $index): void
+    {
+        $event->addSourceRef((string)($row['uid'] ?? ''), $index);
+        if ($this->retainSourceRows) {
+            $event->addSourceRow($row);
+        }
+    }
+
     /**
      * Returns the most recently generated snapshot events.
      *
@@ -5,11 +5,11 @@ namespace CalendarScheduler\Adapter\Calendar;
 
 final class ExecutorApplyRuntime implements CalendarApplyRuntime
 {
-    /** @var callable(array<int,\CalendarScheduler\Diff\ReconciliationAction>): array<int,CalendarMutationLink> */
+    /** @var callable(array<int,\CalendarScheduler\Diff\ReconciliationAction>,?CalendarMutationJournal,?callable): array<int,CalendarMutationLink> */
     private $applyFn;
 
     /**
-     * @param callable(array<int,\CalendarScheduler\Diff\ReconciliationAction>): array<int,CalendarMutationLink> $applyFn
+     * @param callable(array<int,\CalendarScheduler\Diff\ReconciliationAction>,?CalendarMutationJournal,?callable): array<int,CalendarMutationLink> $applyFn
      */
     public function __construct(
         private readonly string $providerNameValue,
@@ -35,8 +35,11 @@ final class ExecutorApplyRuntime implements CalendarApplyRuntime
         return $this->correlationEventIdsFieldValue;
     }
 
-    public function applyActions(array $actions): array
-    {
-        return ($this->applyFn)($actions);
+    public function applyActions(
+        array $actions,
+        ?CalendarMutationJournal $journal = null,
+        ?callable $onProgress = null
+    ): array {
+        return ($this->applyFn)($actions, $journal, $onProgress);
     }
 }
@@ -10,11 +10,24 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Adapter\Calendar\Google;
 
+use CalendarScheduler\Platform\Trace;
+
 final class GoogleApiClient
 {
+    private const BATCH_PATH_PREFIX = '/calendar/v3';
+
+    // Google accepts up to 50 calls per batch; stay well inside per-user quota.
+    public const BATCH_MAX_REQUESTS = 50;
+    private const BATCH_MIN_INTERVAL_MS = 250;
+    private const BATCH_MAX_ATTEMPTS = 5;
+    private const BATCH_MAX_BACKOFF_SECONDS = 32;
+    private const REQUEST_MAX_ATTEMPTS = 4;
+    private const REQUEST_MAX_BACKOFF_SECONDS = 8;
+
     private GoogleConfig $config;
     private bool $debugCalendar;
     private int $deleteSkippedAlreadyAbsent = 0;
+    private float $lastBatchAt = 0.0;
 
     public function __construct(GoogleConfig $config)
     {
@@ -85,6 +98,100 @@ final class GoogleApiClient
         );
     }
 
+    /**
+     * PATCH many events through the Calendar batch endpoint.
+     *
+     * Requests are sent in chunks of BATCH_MAX_REQUESTS with a minimum spacing
+     * between batches. Sub-requests rejected with 429/503 (or a 403 rate-limit
+     * reason) are retried with Retry-After / exponential backoff.
+     *
+     * @param array<string,array<string,mixed>> $payloadsByEventId
+     * @param callable(int,int):void|null $onBatch Receives (done, total) after each batch
+     * @return array<string,string> Failure messages keyed by eventId (empty on full success)
+     */
+    public function batchUpdateEvents(string $calendarId, array $payloadsByEventId, ?callable $onBatch = null): array
+    {
+        if ($payloadsByEventId === []) {
+            return [];
+        }
+
+        $this->ensureAuthenticated();
+
+        $total = count($payloadsByEventId);
+        $done = 0;
+        $failures = [];
+        $pending = $payloadsByEventId;
+
+        for ($attempt = 1; $pending !== []; $attempt++) {
+            $retry = [];
+            $retryAfter = 0;
+
+            foreach (array_chunk($pending, self::BATCH_MAX_REQUESTS, true) as $chunk) {
+                $this->throttleBatch();
+                $responses = $this->requestBatch($calendarId, $chunk);
+
+                foreach ($chunk as $eventId => $payload) {
+                    $eventId = (string)$eventId;
+                    $response = $responses[$eventId] ?? [
+                        'status' => 0,
+                        'message' => 'missing batch response part',
+                        'retryAfter' => 0,
+                    ];
+                    $status = $response['status'];
+
+                    if ($status >= 200 && $status < 300) {
+                        $done++;
+                        continue;
+                    }
+
+                    if ($attempt < self::BATCH_MAX_ATTEMPTS && $this->isRetryableBatchStatus($status, $response['message'])) {
+                        $retry[$eventId] = $payload;
+                        $retryAfter = max($retryAfter, $response['retryAfter']);
+                        continue;
+                    }
+
+                    $failures[$eventId] = "HTTP {$status}: " . $response['message'];
+                    $done++;
+                }
+
+                if ($onBatch !== null) {
+                    $onBatch($done, $total);
+                }
+            }
+
+            if ($retry !== []) {
+                $backoff = min(self::BATCH_MAX_BACKOFF_SECONDS, 2 ** $attempt);
+                sleep(max($retryAfter, $backoff));
+            }
+            $pending = $retry;
+        }
+
+        return $failures;
+    }
+
+    /**
+     * Fetch one event; null when it no longer exists (HTTP 404/410).
+     *
+     * @return array<string,mixed>|null Raw Google Event resource
+     */
+    public function getEvent(string $calendarId, string $eventId): ?array
+    {
+        $this->ensureAuthenticated();
+        try {
+            return $this->requestJson(
+                'GET',
+                "/calendars/" . rawurlencode($calendarId) . "/events/" . rawurlencode($eventId),
+                null
+            );
+        } catch (\RuntimeException $e) {
+            $message = $e->getMessage();
+            if (strpos($message, 'HTTP 404') !== false || strpos($message, 'HTTP 410') !== false) {
+                return null;
+            }
+            throw $e;
+        }
+    }
+
     public function deleteEvent(string $calendarId, string $eventId): void
     {
         $this->ensureAuthenticated();
@@ -176,23 +283,42 @@ final class GoogleApiClient
      * @return array Raw Google Event resources
      */
     public function listEvents(string $calendarId, array $params = []): array
+    {
+        return iterator_to_array($this->streamEvents($calendarId, $params), false);
+    }
+
+    /**
+     * Yield raw events page by page as they arrive.
+     *
+     * Only the page being consumed is held in memory, so raw payloads stay
+     * bounded by maxResults rather than by calendar size. This bounds raw
+     * events only: the translator still collects every translated row.
+     *
+     * @param array $params Optional query params (timeMin, timeMax, syncToken, pageToken, etc.)
+     * @return \Generator<int,array<string,mixed>> Raw Google Event resources
+     */
+    public function streamEvents(string $calendarId, array $params = []): \Generator
     {
         $this->ensureAuthenticated();
 
         // Force full snapshot semantics (no incremental sync behavior)
         // We want all recurring *masters*, not instance expansion and not delta-based filtering.
+        // The window is the configured sync horizon; with singleEvents=false Google still
+        // returns every recurring master with at least one instance inside it.
+        $horizon = $this->config->getSyncHorizon()->toArray();
         $params = array_merge([
             'singleEvents' => false,
             'showDeleted'  => false,
             'maxResults'   => 2500,
-            'timeMin'      => '1970-01-01T00:00:00Z',
-            'timeMax'      => '2100-01-01T00:00:00Z',
+            'timeMin'      => $horizon['start'],
+            'timeMax'      => $horizon['end'],
         ], $params);
 
-        $allItems = [];
         $pageToken = null;
+        $page = 0;
 
         do {
+            $page++;
             $pageParams = $params;
             if ($pageToken !== null) {
                 $pageParams['pageToken'] = $pageToken;
@@ -202,21 +328,24 @@ final class GoogleApiClient
                 $this->normalizeQueryParams($pageParams)
             );
 
+            Trace::begin('events page', 'provider', ['provider' => 'google', 'page' => $page]);
             $res = $this->requestJson(
                 'GET',
                 '/calendars/' . rawurlencode($calendarId) . '/events' . $query,
                 null
             );
 
-            if (isset($res['items']) && is_array($res['items'])) {
-                $allItems = array_merge($allItems, $res['items']);
-            }
-
             $pageToken = $res['nextPageToken'] ?? null;
+            $items = is_array($res['items'] ?? null) ? $res['items'] : [];
+            unset($res);
+            Trace::end(['items' => count($items)]);
 
-        } while ($pageToken !== null);
+            foreach ($items as $item) {
+                yield $item;
+            }
+            unset($items);
 
-        return $allItems;
+        } while ($pageToken !== null);
     }
 
     // ---------------------------------------------------------------------
@@ -313,7 +442,9 @@ final class GoogleApiClient
         curl_setopt($ch, CURLOPT_POSTFIELDS, $post);
         curl_setopt($ch, CURLOPT_HTTPHEADER, ['Content-Type: application/x-www-form-urlencoded']);
 
+        $traceStart = Trace::now();
         $body = curl_exec($ch);
+        Trace::http($ch, 'POST token', $traceStart, ['method' => 'POST']);
         $code = curl_getinfo($ch, CURLINFO_HTTP_CODE);
         if ($body === false) {
             $err = curl_error($ch);
@@ -349,6 +480,21 @@ final class GoogleApiClient
     // Google Calendar REST helpers
     // ---------------------------------------------------------------------
 
+    /**
+     * Whether a single request may be sent again after $status. 429 means the
+     * request was rejected unprocessed, so any method may retry it. A 503 may
+     * come after the server acted, so it is only retried for idempotent
+     * methods: a retried POST could create the event twice.
+     */
+    public static function isRetryableRequest(string $method, int $status): bool
+    {
+        if ($status === 429) {
+            return true;
+        }
+
+        return $status === 503 && in_array(strtoupper($method), ['GET', 'PUT', 'PATCH', 'DELETE'], true);
+    }
+
     private function requestJson(string $method, string $path, ?array $payload): array
     {
         $token = $this->loadToken();
@@ -356,37 +502,61 @@ final class GoogleApiClient
             throw new \RuntimeException("Missing access_token; OAuth bootstrap required.");
         }
 
-        $base = 'https://www.googleapis.com/calendar/v3';
-        $url = $base . $path;
-
-        $ch = curl_init($url);
-        curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
-        curl_setopt($ch, CURLOPT_CUSTOMREQUEST, $method);
+        $url = $this->config->getApiBaseUrl() . $path;
 
         $headers = [
             'Authorization: Bearer ' . $token['access_token'],
             'Accept: application/json',
         ];
 
+        $json = null;
         if ($payload !== null) {
             $json = json_encode($payload, JSON_UNESCAPED_SLASHES);
             if ($json === false) {
                 throw new \RuntimeException("Unable to encode Google payload JSON.");
             }
-            curl_setopt($ch, CURLOPT_POSTFIELDS, $json);
             $headers[] = 'Content-Type: application/json';
         }
 
-        curl_setopt($ch, CURLOPT_HTTPHEADER, $headers);
+        // Throttled/unavailable requests are retried in place (see
+        // isRetryableRequest), honoring Retry-After when the server sends one.
+        for ($attempt = 1; ; $attempt++) {
+            $retryAfter = 0;
+            $ch = curl_init($url);
+            curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
+            curl_setopt($ch, CURLOPT_CUSTOMREQUEST, $method);
+            if ($json !== null) {
+                curl_setopt($ch, CURLOPT_POSTFIELDS, $json);
+            }
+            curl_setopt($ch, CURLOPT_HTTPHEADER, $headers);
+            curl_setopt(
+                $ch,
+                CURLOPT_HEADERFUNCTION,
+                static function ($handle, string $line) use (&$retryAfter): int {
+                    if (preg_match('/^Retry-After:\s*(\d+)/i', $line, $m)) {
+                        $retryAfter = (int)$m[1];
+                    }
+                    return strlen($line);
+                }
+            );
 
-        $body = curl_exec($ch);
-        $code = curl_getinfo($ch, CURLINFO_HTTP_CODE);
-        if ($body === false) {
-            $err = curl_error($ch);
+            $traceStart = Trace::now();
+            $body = curl_exec($ch);
+            Trace::http($ch, $method . ' ' . explode('?', $path, 2)[0], $traceStart, ['method' => $method, 'attempt' => $attempt]);
+            $code = curl_getinfo($ch, CURLINFO_HTTP_CODE);
+            if ($body === false) {
+                $err = curl_error($ch);
+                curl_close($ch);
+                throw new \RuntimeException("Google API request failed: {$err}");
+            }
             curl_close($ch);
-            throw new \RuntimeException("Google API request failed: {$err}");
+
+            if (self::isRetryableRequest($method, $code) && $attempt < self::REQUEST_MAX_ATTEMPTS) {
+                sleep(max($retryAfter, min(self::REQUEST_MAX_BACKOFF_SECONDS, 2 ** ($attempt - 1))));
+                continue;
+            }
+            break;
         }
-        curl_close($ch);
 
         // DELETE may return empty body.
         if ($body === '' || $body === null) {
@@ -409,6 +579,146 @@ final class GoogleApiClient
         return $data;
     }
 
+    /**
+     * Send one multipart/mixed batch of PATCH calls.
+     *
+     * @param array<string,array<string,mixed>> $payloadsByEventId
+     * @return array<string,array{status:int,message:string,retryAfter:int}>
+     */
+    private function requestBatch(string $calendarId, array $payloadsByEventId): array
+    {
+        $token = $this->loadToken();
+        if ($token === null || !is_string($token['access_token'] ?? null)) {
+            throw new \RuntimeException("Missing access_token; OAuth bootstrap required.");
+        }
+
+        $boundary = 'cs_batch_' . bin2hex(random_bytes(8));
+        $eventIdByContentId = [];
+        $body = '';
+        $index = 0;
+
+        foreach ($payloadsByEventId as $eventId => $payload) {
+            $index++;
+            $contentId = 'item' . $index;
+            $eventIdByContentId[$contentId] = (string)$eventId;
+
+            $json = json_encode($payload, JSON_UNESCAPED_SLASHES);
+            if ($json === false) {
+                throw new \RuntimeException("Unable to encode Google batch payload JSON.");
+            }
+
+            $body .= "--{$boundary}\r\n"
+                . "Content-Type: application/http\r\n"
+                . "Content-ID: <{$contentId}>\r\n\r\n"
+                . 'PATCH ' . self::BATCH_PATH_PREFIX
+                . '/calendars/' . rawurlencode($calendarId)
+                . '/events/' . rawurlencode((string)$eventId) . "\r\n"
+                . "Content-Type: application/json\r\n\r\n"
+                . $json . "\r\n";
+        }
+        $body .= "--{$boundary}--\r\n";
+
+        $responseContentType = '';
+        $ch = curl_init($this->config->getBatchUrl());
+        curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
+        curl_setopt($ch, CURLOPT_POST, true);
+        curl_setopt($ch, CURLOPT_POSTFIELDS, $body);
+        curl_setopt($ch, CURLOPT_HTTPHEADER, [
+            'Authorization: Bearer ' . $token['access_token'],
+            'Content-Type: multipart/mixed; boundary=' . $boundary,
+        ]);
+        curl_setopt(
+            $ch,
+            CURLOPT_HEADERFUNCTION,
+            static function ($handle, string $line) use (&$responseContentType): int {
+                if (stripos($line, 'Content-Type:') === 0) {
+                    $responseContentType = trim(substr($line, strlen('Content-Type:')));
+                }
+                return strlen($line);
+            }
+        );
+
+        $traceStart = Trace::now();
+        $raw = curl_exec($ch);
+        Trace::http($ch, 'POST batch', $traceStart, ['method' => 'POST', 'requests' => count($payloadsByEventId)]);
+        $code = curl_getinfo($ch, CURLINFO_HTTP_CODE);
+        if ($raw === false) {
+            $err = curl_error($ch);
+            curl_close($ch);
+            throw new \RuntimeException("Google batch request failed: {$err}");
+        }
+        curl_close($ch);
+
+        if ($code < 200 || $code >= 300) {
+            // Whole-batch rejection: surface every item with the outer status so callers can retry.
+            $out = [];
+            foreach ($eventIdByContentId as $eventId) {
+                $out[$eventId] = ['status' => (int)$code, 'message' => 'batch rejected', 'retryAfter' => 0];
+            }
+            return $out;
+        }
+
+        if (!preg_match('/boundary="?([^";]+)"?/i', $responseContentType, $m)) {
+            throw new \RuntimeException("Google batch response missing multipart boundary (HTTP {$code}).");
+        }
+
+        $out = [];
+        foreach (explode('--' . $m[1], (string)$raw) as $part) {
+            if (!preg_match('/Content-ID:\s*<response-([^>]+)>/i', $part, $idMatch)) {
+                continue;
+            }
+            $eventId = $eventIdByContentId[$idMatch[1]] ?? null;
+            if ($eventId === null || !preg_match('/HTTP\/[\d.]+\s+(\d{3})/', $part, $statusMatch)) {
+                continue;
+            }
+
+            $retryAfter = 0;
+            if (preg_match('/^Retry-After:\s*(\d+)/mi', $part, $retryMatch)) {
+                $retryAfter = (int)$retryMatch[1];
+            }
+
+            $message = '';
+            $jsonStart = strpos($part, '{');
+            if ($jsonStart !== false) {
+                $decoded = json_decode(trim(substr($part, $jsonStart)), true);
+                if (is_array($decoded) && is_array($decoded['error'] ?? null)) {
+                    $message = (string)($decoded['error']['message'] ?? '');
+                    $reason = $decoded['error']['errors'][0]['reason'] ?? null;
+                    if (is_string($reason) && $reason !== '') {
+                        $message .= ' [' . $reason . ']';
+                    }
+                }
+            }
+
+            $out[$eventId] = [
+                'status' => (int)$statusMatch[1],
+                'message' => $message !== '' ? $message : 'unknown',
+                'retryAfter' => $retryAfter,
+            ];
+        }
+
+        return $out;
+    }
+
+    private function isRetryableBatchStatus(int $status, string $message): bool
+    {
+        if ($status === 429 || $status === 500 || $status === 503) {
+            return true;
+        }
+
+        return $status === 403
+            && (str_contains($message, 'rateLimitExceeded') || str_contains($message, 'userRateLimitExceeded'));
+    }
+
+    private function throttleBatch(): void
+    {
+        $elapsedMs = (microtime(true) - $this->lastBatchAt) * 1000;
+        if ($this->lastBatchAt > 0 && $elapsedMs < self::BATCH_MIN_INTERVAL_MS) {
+            usleep((int)((self::BATCH_MIN_INTERVAL_MS - $elapsedMs) * 1000));
+        }
+        $this->lastBatchAt = microtime(true);
+    }
+
     private function normalizeQueryParams(array $params): array
     {
         foreach ($params as $key => $value) {
@@ -11,7 +11,9 @@ declare(strict_types=1);
 namespace CalendarScheduler\Adapter\Calendar\Google;
 
 use CalendarScheduler\Adapter\Calendar\MapperShared;
+use CalendarScheduler\Adapter\Calendar\TranslationCache;
 use CalendarScheduler\Adapter\Calendar\TranslatorShared;
+use CalendarScheduler\Platform\Trace;
 use DateTimeImmutable;
 use DateTimeZone;
 
@@ -25,32 +27,54 @@ final class GoogleCalendarTranslator
 {
     private const MANAGED_FORMAT_VERSION = '2';
 
+    // Bump when translated rows change shape, so cached rows are rebuilt.
+    private const TRANSLATION_SCHEMA_VERSION = '2';
+
     private bool $debugCalendar;
     private DateTimeZone $localTimezone;
 
-    public function __construct()
-    {
+    public function __construct(
+        private readonly ?TranslationCache $cache = null
+    ) {
         $this->debugCalendar = getenv('CS_DEBUG_CALENDAR') === '1';
         $this->localTimezone = $this->resolveLocalTimezone();
     }
 
     /**
      * Canonical entrypoint for Calendar I/O ingestion.
+     * Accepts a generator so each fetched page is translated before the next is decoded.
      *
-     * @param array<int,array<string,mixed>> $googleEvents Raw Google "Event" resources (decoded JSON arrays)
+     * @param iterable<int,array<string,mixed>> $googleEvents Raw Google "Event" resources (decoded JSON arrays)
      * @param string $calendarId
      * @return array<int,array<string,mixed>> Provider-neutral CalendarEvent records
      */
-    public function ingest(array $googleEvents, string $calendarId): array
+    public function ingest(iterable $googleEvents, string $calendarId): array
     {
-        return $this->translateGoogleEvents($googleEvents, $calendarId);
+        // Provider pages are fetched lazily, so they nest inside this span.
+        Trace::begin('translate', 'translator', ['provider' => 'google', 'calendarId' => $calendarId]);
+        $rows = $this->translateGoogleEvents($googleEvents, $calendarId);
+        Trace::end(['rows' => count($rows), 'cachedRows' => $this->cache?->hits() ?? 0]);
+
+        return $rows;
     }
     /**
-     * @param array<int,array<string,mixed>> $googleEvents Raw Google "Event" resources (decoded JSON arrays)
+     * Raw events are consumed one at a time, but translated rows are collected:
+     * a managed duplicate collapses into an earlier row, and the translation
+     * cache holds every row of the pass until save().
+     *
+     * @param iterable<int,array<string,mixed>> $googleEvents Raw Google "Event" resources (decoded JSON arrays)
      * @return array<int,array<string,mixed>> Provider-neutral CalendarEvent records
      */
-    public function translateGoogleEvents(array $googleEvents, string $calendarId): array
+    public function translateGoogleEvents(iterable $googleEvents, string $calendarId): array
     {
+        $this->cache?->begin(implode('|', [
+            'google',
+            self::TRANSLATION_SCHEMA_VERSION,
+            self::MANAGED_FORMAT_VERSION,
+            $this->localTimezone->getName(),
+            $calendarId,
+        ]));
+
         $out = [];
         /** @var array<string,int> $managedIndexByKey */
         $managedIndexByKey = [];
@@ -71,127 +95,18 @@ final class GoogleCalendarTranslator
                 continue;
             }
 
-            $source = [
-                'provider'    => 'google',
-                'calendar_id' => $calendarId,
-            ];
-
-            $provenance = $this->buildProvenance($ev);
-
-            // Summary / description (opaque user-facing content).
-            $summary     = is_string($ev['summary'] ?? null) ? $ev['summary'] : '';
-            $description = array_key_exists('description', $ev) ? ($ev['description'] ?? null) : null;
-            if (!is_string($description) && $description !== null) {
-                $description = null;
-            }
-            $status = is_string($ev['status'] ?? null) ? $ev['status'] : 'confirmed';
-            $decodedMetadata = GoogleEventMetadataSchema::decodeFromGoogleEvent($ev);
-            $observedStyleToken = MapperShared::googleColorIdToStyleToken(
-                is_string($ev['colorId'] ?? null) ? (string)$ev['colorId'] : null
-            );
-            if (is_string($observedStyleToken) && $observedStyleToken !== '') {
-                $decodedSettings = is_array($decodedMetadata['settings'] ?? null) ? $decodedMetadata['settings'] : [];
-                $decodedSettings['styleToken'] = $observedStyleToken;
-                $decodedMetadata['settings'] = $decodedSettings;
-            }
-
-            $schedulerMetadata = $this->reconcileSchedulerMetadata(
-                $decodedMetadata,
-                $summary,
-                $description
-            );
-
-            // Start / end
-            [$dtstart, $dtend, $isAllDay] = $this->translateStartEnd($ev);
-
-            // Recurrence + EXDATE (preserve, do not expand)
-            [$rrule, $exDates] = $this->translateRecurrence($ev);
-
-            // Overrides
-            $recurringEventId = $ev['recurringEventId'] ?? null;
-            $isOverride       = is_string($recurringEventId) && $recurringEventId !== '';
-            $parentUid        = $isOverride ? $recurringEventId : null;
-
-            $originalStartTime = is_array($ev['originalStartTime'] ?? null)
-                ? $ev['originalStartTime']
-                : null;
-
-            // Preserve Google start/end arrays verbatim for downstream (time may be hard or all-day).
-            $startRaw = is_array($ev['start'] ?? null) ? $ev['start'] : [];
-            $endRaw   = is_array($ev['end'] ?? null) ? $ev['end'] : [];
-
-            // Best-effort timezone hint (structural only). Google may provide per-start/per-end timeZone.
-            $tz = null;
-            if (is_string($startRaw['timeZone'] ?? null) && $startRaw['timeZone'] !== '') {
-                $tz = $startRaw['timeZone'];
-            } elseif (is_string($endRaw['timeZone'] ?? null) && $endRaw['timeZone'] !== '') {
-                $tz = $endRaw['timeZone'];
-            }
-
-            $uid = $provenance['uid'] ?? null;
-
-            // Optional low-level RRULE tracing (very noisy, off by default)
-            if ($this->debugCalendar) {
-                if (is_array($rrule) && isset($rrule['byday'])) {
-                    error_log(
-                        'RAW RRULE BYDAY [calendar]: ' .
-                        json_encode($rrule['byday'])
-                    );
-                } else {
-                    error_log('RAW RRULE BYDAY [calendar]: null');
+            // Unchanged events (same id + etag) reuse last run's translation.
+            $eventId = is_string($ev['id'] ?? null) ? $ev['id'] : '';
+            $etag = is_string($ev['etag'] ?? null) ? $ev['etag'] : '';
+            $cacheable = $this->cache !== null && $eventId !== '' && $etag !== '';
+            $row = $cacheable ? $this->cache->get($eventId, $etag) : null;
+            if ($row === null) {
+                $row = $this->translateEventRow($ev, $calendarId);
+                if ($cacheable) {
+                    $this->cache->put($eventId, $etag, $row);
                 }
             }
 
-            $row = [
-                // Provider + calendar identity
-                'provider'        => 'google',
-                'calendar_id'     => $calendarId,
-
-                // Stable identity anchors
-                'uid'             => $uid,
-                'sourceEventUid'  => $uid,
-
-                // Human fields (opaque here; do not parse)
-                'summary'         => $summary,
-                'description'     => $description,
-                'status'          => $status,
-
-                // Raw Google timing semantics (structural; downstream decides how to interpret)
-                // - All-day uses ['date']
-                // - Timed uses ['dateTime'] (+ optional ['timeZone'])
-                'start'           => $startRaw,
-                'end'             => $endRaw,
-                'timezone'        => $tz,
-                'isAllDay'        => $isAllDay,
-
-                // Legacy / convenience fields (kept for compatibility)
-                // ISO string (timed) or YYYY-MM-DD (all-day)
-                'dtstart'         => $dtstart,
-                'dtend'           => $dtend,
-
-                // Recurrence + exclusions (preserve; do not expand)
-                'rrule'           => $rrule,
-                'exDates'         => $exDates,
-
-                // Override linkage
-                'parentUid'       => $parentUid,
-                'originalStartTime' => $originalStartTime,
-                'isOverride'      => $isOverride,
-
-                // Opaque payload (used by downstream intent/normalization)
-                'payload'         => [
-                    'summary'     => $summary,
-                    'description' => $description,
-                    'status'      => $status,
-                    'rrule'       => $rrule,
-                    'exDates'     => $exDates,
-                    'metadata'    => $schedulerMetadata,
-                ],
-
-                // Provenance / raw metadata
-                'provenance'      => $provenance,
-            ];
-
             $managedKey = $this->managedDedupeKey($row);
             if ($managedKey === null) {
                 $out[] = $row;
@@ -205,15 +120,144 @@ final class GoogleCalendarTranslator
                 continue;
             }
 
-            $existing = $out[$existingIndex];
-            if ($this->preferManagedRow($existing, $row)) {
-                $out[$existingIndex] = $row;
-            }
+            $out[$existingIndex] = $this->collapseManagedRows($out[$existingIndex], $row);
         }
 
+        $this->cache?->save();
+
         return $out;
     }
 
+    /**
+     * Translate one Google API Event resource into a CalendarEvent row.
+     *
+     * @param array<string,mixed> $ev
+     * @return array<string,mixed>
+     */
+    private function translateEventRow(array $ev, string $calendarId): array
+    {
+        $source = [
+            'provider'    => 'google',
+            'calendar_id' => $calendarId,
+        ];
+
+        $provenance = $this->buildProvenance($ev);
+
+        // Summary / description (opaque user-facing content).
+        $summary     = is_string($ev['summary'] ?? null) ? $ev['summary'] : '';
+        $description = array_key_exists('description', $ev) ? ($ev['description'] ?? null) : null;
+        if (!is_string($description) && $description !== null) {
+            $description = null;
+        }
+        $status = is_string($ev['status'] ?? null) ? $ev['status'] : 'confirmed';
+        $decodedMetadata = GoogleEventMetadataSchema::decodeFromGoogleEvent($ev);
+        $observedStyleToken = MapperShared::googleColorIdToStyleToken(
+            is_string($ev['colorId'] ?? null) ? (string)$ev['colorId'] : null
+        );
+        if (is_string($observedStyleToken) && $observedStyleToken !== '') {
+            $decodedSettings = is_array($decodedMetadata['settings'] ?? null) ? $decodedMetadata['settings'] : [];
+            $decodedSettings['styleToken'] = $observedStyleToken;
+            $decodedMetadata['settings'] = $decodedSettings;
+        }
+
+        $schedulerMetadata = $this->reconcileSchedulerMetadata(
+            $decodedMetadata,
+            $summary,
+            $description
+        );
+
+        // Start / end
+        [$dtstart, $dtend, $isAllDay] = $this->translateStartEnd($ev);
+
+        // Recurrence + EXDATE (preserve, do not expand)
+        [$rrule, $exDates] = $this->translateRecurrence($ev);
+
+        // Overrides
+        $recurringEventId = $ev['recurringEventId'] ?? null;
+        $isOverride       = is_string($recurringEventId) && $recurringEventId !== '';
+        $parentUid        = $isOverride ? $recurringEventId : null;
+
+        $originalStartTime = is_array($ev['originalStartTime'] ?? null)
+            ? $ev['originalStartTime']
+            : null;
+
+        // Preserve Google start/end arrays verbatim for downstream (time may be hard or all-day).
+        $startRaw = is_array($ev['start'] ?? null) ? $ev['start'] : [];
+        $endRaw   = is_array($ev['end'] ?? null) ? $ev['end'] : [];
+
+        // Best-effort timezone hint (structural only). Google may provide per-start/per-end timeZone.
+        $tz = null;
+        if (is_string($startRaw['timeZone'] ?? null) && $startRaw['timeZone'] !== '') {
+            $tz = $startRaw['timeZone'];
+        } elseif (is_string($endRaw['timeZone'] ?? null) && $endRaw['timeZone'] !== '') {
+            $tz = $endRaw['timeZone'];
+        }
+
+        $uid = $provenance['uid'] ?? null;
+
+        // Optional low-level RRULE tracing (very noisy, off by default)
+        if ($this->debugCalendar) {
+            if (is_array($rrule) && isset($rrule['byday'])) {
+                error_log(
+                    'RAW RRULE BYDAY [calendar]: ' .
+                    json_encode($rrule['byday'])
+                );
+            } else {
+                error_log('RAW RRULE BYDAY [calendar]: null');
+            }
+        }
+
+        return [
+            // Provider + calendar identity
+            'provider'        => 'google',
+            'calendar_id'     => $calendarId,
+
+            // Stable identity anchors
+            'uid'             => $uid,
+            'sourceEventUid'  => $uid,
+
+            // Human fields (opaque here; do not parse)
+            'summary'         => $summary,
+            'description'     => $description,
+            'status'          => $status,
+
+            // Raw Google timing semantics (structural; downstream decides how to interpret)
+            // - All-day uses ['date']
+            // - Timed uses ['dateTime'] (+ optional ['timeZone'])
+            'start'           => $startRaw,
+            'end'             => $endRaw,
+            'timezone'        => $tz,
+            'isAllDay'        => $isAllDay,
+
+            // Legacy / convenience fields (kept for compatibility)
+            // ISO string (timed) or YYYY-MM-DD (all-day)
+            'dtstart'         => $dtstart,
+            'dtend'           => $dtend,
+
+            // Recurrence + exclusions (preserve; do not expand)
+            'rrule'           => $rrule,
+            'exDates'         => $exDates,
+
+            // Override linkage
+            'parentUid'       => $parentUid,
+            'originalStartTime' => $originalStartTime,
+            'isOverride'      => $isOverride,
+
+            // Opaque payload (used by downstream intent/normalization)
+            'payload'         => [
+                'summary'     => $summary,
+                'description' => $description,
+                'status'      => $status,
+                'rrule'       => $rrule,
+                'exDates'     => $exDates,
+                'metadata'    => $schedulerMetadata,
+            ],
+
+            // Provenance / raw metadata
+            'provenance'      => $provenance,
+        ];
+    }
+
     /**
      * Managed row dedupe key uses manifest identity + execution window so stale
      * historic rows for the same logical subevent can be collapsed.
@@ -239,6 +283,39 @@ final class GoogleCalendarTranslator
         return implode('::', [$manifestEventId, $dtstart, $dtend, $timezone, $type, $repeat, $stopType, $enabled]);
     }
 
+    /**
+     * Keep the preferred of two managed rows with the same dedupe key. The
+     * other one is listed in the kept row's provenance.duplicates (uid,
+     * observed colorId, type and enabled), so a managed color reset still
+     * reaches it.
+     */
+    private function collapseManagedRows(array $existing, array $candidate): array
+    {
+        [$kept, $dropped] = $this->preferManagedRow($existing, $candidate)
+            ? [$candidate, $existing]
+            : [$existing, $candidate];
+
+        $duplicates = [];
+        foreach ([$kept, $dropped] as $row) {
+            foreach (is_array($row['provenance']['duplicates'] ?? null) ? $row['provenance']['duplicates'] : [] as $duplicate) {
+                $duplicates[] = $duplicate;
+            }
+        }
+        $uid = is_string($dropped['uid'] ?? null) ? $dropped['uid'] : '';
+        if ($uid !== '') {
+            $settings = $dropped['payload']['metadata']['settings'] ?? [];
+            $duplicates[] = [
+                'uid' => $uid,
+                'colorId' => $dropped['provenance']['colorId'] ?? null,
+                'type' => is_array($settings) ? ($settings['type'] ?? null) : null,
+                'enabled' => is_array($settings) ? ($settings['enabled'] ?? null) : null,
+            ];
+        }
+        $kept['provenance']['duplicates'] = $duplicates;
+
+        return $kept;
+    }
+
     private function preferManagedRow(array $current, array $candidate): bool
     {
         $currentScore = $this->managedRowScore($current);
@@ -286,12 +363,18 @@ final class GoogleCalendarTranslator
         $createdEpoch = $this->isoToEpoch($ev['created'] ?? null);
         $updatedEpoch = $this->isoToEpoch($ev['updated'] ?? null);
 
+        // Observed provider color is kept so managed-color reset can diff locally.
+        $colorId = is_string($ev['colorId'] ?? null) ? trim((string)$ev['colorId']) : '';
+
         return [
             'uid'            => $uid,
             'etag'           => $etag,
             'sequence'       => $sequence,
             'createdAtEpoch' => $createdEpoch,
             'updatedAtEpoch' => $updatedEpoch,
+            'colorId'        => $colorId !== '' ? $colorId : null,
+            // Per-key metadata still to be packed by ManagedMetadataMigration.
+            'legacyMetadata' => GoogleEventMetadataSchema::legacyPrivateMetadata($ev),
         ];
     }
 
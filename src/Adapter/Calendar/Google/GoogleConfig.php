@@ -11,12 +11,20 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Adapter\Calendar\Google;
 
+use CalendarScheduler\Adapter\Calendar\SyncHorizon;
+
 final class GoogleConfig
 {
+    private const DEFAULT_API_BASE_URL = 'https://www.googleapis.com/calendar/v3';
+    private const DEFAULT_BATCH_URL = 'https://www.googleapis.com/batch/calendar/v3';
+
     // Normalized, validated configuration state.
     private string $calendarId;
+    /** @var array<int,string> */
+    private array $calendarIds;
     private string $configPath;
     private array $data;
+    private ?SyncHorizon $syncHorizon = null;
 
     public function __construct(string $configPath)
     {
@@ -43,6 +51,15 @@ final class GoogleConfig
             $calendarId = 'primary';
         }
         $this->calendarId = $calendarId;
+
+        // Additional calendars synced alongside the primary one (fan-out).
+        $calendarIds = [$this->calendarId];
+        foreach (is_array($data['calendar_ids'] ?? null) ? $data['calendar_ids'] : [] as $extra) {
+            if (is_string($extra) && trim($extra) !== '' && !in_array(trim($extra), $calendarIds, true)) {
+                $calendarIds[] = trim($extra);
+            }
+        }
+        $this->calendarIds = $calendarIds;
     }
 
     public function getCalendarId(): string
@@ -50,6 +67,16 @@ final class GoogleConfig
         return $this->calendarId;
     }
 
+    /**
+     * Every synced calendar, primary first. More than one enables fan-out.
+     *
+     * @return array<int,string>
+     */
+    public function getCalendarIds(): array
+    {
+        return $this->calendarIds;
+    }
+
     /**
      * Absolute directory containing config.json.
      * This is the authoritative base for token.json and client files.
@@ -108,4 +135,58 @@ final class GoogleConfig
             . DIRECTORY_SEPARATOR
             . $tokenFile;
     }
+
+    /**
+     * Calendar v3 REST base URL.
+     * CS_GOOGLE_API_BASE (or config api_base_url) points the client at a local stand-in.
+     */
+    public function getApiBaseUrl(): string
+    {
+        $override = getenv('CS_GOOGLE_API_BASE');
+        if (is_string($override) && trim($override) !== '') {
+            return rtrim(trim($override), '/');
+        }
+
+        $configured = $this->data['api_base_url'] ?? null;
+        if (is_string($configured) && trim($configured) !== '') {
+            return rtrim(trim($configured), '/');
+        }
+
+        return self::DEFAULT_API_BASE_URL;
+    }
+
+    /**
+     * Batch endpoint URL. Derived from a non-default API base as
+     * {origin}/batch/calendar/v3 unless batch_url is configured explicitly.
+     */
+    public function getBatchUrl(): string
+    {
+        $configured = $this->data['batch_url'] ?? null;
+        if (is_string($configured) && trim($configured) !== '' && getenv('CS_GOOGLE_API_BASE') === false) {
+            return rtrim(trim($configured), '/');
+        }
+
+        $apiBase = $this->getApiBaseUrl();
+        if ($apiBase === self::DEFAULT_API_BASE_URL) {
+            return self::DEFAULT_BATCH_URL;
+        }
+
+        $parts = parse_url($apiBase);
+        if (!is_array($parts) || !is_string($parts['host'] ?? null)) {
+            throw new \RuntimeException("Google api_base_url is not a valid URL: {$apiBase}");
+        }
+
+        return ($parts['scheme'] ?? 'https') . '://' . $parts['host']
+            . (isset($parts['port']) ? ':' . $parts['port'] : '')
+            . '/batch/calendar/v3';
+    }
+
+    /**
+     * Rolling fetch window (sync_horizon_days_back / sync_horizon_days_forward).
+     * Memoized so listing and the snapshot wrapper agree on the same bounds.
+     */
+    public function getSyncHorizon(): SyncHorizon
+    {
+        return $this->syncHorizon ??= SyncHorizon::fromConfig($this->data);
+    }
 }
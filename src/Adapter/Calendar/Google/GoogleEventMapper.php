@@ -12,6 +12,7 @@ namespace CalendarScheduler\Adapter\Calendar\Google;
 
 use CalendarScheduler\Adapter\Calendar\MapperShared;
 use CalendarScheduler\Diff\ReconciliationAction;
+use CalendarScheduler\Platform\HashScheme;
 use CalendarScheduler\Platform\HolidayResolver;
 use RuntimeException;
 
@@ -42,6 +43,8 @@ final class GoogleEventMapper
         'update_noop_nomappable' => 0,
         'update_format_only' => 0,
         'update_skipped_missing_delete_ids' => 0,
+        'update_in_place' => 0,
+        'update_replaced' => 0,
         'unmappable_reasons' => [],
     ];
 
@@ -71,7 +74,15 @@ final class GoogleEventMapper
             throw new RuntimeException('Manifest event has no resolved subEvents');
         }
 
-        $calendarId = $config->getCalendarId();
+        $calendarId = MapperShared::targetCalendarId($event, $config->getCalendarIds());
+        if ($calendarId === null) {
+            error_log(
+                'GoogleEventMapper: skipping action for a calendar that is not synced '
+                . 'identityHash=' . $action->identityHash
+                . ' sourceCalendarId=' . (string)($event['correlation']['sourceCalendarId'] ?? '')
+            );
+            return [];
+        }
 
         return match ($action->type) {
             ReconciliationAction::TYPE_CREATE =>
@@ -404,10 +415,13 @@ final class GoogleEventMapper
     /**
      * UPDATE semantics
      *
-     * Step C strategy: destructive replace.
-     *
-     * - Treat update as delete existing + create desired.
-     * - Avoid partial patch behavior without persisted provider-state mapping.
+     * - Identity-preserving updates (same event count, each desired SubEvent
+     *   pairs with one existing Google event of the same recurring/single
+     *   shape) are sent as minimal PATCHes of the changed fields only, so
+     *   Google event ids and correlation maps stay stable.
+     * - Shape changes (recurring <-> single, bundle restructuring) or updates
+     *   without a known current provider state fall back to destructive
+     *   replace: delete existing + create desired.
      *
      * @param ReconciliationAction $action
      * @param array<int, array<string,mixed>> $subEvents
@@ -454,12 +468,151 @@ final class GoogleEventMapper
             return [];
         }
 
+        $patchMutations = $this->mapInPlaceUpdates($action, $subEvents, $calendarId, $deleteMutations);
+        if ($patchMutations !== null) {
+            $this->diagnostics['update_in_place']++;
+            return $patchMutations;
+        }
+
+        $this->diagnostics['update_replaced']++;
         return [
             ...$deleteMutations,
             ...$createMutations,
         ];
     }
 
+    /**
+     * Pair desired SubEvents with the existing Google events and emit one
+     * field-level PATCH per changed event.
+     *
+     * Returns null when the update is not identity-preserving and must be
+     * applied as delete + create.
+     *
+     * @param array<int, array<string,mixed>> $subEvents
+     * @param list<GoogleMutation> $deleteMutations Every Google event currently linked to the identity
+     * @return list<GoogleMutation>|null
+     */
+    private function mapInPlaceUpdates(
+        ReconciliationAction $action,
+        array $subEvents,
+        string $calendarId,
+        array $deleteMutations
+    ): ?array {
+        $currentEvent = $action->currentEvent;
+        $currentSubEvents = is_array($currentEvent['subEvents'] ?? null) ? $currentEvent['subEvents'] : [];
+        if ($deleteMutations === [] || $currentSubEvents === []) {
+            return null;
+        }
+
+        // Current provider payloads keyed by the Google event carrying them.
+        $currentAction = new ReconciliationAction(
+            $action->type,
+            $action->target,
+            $action->authority,
+            $action->identityHash,
+            $action->reason,
+            $currentEvent
+        );
+        $currentPayloads = [];
+        foreach ($currentSubEvents as $currentSubEvent) {
+            if (!is_array($currentSubEvent)) {
+                continue;
+            }
+            $eventId = $this->resolveGoogleEventId($currentEvent, $currentSubEvent);
+            if ($eventId === null || isset($currentPayloads[$eventId])) {
+                return null;
+            }
+            try {
+                $currentPayloads[$eventId] = $this->buildPayload($currentAction, $currentSubEvent);
+            } catch (RuntimeException $e) {
+                if (!$this->isUnmappableTimingError($e)) {
+                    throw $e;
+                }
+                return null;
+            }
+        }
+
+        // Every linked Google event must be carried over; leftovers mean the bundle changed shape.
+        $linkedIds = [];
+        foreach ($deleteMutations as $delete) {
+            $linkedIds[(string)$delete->googleEventId] = true;
+        }
+        if (array_diff_key($linkedIds, $currentPayloads) !== [] || array_diff_key($currentPayloads, $linkedIds) !== []) {
+            return null;
+        }
+
+        $desired = [];
+        foreach ($subEvents as $subEvent) {
+            if (!is_array($subEvent)) {
+                continue;
+            }
+            try {
+                $payload = $this->buildPayload($action, $subEvent);
+            } catch (RuntimeException $e) {
+                if (!$this->isUnmappableTimingError($e)) {
+                    throw $e;
+                }
+                return null;
+            }
+            $desired[] = [
+                'subEventHash' => $this->deriveSubEventHash($subEvent),
+                'eventId' => $this->extractGoogleEventId($action, $subEvent),
+                'payload' => $payload,
+            ];
+        }
+        if (count($desired) !== count($currentPayloads)) {
+            return null;
+        }
+
+        // Pair by resolved id first; a single remaining SubEvent pairs with the single remaining event.
+        $unclaimed = $currentPayloads;
+        $unpaired = [];
+        foreach ($desired as $i => $row) {
+            $eventId = $row['eventId'];
+            if ($eventId !== null && isset($unclaimed[$eventId])) {
+                unset($unclaimed[$eventId]);
+                continue;
+            }
+            $unpaired[] = $i;
+        }
+        if (count($unpaired) > 1) {
+            return null;
+        }
+        if ($unpaired !== []) {
+            $desired[$unpaired[0]]['eventId'] = (string)array_key_first($unclaimed);
+        }
+
+        $mutations = [];
+        foreach ($desired as $row) {
+            $current = $currentPayloads[$row['eventId']];
+            if (MapperShared::isRecurringPayload($current) !== MapperShared::isRecurringPayload($row['payload'])) {
+                return null;
+            }
+
+            $patch = MapperShared::payloadPatch($current, $row['payload']);
+            if ($patch === []) {
+                continue;
+            }
+
+            $mutations[] = new GoogleMutation(
+                op: GoogleMutation::OP_UPDATE,
+                calendarId: $calendarId,
+                googleEventId: $row['eventId'],
+                payload: $patch,
+                manifestEventId: $action->identityHash,
+                subEventHash: $row['subEventHash']
+            );
+        }
+
+        $this->debug(
+            'GoogleEventMapper: update mapped as in-place patch(es) ' .
+            'identityHash=' . $action->identityHash .
+            ' count=' . count($mutations)
+        );
+
+        return $mutations;
+    }
+
     /**
      * Build format-only update mutations when timing is unmappable.
      *
@@ -556,7 +709,7 @@ final class GoogleEventMapper
             'summary' => $summary,
             'description' => $description,
             'extendedProperties' => [
-                'private' => GoogleEventMetadataSchema::privateMetadata(
+                'private' => GoogleEventMetadataSchema::privateProperties(GoogleEventMetadataSchema::privateMetadata(
                     $action->identityHash,
                     $subEventHash,
                     'google',
@@ -576,7 +729,7 @@ final class GoogleEventMapper
                         : null,
                     isset($timing['end_time']['offset']) ? (int)$timing['end_time']['offset'] : null,
                     $styleToken
-                ),
+                )),
             ],
         ];
     }
@@ -596,6 +749,8 @@ final class GoogleEventMapper
         $updateNoopNoMappable = (int)($this->diagnostics['update_noop_nomappable'] ?? 0);
         $updateFormatOnly = (int)($this->diagnostics['update_format_only'] ?? 0);
         $updateSkippedMissingDeleteIds = (int)($this->diagnostics['update_skipped_missing_delete_ids'] ?? 0);
+        $updateInPlace = (int)($this->diagnostics['update_in_place'] ?? 0);
+        $updateReplaced = (int)($this->diagnostics['update_replaced'] ?? 0);
         $reasons = is_array($this->diagnostics['unmappable_reasons'] ?? null)
             ? $this->diagnostics['unmappable_reasons']
             : [];
@@ -605,6 +760,8 @@ final class GoogleEventMapper
             && $updateNoopNoMappable === 0
             && $updateFormatOnly === 0
             && $updateSkippedMissingDeleteIds === 0
+            && $updateInPlace === 0
+            && $updateReplaced === 0
         ) {
             return;
         }
@@ -624,6 +781,8 @@ final class GoogleEventMapper
             ' update_noop_nomappable=' . $updateNoopNoMappable .
             ' update_format_only=' . $updateFormatOnly .
             ' update_skipped_missing_delete_ids=' . $updateSkippedMissingDeleteIds .
+            ' update_in_place=' . $updateInPlace .
+            ' update_replaced=' . $updateReplaced .
             $reasonSummary
         );
     }
@@ -768,7 +927,7 @@ final class GoogleEventMapper
             'start'       => $this->mapDateTime($start, $tz),
             'end'         => $this->mapDateTime($end, $tz),
             'extendedProperties' => [
-                'private' => GoogleEventMetadataSchema::privateMetadata(
+                'private' => GoogleEventMetadataSchema::privateProperties(GoogleEventMetadataSchema::privateMetadata(
                     $action->identityHash,
                     $subEventHash,
                     'google',
@@ -787,7 +946,7 @@ final class GoogleEventMapper
                         ? trim((string)$timing['end_time']['symbolic'])
                         : null,
                     isset($timing['end_time']['offset']) ? (int)$timing['end_time']['offset'] : null
-                ),
+                )),
             ],
         ];
         $recurrence = $this->buildGoogleRecurrenceFromTiming($timing, $tz, $start, $end);
@@ -916,11 +1075,11 @@ final class GoogleEventMapper
             return $stateHash;
         }
 
-        return hash('sha256', json_encode([
+        return HashScheme::digest([
             'timing' => $subEvent['timing'] ?? null,
             'payload' => $subEvent['payload'] ?? null,
             'behavior' => $subEvent['behavior'] ?? null,
-        ], JSON_THROW_ON_ERROR));
+        ]);
     }
 
     /**
@@ -929,6 +1088,15 @@ final class GoogleEventMapper
      * @param array<string,mixed> $subEvent
      */
     private function extractGoogleEventId(ReconciliationAction $action, array $subEvent): ?string
+    {
+        return is_array($action->event) ? $this->resolveGoogleEventId($action->event, $subEvent) : null;
+    }
+
+    /**
+     * @param array<string,mixed> $event
+     * @param array<string,mixed> $subEvent
+     */
+    private function resolveGoogleEventId(array $event, array $subEvent): ?string
     {
         $id = $subEvent['payload']['googleEventId'] ?? null;
         if ($this->isResolvableGoogleEventId($id)) {
@@ -936,7 +1104,7 @@ final class GoogleEventMapper
         }
 
         $subEventHash = $this->deriveSubEventHash($subEvent);
-        $corrIds = $action->event['correlation']['googleEventIds'] ?? null;
+        $corrIds = $event['correlation']['googleEventIds'] ?? null;
         if (is_array($corrIds)) {
             $corrId = $corrIds[$subEventHash] ?? null;
             if ($this->isResolvableGoogleEventId($corrId)) {
@@ -953,7 +1121,7 @@ final class GoogleEventMapper
             }
         }
 
-        $corrId = $action->event['correlation']['sourceEventUid'] ?? null;
+        $corrId = $event['correlation']['sourceEventUid'] ?? null;
         if ($this->isResolvableGoogleEventId($corrId)) {
             return trim((string)$corrId);
         }
@@ -1283,8 +1451,8 @@ final class GoogleEventMapper
             return false;
         }
 
-        // Internal manifest identity hashes are sha256 and never valid Google ids.
-        if (preg_match('/^[a-f0-9]{64}$/i', $value) === 1) {
+        // Internal manifest hashes (any HashScheme) are never valid provider event ids.
+        if (HashScheme::isDigest($value)) {
             return false;
         }
 
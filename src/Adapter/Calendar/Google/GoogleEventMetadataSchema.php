@@ -10,15 +10,21 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Adapter\Calendar\Google;
 
+use CalendarScheduler\Adapter\Calendar\PackedMetadata;
+
 /**
  * Canonical key registry for Google event private metadata.
  *
  * All calendar-side metadata keys used in extendedProperties.private
  * must be defined here to keep reads/writes versioned and consistent.
+ *
+ * Since VERSION 3 the keys are written packed into the single
+ * PackedMetadata::KEY entry; per-key (legacy) entries are still read, and the
+ * packed value wins where both exist.
  */
 final class GoogleEventMetadataSchema
 {
-    public const VERSION = '2';
+    public const VERSION = '3';
 
     public const KEY_MANIFEST_EVENT_ID = 'cs.manifestEventId';
     public const KEY_SUB_EVENT_HASH = 'cs.subEventHash';
@@ -37,6 +43,9 @@ final class GoogleEventMetadataSchema
     public const KEY_SYMBOLIC_END_OFFSET = 'cs.symbolicEndOffset';
     public const KEY_STYLE_TOKEN = 'cs.styleToken';
 
+    // Google rejects extended property values longer than this.
+    public const MAX_PROPERTY_VALUE_LENGTH = 1024;
+
     private function __construct()
     {
     }
@@ -107,12 +116,54 @@ final class GoogleEventMetadataSchema
         return $out;
     }
 
+    /**
+     * extendedProperties.private as written: privateMetadata() packed into
+     * one entry.
+     *
+     * @param array<string,string> $privateMetadata
+     * @return array<string,string>
+     * @throws \RuntimeException when the packed value exceeds MAX_PROPERTY_VALUE_LENGTH
+     */
+    public static function privateProperties(array $privateMetadata): array
+    {
+        $packed = PackedMetadata::pack($privateMetadata);
+        // Values are rawurlencoded ASCII, so bytes and characters agree.
+        if (strlen($packed) > self::MAX_PROPERTY_VALUE_LENGTH) {
+            throw new \RuntimeException(sprintf(
+                'Packed scheduler metadata for %s is %d characters; Google allows at most %d',
+                (string)($privateMetadata[self::KEY_MANIFEST_EVENT_ID] ?? 'event'),
+                strlen($packed),
+                self::MAX_PROPERTY_VALUE_LENGTH
+            ));
+        }
+
+        return [PackedMetadata::KEY => $packed];
+    }
+
+    /**
+     * The event's full cs.* map when it still carries per-key (legacy)
+     * entries, for ManagedMetadataMigration; null when it is packed only.
+     *
+     * @param array<string,mixed> $ev
+     * @return array<string,mixed>|null
+     */
+    public static function legacyPrivateMetadata(array $ev): ?array
+    {
+        $private = $ev['extendedProperties']['private'] ?? null;
+        if (!is_array($private) || PackedMetadata::legacyEntries($private) === []) {
+            return null;
+        }
+
+        return PackedMetadata::expand($private);
+    }
+
     /**
      * @param array<string,mixed> $private
      * @return array<string,mixed>
      */
     public static function decodePrivateMetadata(array $private): array
     {
+        $private = PackedMetadata::expand($private);
         $manifestEventId = self::readString($private, self::KEY_MANIFEST_EVENT_ID);
         $subEventHash = self::readString($private, self::KEY_SUB_EVENT_HASH);
         $provider = self::readString($private, self::KEY_PROVIDER);
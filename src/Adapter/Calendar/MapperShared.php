@@ -4,7 +4,8 @@ declare(strict_types=1);
 namespace CalendarScheduler\Adapter\Calendar;
 
 use CalendarScheduler\Platform\HolidayResolver;
-use CalendarScheduler\Platform\SunTimeDisplayEstimator;
+use CalendarScheduler\Platform\HolidayTableCache;
+use CalendarScheduler\Platform\SunTimeTable;
 
 final class MapperShared
 {
@@ -40,6 +41,25 @@ final class MapperShared
         return null;
     }
 
+    /**
+     * Calendar a manifest event is written to: the synced calendar its
+     * correlation names, or the primary (first) calendar when it names none.
+     * Null when it names a calendar that is not configured (any more); such
+     * an event must not be rerouted into another calendar.
+     *
+     * @param array<string,mixed> $event
+     * @param array<int,string> $calendarIds primary first
+     */
+    public static function targetCalendarId(array $event, array $calendarIds): ?string
+    {
+        $sourceCalendarId = $event['correlation']['sourceCalendarId'] ?? null;
+        if (!is_string($sourceCalendarId) || trim($sourceCalendarId) === '') {
+            return $calendarIds[0];
+        }
+
+        return in_array(trim($sourceCalendarId), $calendarIds, true) ? trim($sourceCalendarId) : null;
+    }
+
     public static function extractYearFromHardDate(?string $date): ?int
     {
         if (!is_string($date) || $date === '') {
@@ -83,7 +103,7 @@ final class MapperShared
             return null;
         }
 
-        return new HolidayResolver($holidays);
+        return (new HolidayTableCache())->resolver($holidays);
     }
 
     /**
@@ -119,15 +139,8 @@ final class MapperShared
         }
 
         if ($latitude !== null && $longitude !== null) {
-            $estimated = SunTimeDisplayEstimator::estimate(
-                $date,
-                $symbolic,
-                $latitude,
-                $longitude,
-                $timezoneName,
-                $offset,
-                30
-            );
+            $estimated = SunTimeTable::for($latitude, $longitude, $timezoneName)
+                ->displayTime($date, $symbolic, $offset, 30);
             if (is_string($estimated) && $estimated !== '') {
                 return $estimated;
             }
@@ -313,6 +326,45 @@ final class MapperShared
         return implode("\n\n", $sections);
     }
 
+    /**
+     * Minimal PATCH body that turns the $current provider payload into
+     * $desired: top-level fields whose value differs (nested objects are sent
+     * whole) plus null for fields the desired payload no longer carries.
+     *
+     * @param array<string,mixed> $current
+     * @param array<string,mixed> $desired
+     * @return array<string,mixed>
+     */
+    public static function payloadPatch(array $current, array $desired): array
+    {
+        $patch = [];
+        foreach ($desired as $field => $value) {
+            if (
+                !array_key_exists($field, $current)
+                || self::canonicalPayloadValue($current[$field]) !== self::canonicalPayloadValue($value)
+            ) {
+                $patch[$field] = $value;
+            }
+        }
+        foreach ($current as $field => $_) {
+            if (!array_key_exists($field, $desired)) {
+                $patch[$field] = null;
+            }
+        }
+
+        return $patch;
+    }
+
+    /**
+     * Recurring vs single is a provider event shape; it cannot be patched.
+     *
+     * @param array<string,mixed> $payload
+     */
+    public static function isRecurringPayload(array $payload): bool
+    {
+        return !empty($payload['recurrence']);
+    }
+
     public static function stripManagedSections(string $description): string
     {
         $divider = '# -------------------- USER NOTES BELOW --------------------';
@@ -441,6 +493,23 @@ final class MapperShared
         return null;
     }
 
+    /**
+     * Key-order-insensitive form of a payload value for equality checks.
+     */
+    private static function canonicalPayloadValue(mixed $value): mixed
+    {
+        if (!is_array($value)) {
+            return $value;
+        }
+        if (!array_is_list($value)) {
+            ksort($value);
+        }
+        foreach ($value as $k => $v) {
+            $value[$k] = self::canonicalPayloadValue($v);
+        }
+        return $value;
+    }
+
     /**
      * @return array<string,mixed>
      */
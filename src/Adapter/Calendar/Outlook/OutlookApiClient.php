@@ -10,13 +10,22 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Adapter\Calendar\Outlook;
 
+use CalendarScheduler\Platform\Trace;
+
 final class OutlookApiClient
 {
-    private const GRAPH_BASE = 'https://graph.microsoft.com/v1.0';
+    // Graph JSON batching accepts at most 20 requests per $batch call.
+    public const BATCH_MAX_REQUESTS = 20;
+    private const BATCH_MIN_INTERVAL_MS = 250;
+    private const BATCH_MAX_ATTEMPTS = 5;
+    private const BATCH_MAX_BACKOFF_SECONDS = 32;
+    private const REQUEST_MAX_ATTEMPTS = 4;
+    private const REQUEST_MAX_BACKOFF_SECONDS = 8;
 
     private OutlookConfig $config;
     private bool $debugCalendar;
     private int $deleteSkippedAlreadyAbsent = 0;
+    private float $lastBatchAt = 0.0;
 
     public function __construct(OutlookConfig $config)
     {
@@ -83,6 +92,122 @@ final class OutlookApiClient
         );
     }
 
+    /**
+     * PATCH many events through Graph JSON batching.
+     *
+     * Requests are sent in chunks of BATCH_MAX_REQUESTS with a minimum spacing
+     * between batches. Sub-requests throttled with 429/503 are retried using
+     * the per-response Retry-After header or exponential backoff.
+     *
+     * @param array<string,array<string,mixed>> $payloadsByEventId
+     * @param callable(int,int):void|null $onBatch Receives (done, total) after each batch
+     * @return array<string,string> Failure messages keyed by eventId (empty on full success)
+     */
+    public function batchUpdateEvents(string $calendarId, array $payloadsByEventId, ?callable $onBatch = null): array
+    {
+        if ($payloadsByEventId === []) {
+            return [];
+        }
+
+        $this->ensureAuthenticated();
+
+        $total = count($payloadsByEventId);
+        $done = 0;
+        $failures = [];
+        $pending = $payloadsByEventId;
+
+        for ($attempt = 1; $pending !== []; $attempt++) {
+            $retry = [];
+            $retryAfter = 0;
+
+            foreach (array_chunk($pending, self::BATCH_MAX_REQUESTS, true) as $chunk) {
+                $this->throttleBatch();
+
+                $requests = [];
+                $eventIdByRequestId = [];
+                foreach ($chunk as $eventId => $payload) {
+                    $requestId = (string)(count($requests) + 1);
+                    $eventIdByRequestId[$requestId] = (string)$eventId;
+                    $requests[] = [
+                        'id' => $requestId,
+                        'method' => 'PATCH',
+                        'url' => $this->eventPath($calendarId, (string)$eventId),
+                        'headers' => ['Content-Type' => 'application/json'],
+                        'body' => $payload,
+                    ];
+                }
+
+                $res = $this->requestJson('POST', '/$batch', ['requests' => $requests]);
+                $responsesById = [];
+                foreach (is_array($res['responses'] ?? null) ? $res['responses'] : [] as $response) {
+                    if (is_array($response) && isset($response['id'])) {
+                        $responsesById[(string)$response['id']] = $response;
+                    }
+                }
+
+                foreach ($eventIdByRequestId as $requestId => $eventId) {
+                    $response = $responsesById[$requestId] ?? [];
+                    $status = (int)($response['status'] ?? 0);
+
+                    if ($status >= 200 && $status < 300) {
+                        $done++;
+                        continue;
+                    }
+
+                    if ($attempt < self::BATCH_MAX_ATTEMPTS && in_array($status, [429, 500, 503, 504], true)) {
+                        $retry[$eventId] = $chunk[$eventId];
+                        $headers = is_array($response['headers'] ?? null) ? $response['headers'] : [];
+                        $retryAfter = max($retryAfter, (int)($headers['Retry-After'] ?? $headers['retry-after'] ?? 0));
+                        continue;
+                    }
+
+                    $message = $response['body']['error']['message'] ?? 'missing batch response';
+                    $failures[$eventId] = "HTTP {$status}: " . (is_string($message) ? $message : 'unknown');
+                    $done++;
+                }
+
+                if ($onBatch !== null) {
+                    $onBatch($done, $total);
+                }
+            }
+
+            if ($retry !== []) {
+                $backoff = min(self::BATCH_MAX_BACKOFF_SECONDS, 2 ** $attempt);
+                sleep(max($retryAfter, $backoff));
+            }
+            $pending = $retry;
+        }
+
+        return $failures;
+    }
+
+    /**
+     * Fetch one event with its scheduler metadata properties expanded; null
+     * when it no longer exists (HTTP 404/410).
+     *
+     * @return array<string,mixed>|null Raw Graph event resource
+     */
+    public function getEvent(string $calendarId, string $eventId): ?array
+    {
+        $this->ensureAuthenticated();
+
+        $query = http_build_query(
+            ['$expand' => OutlookEventMetadataSchema::graphExpandQuery()],
+            '',
+            '&',
+            PHP_QUERY_RFC3986
+        );
+        try {
+            return $this->requestJson('GET', $this->eventPath($calendarId, $eventId) . '?' . $query, null);
+        } catch (\RuntimeException $e) {
+            $message = $e->getMessage();
+            if (strpos($message, 'HTTP 404') !== false || strpos($message, 'HTTP 410') !== false) {
+                return null;
+            }
+            throw $e;
+        }
+    }
+
     public function deleteEvent(string $calendarId, string $eventId): void
     {
         $this->ensureAuthenticated();
@@ -193,14 +318,34 @@ final class OutlookApiClient
      * @return array<int,array<string,mixed>>
      */
     public function listEvents(string $calendarId, array $params = []): array
+    {
+        return iterator_to_array($this->streamEvents($calendarId, $params), false);
+    }
+
+    /**
+     * Yield raw events page by page, following @odata.nextLink.
+     * Only the page being consumed is held in memory; this bounds raw events
+     * only, the translator still collects every translated row.
+     *
+     * @param array<string,mixed> $params
+     * @return \Generator<int,array<string,mixed>>
+     */
+    public function streamEvents(string $calendarId, array $params = []): \Generator
     {
         $this->ensureAuthenticated();
 
-        $allItems = [];
+        // Bound the listing to the sync horizon. Series masters carry their
+        // first occurrence in start/end, so they are admitted by type and then
+        // checked against their recurrence range below.
+        $horizon = $this->config->getSyncHorizon();
+        $windowStart = $horizon->start()->format('Y-m-d\\TH:i:s');
+        $windowEnd = $horizon->end()->format('Y-m-d\\TH:i:s');
+        $horizonFiltered = !array_key_exists('$filter', $params);
 
         $baseParams = array_merge([
             '$top' => 1000,
             '$orderby' => 'lastModifiedDateTime asc',
+            '$filter' => "type eq 'seriesMaster' or (end/dateTime ge '{$windowStart}' and start/dateTime lt '{$windowEnd}')",
         ], $params);
         if (!isset($baseParams['$expand']) || !is_string($baseParams['$expand']) || trim((string)$baseParams['$expand']) === '') {
             $baseParams['$expand'] = OutlookEventMetadataSchema::graphExpandQuery();
@@ -211,18 +356,65 @@ final class OutlookApiClient
             $url .= '?' . http_build_query($baseParams, '', '&', PHP_QUERY_RFC3986);
         }
 
+        $page = 0;
         while ($url !== null) {
+            $page++;
+            Trace::begin('events page', 'provider', ['provider' => 'outlook', 'page' => $page]);
             $res = $this->requestJson('GET', $url, null);
-            $items = $res['value'] ?? null;
-            if (is_array($items)) {
-                $allItems = array_merge($allItems, $items);
-            }
-
             $next = $res['@odata.nextLink'] ?? null;
             $url = is_string($next) && $next !== '' ? $next : null;
+            $items = is_array($res['value'] ?? null) ? $res['value'] : [];
+            unset($res);
+            Trace::end(['items' => count($items)]);
+
+            foreach ($items as $item) {
+                if ($horizonFiltered && is_array($item) && !$this->intersectsSyncHorizon($item, $windowStart, $windowEnd)) {
+                    continue;
+                }
+                yield $item;
+            }
+            unset($items);
+        }
+    }
+
+    /**
+     * Client-side horizon guard: drops series masters whose recurrence range
+     * ended before the window (or starts after it) and single events the
+     * server filter did not already exclude.
+     *
+     * @param array<string,mixed> $item
+     */
+    private function intersectsSyncHorizon(array $item, string $windowStart, string $windowEnd): bool
+    {
+        if (($item['type'] ?? null) === 'seriesMaster') {
+            $range = is_array($item['recurrence']['range'] ?? null) ? $item['recurrence']['range'] : [];
+            $rangeStart = is_string($range['startDate'] ?? null) ? $range['startDate'] : '';
+            if ($rangeStart !== '' && $rangeStart >= substr($windowEnd, 0, 10)) {
+                return false;
+            }
+            $rangeEnd = is_string($range['endDate'] ?? null) ? $range['endDate'] : '';
+            if (($range['type'] ?? null) === 'endDate' && $rangeEnd !== '' && $rangeEnd < substr($windowStart, 0, 10)) {
+                return false;
+            }
+            return true;
         }
 
-        return $allItems;
+        $start = is_string($item['start']['dateTime'] ?? null) ? substr($item['start']['dateTime'], 0, 19) : '';
+        $end = is_string($item['end']['dateTime'] ?? null) ? substr($item['end']['dateTime'], 0, 19) : $start;
+        if ($start === '') {
+            return true;
+        }
+
+        return $end >= $windowStart && $start < $windowEnd;
+    }
+
+    private function throttleBatch(): void
+    {
+        $elapsedMs = (microtime(true) - $this->lastBatchAt) * 1000;
+        if ($this->lastBatchAt > 0 && $elapsedMs < self::BATCH_MIN_INTERVAL_MS) {
+            usleep((int)((self::BATCH_MIN_INTERVAL_MS - $elapsedMs) * 1000));
+        }
+        $this->lastBatchAt = microtime(true);
     }
 
     private function calendarBasePath(string $calendarId): string
@@ -348,6 +540,21 @@ final class OutlookApiClient
         ];
     }
 
+    /**
+     * Whether a single request may be sent again after $status. 429 means the
+     * request was rejected unprocessed, so any method may retry it. A 503 may
+     * come after the server acted, so it is only retried for idempotent
+     * methods: a retried POST could create the event twice.
+     */
+    public static function isRetryableRequest(string $method, int $status): bool
+    {
+        if ($status === 429) {
+            return true;
+        }
+
+        return $status === 503 && in_array(strtoupper($method), ['GET', 'PUT', 'PATCH', 'DELETE'], true);
+    }
+
     /**
      * @param array<string,mixed>|null $payload
      * @return array<string,mixed>
@@ -361,46 +568,70 @@ final class OutlookApiClient
 
         $url = str_starts_with($pathOrUrl, 'http://') || str_starts_with($pathOrUrl, 'https://')
             ? $pathOrUrl
-            : self::GRAPH_BASE . $pathOrUrl;
+            : $this->config->getGraphBaseUrl() . $pathOrUrl;
 
         if (!function_exists('curl_init')) {
             throw new \RuntimeException('cURL extension is required for Outlook API requests.');
         }
 
-        $ch = curl_init($url);
-        if ($ch === false) {
-            throw new \RuntimeException('Outlook API request failed: unable to initialize cURL.');
-        }
-
         $headers = [
             'Accept: application/json',
             'Authorization: Bearer ' . $token['access_token'],
         ];
 
-        curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
-        curl_setopt($ch, CURLOPT_CUSTOMREQUEST, strtoupper($method));
-        curl_setopt($ch, CURLOPT_TIMEOUT, 30);
-
+        $json = null;
         if ($payload !== null) {
             $json = json_encode($payload, JSON_UNESCAPED_SLASHES);
             if ($json === false) {
-                curl_close($ch);
                 throw new \RuntimeException('Unable to encode Outlook payload JSON.');
             }
             $headers[] = 'Content-Type: application/json';
-            curl_setopt($ch, CURLOPT_POSTFIELDS, $json);
         }
 
-        curl_setopt($ch, CURLOPT_HTTPHEADER, $headers);
+        // Throttled/unavailable requests are retried in place (see
+        // isRetryableRequest), honoring Retry-After when Graph sends one.
+        for ($attempt = 1; ; $attempt++) {
+            $ch = curl_init($url);
+            if ($ch === false) {
+                throw new \RuntimeException('Outlook API request failed: unable to initialize cURL.');
+            }
 
-        $raw = curl_exec($ch);
-        $errno = curl_errno($ch);
-        $err = curl_error($ch);
-        $code = (int) curl_getinfo($ch, CURLINFO_HTTP_CODE);
-        curl_close($ch);
+            $retryAfter = 0;
+            curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
+            curl_setopt($ch, CURLOPT_CUSTOMREQUEST, strtoupper($method));
+            curl_setopt($ch, CURLOPT_TIMEOUT, 30);
+            if ($json !== null) {
+                curl_setopt($ch, CURLOPT_POSTFIELDS, $json);
+            }
+            curl_setopt($ch, CURLOPT_HTTPHEADER, $headers);
+            curl_setopt(
+                $ch,
+                CURLOPT_HEADERFUNCTION,
+                static function ($handle, string $line) use (&$retryAfter): int {
+                    if (preg_match('/^Retry-After:\s*(\d+)/i', $line, $m)) {
+                        $retryAfter = (int)$m[1];
+                    }
+                    return strlen($line);
+                }
+            );
 
-        if ($raw === false || $errno !== 0) {
-            throw new \RuntimeException('Outlook API request failed: ' . $err);
+            $traceStart = Trace::now();
+            $raw = curl_exec($ch);
+            Trace::http($ch, $method . ' ' . explode('?', $pathOrUrl, 2)[0], $traceStart, ['method' => $method, 'attempt' => $attempt]);
+            $errno = curl_errno($ch);
+            $err = curl_error($ch);
+            $code = (int) curl_getinfo($ch, CURLINFO_HTTP_CODE);
+            curl_close($ch);
+
+            if ($raw === false || $errno !== 0) {
+                throw new \RuntimeException('Outlook API request failed: ' . $err);
+            }
+
+            if (self::isRetryableRequest($method, $code) && $attempt < self::REQUEST_MAX_ATTEMPTS) {
+                sleep(max($retryAfter, min(self::REQUEST_MAX_BACKOFF_SECONDS, 2 ** ($attempt - 1))));
+                continue;
+            }
+            break;
         }
 
         if ($code >= 200 && $code < 300) {
@@ -469,7 +700,9 @@ final class OutlookApiClient
         curl_setopt($ch, CURLOPT_HTTPHEADER, ['Content-Type: application/x-www-form-urlencoded']);
         curl_setopt($ch, CURLOPT_POSTFIELDS, http_build_query($form, '', '&', PHP_QUERY_RFC3986));
 
+        $traceStart = Trace::now();
         $raw = curl_exec($ch);
+        Trace::http($ch, $method . ' token', $traceStart, ['method' => $method]);
         $errno = curl_errno($ch);
         $err = curl_error($ch);
         $code = (int)curl_getinfo($ch, CURLINFO_HTTP_CODE);
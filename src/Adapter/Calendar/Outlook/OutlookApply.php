@@ -3,7 +3,10 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Adapter\Calendar\Outlook;
 
+use CalendarScheduler\Adapter\Calendar\CalendarMutationJournal;
 use CalendarScheduler\Diff\ReconciliationAction;
+use CalendarScheduler\Platform\ProcessPool;
+use CalendarScheduler\Platform\Trace;
 use RuntimeException;
 
 final class OutlookMutation
@@ -104,7 +107,11 @@ final class OutlookApplyExecutor
      * @param ReconciliationAction[] $actions
      * @return OutlookMutationResult[]
      */
-    public function applyActions(array $actions): array
+    public function applyActions(
+        array $actions,
+        ?CalendarMutationJournal $journal = null,
+        ?callable $onProgress = null
+    ): array
     {
         $mutations = [];
         foreach ($actions as $action) {
@@ -114,20 +121,113 @@ final class OutlookApplyExecutor
         }
 
         $this->mapper->emitDiagnosticsSummary();
-        $results = $this->apply($mutations);
+        $results = $this->applyPerCalendar($mutations, $journal, $onProgress);
         $this->client->emitDiagnosticsSummary();
         return $results;
     }
 
     /**
+     * Mutations of different calendars are independent, so with several
+     * synced calendars each calendar's mutations are sent by its own worker
+     * process; within a calendar the mapped order is kept. $onProgress keeps
+     * running in this process on every pool poll while the workers send (the
+     * counts only change when a calendar's worker finishes).
+     *
      * @param OutlookMutation[] $mutations
      * @return OutlookMutationResult[]
      */
-    public function apply(array $mutations): array
-    {
-        $results = [];
+    private function applyPerCalendar(
+        array $mutations,
+        ?CalendarMutationJournal $journal,
+        ?callable $onProgress
+    ): array {
+        $byCalendar = [];
         foreach ($mutations as $mutation) {
-            $results[] = $this->applyOne($mutation);
+            $byCalendar[$mutation->calendarId][] = $mutation;
+        }
+        if (count($byCalendar) < 2 || !ProcessPool::supported()) {
+            return $this->apply($mutations, $journal, $onProgress);
+        }
+
+        // Workers must not race each other to refresh the token.
+        $this->client->ensureAuthenticated();
+
+        $tasks = [];
+        foreach ($byCalendar as $calendarId => $calendarMutations) {
+            $tasks[(string)$calendarId] = fn (): array => $this->apply($calendarMutations, $journal);
+        }
+        $total = count($mutations);
+        $calendarSizes = array_map('count', $byCalendar);
+        $finished = (new ProcessPool(count($tasks)))->run(
+            $tasks,
+            static function (array $done) use ($onProgress, $calendarSizes, $total): void {
+                if ($onProgress !== null) {
+                    $onProgress(array_sum(array_intersect_key($calendarSizes, $done)), $total);
+                }
+            }
+        );
+        if ($onProgress !== null) {
+            $onProgress($total, $total);
+        }
+
+        return array_merge(...array_values($finished));
+    }
+
+    /**
+     * Mutations already acknowledged in the journal are not re-sent; their
+     * recorded provider event id is returned as the result instead.
+     * $onProgress($done, $total) runs before each mutation is sent and once at
+     * the end; acknowledged mutations count as done.
+     *
+     * @param OutlookMutation[] $mutations
+     * @return OutlookMutationResult[]
+     */
+    public function apply(
+        array $mutations,
+        ?CalendarMutationJournal $journal = null,
+        ?callable $onProgress = null
+    ): array {
+        $results = [];
+        $total = count($mutations);
+        foreach (array_values($mutations) as $done => $mutation) {
+            $recordedId = $journal?->acknowledged(
+                $mutation->op,
+                $mutation->manifestEventId,
+                $mutation->subEventHash,
+                $mutation->outlookEventId
+            );
+            if ($recordedId !== null) {
+                $results[] = new OutlookMutationResult(
+                    $mutation->op,
+                    $mutation->calendarId,
+                    $recordedId,
+                    $mutation->manifestEventId,
+                    $mutation->subEventHash
+                );
+                continue;
+            }
+
+            if ($onProgress !== null) {
+                $onProgress($done, $total);
+            }
+            Trace::begin('mutation ' . $mutation->op, 'apply', [
+                'manifestEventId' => $mutation->manifestEventId,
+                'subEventHash' => $mutation->subEventHash,
+                'providerEventId' => $mutation->outlookEventId,
+            ]);
+            $result = $this->applyOne($mutation);
+            Trace::end();
+            $journal?->acknowledge(
+                $mutation->op,
+                $mutation->manifestEventId,
+                $mutation->subEventHash,
+                $mutation->outlookEventId,
+                (string)$result->outlookEventId
+            );
+            $results[] = $result;
+        }
+        if ($onProgress !== null) {
+            $onProgress($total, $total);
         }
         return $results;
     }
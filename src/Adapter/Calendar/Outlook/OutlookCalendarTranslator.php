@@ -11,34 +11,57 @@ declare(strict_types=1);
 namespace CalendarScheduler\Adapter\Calendar\Outlook;
 
 use CalendarScheduler\Adapter\Calendar\MapperShared;
+use CalendarScheduler\Adapter\Calendar\TranslationCache;
 use CalendarScheduler\Adapter\Calendar\TranslatorShared;
+use CalendarScheduler\Platform\Trace;
 
 final class OutlookCalendarTranslator
 {
     private const MANAGED_FORMAT_VERSION = '2';
 
+    // Bump when translated rows change shape, so cached rows are rebuilt.
+    private const TRANSLATION_SCHEMA_VERSION = '2';
+
     private \DateTimeZone $localTimezone;
 
-    public function __construct()
-    {
+    public function __construct(
+        private readonly ?TranslationCache $cache = null
+    ) {
         $this->localTimezone = $this->resolveLocalTimezone();
     }
 
     /**
-     * @param array<int,array<string,mixed>> $outlookEvents
+     * @param iterable<int,array<string,mixed>> $outlookEvents
      * @return array<int,array<string,mixed>>
      */
-    public function ingest(array $outlookEvents, string $calendarId): array
+    public function ingest(iterable $outlookEvents, string $calendarId): array
     {
-        return $this->translateOutlookEvents($outlookEvents, $calendarId);
+        // Provider pages are fetched lazily, so they nest inside this span.
+        Trace::begin('translate', 'translator', ['provider' => 'outlook', 'calendarId' => $calendarId]);
+        $rows = $this->translateOutlookEvents($outlookEvents, $calendarId);
+        Trace::end(['rows' => count($rows), 'cachedRows' => $this->cache?->hits() ?? 0]);
+
+        return $rows;
     }
 
     /**
-     * @param array<int,array<string,mixed>> $outlookEvents
+     * Raw events are consumed one at a time, but translated rows are collected:
+     * a managed duplicate collapses into an earlier row, and the translation
+     * cache holds every row of the pass until save().
+     *
+     * @param iterable<int,array<string,mixed>> $outlookEvents
      * @return array<int,array<string,mixed>>
      */
-    public function translateOutlookEvents(array $outlookEvents, string $calendarId): array
+    public function translateOutlookEvents(iterable $outlookEvents, string $calendarId): array
     {
+        $this->cache?->begin(implode('|', [
+            'outlook',
+            self::TRANSLATION_SCHEMA_VERSION,
+            self::MANAGED_FORMAT_VERSION,
+            $this->localTimezone->getName(),
+            $calendarId,
+        ]));
+
         $out = [];
         /** @var array<string,int> $managedIndexByKey */
         $managedIndexByKey = [];
@@ -57,102 +80,20 @@ final class OutlookCalendarTranslator
                 continue;
             }
 
-            $id = is_string($ev['id'] ?? null) ? $ev['id'] : null;
-            $seriesMasterId = is_string($ev['seriesMasterId'] ?? null) ? $ev['seriesMasterId'] : null;
-            $subject = is_string($ev['subject'] ?? null) ? $ev['subject'] : '';
-
-            $bodyContent = null;
-            if (is_array($ev['body'] ?? null) && is_string($ev['body']['content'] ?? null)) {
-                $bodyContent = (string)$ev['body']['content'];
-            }
-            $preview = is_string($ev['bodyPreview'] ?? null) ? $ev['bodyPreview'] : null;
-            $description = $bodyContent;
-            if (!is_string($description) || trim($description) === '') {
-                $description = $preview;
-            }
-
-            $start = is_array($ev['start'] ?? null) ? $ev['start'] : [];
-            $end = is_array($ev['end'] ?? null) ? $ev['end'] : [];
-
-            $startDateTime = is_string($start['dateTime'] ?? null) ? trim((string)$start['dateTime']) : '';
-            $endDateTime = is_string($end['dateTime'] ?? null) ? trim((string)$end['dateTime']) : '';
-            $timeZone = is_string($start['timeZone'] ?? null) && trim((string)$start['timeZone']) !== ''
-                ? trim((string)$start['timeZone'])
-                : (is_string($end['timeZone'] ?? null) ? trim((string)$end['timeZone']) : null);
-            if ($timeZone === '') {
-                $timeZone = null;
-            }
-
-            $decodedMetadata = OutlookEventMetadataSchema::decodeFromOutlookEvent($ev);
-            $observedStyleToken = MapperShared::outlookCategoriesToStyleToken(
-                is_array($ev['categories'] ?? null) ? $ev['categories'] : []
-            );
-            if (is_string($observedStyleToken) && $observedStyleToken !== '') {
-                $decodedSettings = is_array($decodedMetadata['settings'] ?? null) ? $decodedMetadata['settings'] : [];
-                $decodedSettings['styleToken'] = $observedStyleToken;
-                $decodedMetadata['settings'] = $decodedSettings;
-            }
-
-            $schedulerMetadata = $this->reconcileSchedulerMetadata(
-                $decodedMetadata,
-                $subject,
-                $description
-            );
-
-            $metadataTimeZone = is_string($schedulerMetadata['timezone'] ?? null)
-                ? trim((string)$schedulerMetadata['timezone'])
-                : '';
-            if ($metadataTimeZone !== '') {
-                $effectiveSourceTimeZone = is_string($timeZone) && $timeZone !== '' ? $timeZone : 'UTC';
-                $startDateTime = $this->convertDateTimeTimezone($startDateTime, $effectiveSourceTimeZone, $metadataTimeZone);
-                $endDateTime = $this->convertDateTimeTimezone($endDateTime, $effectiveSourceTimeZone, $metadataTimeZone);
-                $timeZone = $metadataTimeZone;
-                if (is_array($start)) {
-                    $start['dateTime'] = $startDateTime;
-                    $start['timeZone'] = $metadataTimeZone;
-                }
-                if (is_array($end)) {
-                    $end['dateTime'] = $endDateTime;
-                    $end['timeZone'] = $metadataTimeZone;
+            // Unchanged events (same id + changeKey) reuse last run's translation.
+            $eventId = is_string($ev['id'] ?? null) ? $ev['id'] : '';
+            $changeKey = is_string($ev['changeKey'] ?? null)
+                ? $ev['changeKey']
+                : (is_string($ev['@odata.etag'] ?? null) ? $ev['@odata.etag'] : '');
+            $cacheable = $this->cache !== null && $eventId !== '' && $changeKey !== '';
+            $row = $cacheable ? $this->cache->get($eventId, $changeKey) : null;
+            if ($row === null) {
+                $row = $this->translateEventRow($ev, $calendarId, $type, $isCancelled);
+                if ($cacheable) {
+                    $this->cache->put($eventId, $changeKey, $row);
                 }
             }
 
-            [$rrule, $exDates] = $this->translateRecurrence($ev, $type, $timeZone);
-            $isOverride = ($type === 'exception' || $type === 'occurrence') && is_string($seriesMasterId) && $seriesMasterId !== '';
-            $parentUid = $isOverride ? $seriesMasterId : null;
-            $originalStartTime = $this->extractOriginalStartTime($ev, $timeZone);
-            $uid = $id;
-
-            $row = [
-                'provider' => 'outlook',
-                'calendar_id' => $calendarId,
-                'uid' => $uid,
-                'sourceEventUid' => $uid,
-                'summary' => $subject,
-                'description' => $description,
-                'status' => $isCancelled ? 'cancelled' : (is_string($ev['showAs'] ?? null) ? $ev['showAs'] : 'busy'),
-                'start' => $start,
-                'end' => $end,
-                'timezone' => $timeZone,
-                'isAllDay' => (bool)($ev['isAllDay'] ?? false),
-                'dtstart' => $startDateTime,
-                'dtend' => $endDateTime,
-                'rrule' => $rrule,
-                'exDates' => $exDates,
-                'parentUid' => $parentUid,
-                'originalStartTime' => $originalStartTime,
-                'isOverride' => $isOverride,
-                'payload' => [
-                    'summary' => $subject,
-                    'description' => $description,
-                    'status' => $isCancelled ? 'cancelled' : (is_string($ev['showAs'] ?? null) ? $ev['showAs'] : 'busy'),
-                    'rrule' => $rrule,
-                    'exDates' => $exDates,
-                    'metadata' => $schedulerMetadata,
-                ],
-                'provenance' => $this->buildProvenance($ev, $uid),
-            ];
-
             $managedKey = $this->managedDedupeKey($row);
             if ($managedKey === null) {
                 $out[] = $row;
@@ -166,15 +107,119 @@ final class OutlookCalendarTranslator
                 continue;
             }
 
-            $existing = $out[$existingIndex];
-            if ($this->preferManagedRow($existing, $row)) {
-                $out[$existingIndex] = $row;
-            }
+            $out[$existingIndex] = $this->collapseManagedRows($out[$existingIndex], $row);
         }
 
+        $this->cache?->save();
+
         return $out;
     }
 
+    /**
+     * Translate one Graph event resource into a CalendarEvent row.
+     *
+     * @param array<string,mixed> $ev
+     * @return array<string,mixed>
+     */
+    private function translateEventRow(array $ev, string $calendarId, string $type, bool $isCancelled): array
+    {
+        $id = is_string($ev['id'] ?? null) ? $ev['id'] : null;
+        $seriesMasterId = is_string($ev['seriesMasterId'] ?? null) ? $ev['seriesMasterId'] : null;
+        $subject = is_string($ev['subject'] ?? null) ? $ev['subject'] : '';
+
+        $bodyContent = null;
+        if (is_array($ev['body'] ?? null) && is_string($ev['body']['content'] ?? null)) {
+            $bodyContent = (string)$ev['body']['content'];
+        }
+        $preview = is_string($ev['bodyPreview'] ?? null) ? $ev['bodyPreview'] : null;
+        $description = $bodyContent;
+        if (!is_string($description) || trim($description) === '') {
+            $description = $preview;
+        }
+
+        $start = is_array($ev['start'] ?? null) ? $ev['start'] : [];
+        $end = is_array($ev['end'] ?? null) ? $ev['end'] : [];
+
+        $startDateTime = is_string($start['dateTime'] ?? null) ? trim((string)$start['dateTime']) : '';
+        $endDateTime = is_string($end['dateTime'] ?? null) ? trim((string)$end['dateTime']) : '';
+        $timeZone = is_string($start['timeZone'] ?? null) && trim((string)$start['timeZone']) !== ''
+            ? trim((string)$start['timeZone'])
+            : (is_string($end['timeZone'] ?? null) ? trim((string)$end['timeZone']) : null);
+        if ($timeZone === '') {
+            $timeZone = null;
+        }
+
+        $decodedMetadata = OutlookEventMetadataSchema::decodeFromOutlookEvent($ev);
+        $observedStyleToken = MapperShared::outlookCategoriesToStyleToken(
+            is_array($ev['categories'] ?? null) ? $ev['categories'] : []
+        );
+        if (is_string($observedStyleToken) && $observedStyleToken !== '') {
+            $decodedSettings = is_array($decodedMetadata['settings'] ?? null) ? $decodedMetadata['settings'] : [];
+            $decodedSettings['styleToken'] = $observedStyleToken;
+            $decodedMetadata['settings'] = $decodedSettings;
+        }
+
+        $schedulerMetadata = $this->reconcileSchedulerMetadata(
+            $decodedMetadata,
+            $subject,
+            $description
+        );
+
+        $metadataTimeZone = is_string($schedulerMetadata['timezone'] ?? null)
+            ? trim((string)$schedulerMetadata['timezone'])
+            : '';
+        if ($metadataTimeZone !== '') {
+            $effectiveSourceTimeZone = is_string($timeZone) && $timeZone !== '' ? $timeZone : 'UTC';
+            $startDateTime = $this->convertDateTimeTimezone($startDateTime, $effectiveSourceTimeZone, $metadataTimeZone);
+            $endDateTime = $this->convertDateTimeTimezone($endDateTime, $effectiveSourceTimeZone, $metadataTimeZone);
+            $timeZone = $metadataTimeZone;
+            if (is_array($start)) {
+                $start['dateTime'] = $startDateTime;
+                $start['timeZone'] = $metadataTimeZone;
+            }
+            if (is_array($end)) {
+                $end['dateTime'] = $endDateTime;
+                $end['timeZone'] = $metadataTimeZone;
+            }
+        }
+
+        [$rrule, $exDates] = $this->translateRecurrence($ev, $type, $timeZone);
+        $isOverride = ($type === 'exception' || $type === 'occurrence') && is_string($seriesMasterId) && $seriesMasterId !== '';
+        $parentUid = $isOverride ? $seriesMasterId : null;
+        $originalStartTime = $this->extractOriginalStartTime($ev, $timeZone);
+        $uid = $id;
+
+        return [
+            'provider' => 'outlook',
+            'calendar_id' => $calendarId,
+            'uid' => $uid,
+            'sourceEventUid' => $uid,
+            'summary' => $subject,
+            'description' => $description,
+            'status' => $isCancelled ? 'cancelled' : (is_string($ev['showAs'] ?? null) ? $ev['showAs'] : 'busy'),
+            'start' => $start,
+            'end' => $end,
+            'timezone' => $timeZone,
+            'isAllDay' => (bool)($ev['isAllDay'] ?? false),
+            'dtstart' => $startDateTime,
+            'dtend' => $endDateTime,
+            'rrule' => $rrule,
+            'exDates' => $exDates,
+            'parentUid' => $parentUid,
+            'originalStartTime' => $originalStartTime,
+            'isOverride' => $isOverride,
+            'payload' => [
+                'summary' => $subject,
+                'description' => $description,
+                'status' => $isCancelled ? 'cancelled' : (is_string($ev['showAs'] ?? null) ? $ev['showAs'] : 'busy'),
+                'rrule' => $rrule,
+                'exDates' => $exDates,
+                'metadata' => $schedulerMetadata,
+            ],
+            'provenance' => $this->buildProvenance($ev, $uid),
+        ];
+    }
+
     /**
      * Managed row dedupe key:
      * - Prefer manifestEventId + subEventHash when present (authoritative subevent identity).
@@ -205,6 +250,39 @@ final class OutlookCalendarTranslator
         return implode('::', [$manifestEventId, $dtstart, $dtend, $timezone, $type, $repeat, $stopType, $enabled]);
     }
 
+    /**
+     * Keep the preferred of two managed rows with the same dedupe key. The
+     * other one is listed in the kept row's provenance.duplicates (uid,
+     * observed categories, type and enabled), so a managed color reset still
+     * reaches it.
+     */
+    private function collapseManagedRows(array $existing, array $candidate): array
+    {
+        [$kept, $dropped] = $this->preferManagedRow($existing, $candidate)
+            ? [$candidate, $existing]
+            : [$existing, $candidate];
+
+        $duplicates = [];
+        foreach ([$kept, $dropped] as $row) {
+            foreach (is_array($row['provenance']['duplicates'] ?? null) ? $row['provenance']['duplicates'] : [] as $duplicate) {
+                $duplicates[] = $duplicate;
+            }
+        }
+        $uid = is_string($dropped['uid'] ?? null) ? $dropped['uid'] : '';
+        if ($uid !== '') {
+            $settings = $dropped['payload']['metadata']['settings'] ?? [];
+            $duplicates[] = [
+                'uid' => $uid,
+                'categories' => $dropped['provenance']['categories'] ?? null,
+                'type' => is_array($settings) ? ($settings['type'] ?? null) : null,
+                'enabled' => is_array($settings) ? ($settings['enabled'] ?? null) : null,
+            ];
+        }
+        $kept['provenance']['duplicates'] = $duplicates;
+
+        return $kept;
+    }
+
     private function preferManagedRow(array $current, array $candidate): bool
     {
         $currentScore = $this->managedRowScore($current);
@@ -259,6 +337,13 @@ final class OutlookCalendarTranslator
             'sequence' => null,
             'createdAtEpoch' => $this->isoToEpoch($ev['createdDateTime'] ?? null),
             'updatedAtEpoch' => $this->isoToEpoch($ev['lastModifiedDateTime'] ?? null),
+            // Observed provider categories are kept so managed-color reset can diff locally.
+            'categories' => array_values(array_filter(
+                is_array($ev['categories'] ?? null) ? $ev['categories'] : [],
+                static fn ($v): bool => is_string($v) && trim($v) !== ''
+            )),
+            // Per-key metadata still to be packed by ManagedMetadataMigration.
+            'legacyMetadata' => OutlookEventMetadataSchema::legacyPrivateMetadata($ev),
         ];
     }
 
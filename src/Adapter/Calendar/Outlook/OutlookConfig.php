@@ -10,12 +10,19 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Adapter\Calendar\Outlook;
 
+use CalendarScheduler\Adapter\Calendar\SyncHorizon;
+
 final class OutlookConfig
 {
+    private const DEFAULT_GRAPH_BASE_URL = 'https://graph.microsoft.com/v1.0';
+
     private string $calendarId;
+    /** @var array<int,string> */
+    private array $calendarIds;
     private string $configPath;
     /** @var array<string,mixed> */
     private array $data;
+    private ?SyncHorizon $syncHorizon = null;
 
     public function __construct(string $configPath)
     {
@@ -40,6 +47,15 @@ final class OutlookConfig
             $calendarId = 'primary';
         }
         $this->calendarId = trim($calendarId);
+
+        // Additional calendars synced alongside the primary one (fan-out).
+        $calendarIds = [$this->calendarId];
+        foreach (is_array($data['calendar_ids'] ?? null) ? $data['calendar_ids'] : [] as $extra) {
+            if (is_string($extra) && trim($extra) !== '' && !in_array(trim($extra), $calendarIds, true)) {
+                $calendarIds[] = trim($extra);
+            }
+        }
+        $this->calendarIds = $calendarIds;
     }
 
     public function getCalendarId(): string
@@ -47,6 +63,16 @@ final class OutlookConfig
         return $this->calendarId;
     }
 
+    /**
+     * Every synced calendar, primary first. More than one enables fan-out.
+     *
+     * @return array<int,string>
+     */
+    public function getCalendarIds(): array
+    {
+        return $this->calendarIds;
+    }
+
     public function getConfigDir(): string
     {
         return dirname($this->configPath);
@@ -84,4 +110,32 @@ final class OutlookConfig
             . DIRECTORY_SEPARATOR
             . $tokenFile;
     }
+
+    /**
+     * Graph v1.0 base URL.
+     * CS_OUTLOOK_GRAPH_BASE (or config graph_base_url) points the client at a local stand-in.
+     */
+    public function getGraphBaseUrl(): string
+    {
+        $override = getenv('CS_OUTLOOK_GRAPH_BASE');
+        if (is_string($override) && trim($override) !== '') {
+            return rtrim(trim($override), '/');
+        }
+
+        $configured = $this->data['graph_base_url'] ?? null;
+        if (is_string($configured) && trim($configured) !== '') {
+            return rtrim(trim($configured), '/');
+        }
+
+        return self::DEFAULT_GRAPH_BASE_URL;
+    }
+
+    /**
+     * Rolling fetch window (sync_horizon_days_back / sync_horizon_days_forward).
+     * Memoized so listing and the snapshot wrapper agree on the same bounds.
+     */
+    public function getSyncHorizon(): SyncHorizon
+    {
+        return $this->syncHorizon ??= SyncHorizon::fromConfig($this->data);
+    }
 }
@@ -12,6 +12,7 @@ namespace CalendarScheduler\Adapter\Calendar\Outlook;
 
 use CalendarScheduler\Adapter\Calendar\MapperShared;
 use CalendarScheduler\Diff\ReconciliationAction;
+use CalendarScheduler\Platform\HashScheme;
 use CalendarScheduler\Platform\HolidayResolver;
 
 final class OutlookEventMapper
@@ -29,6 +30,7 @@ final class OutlookEventMapper
         'unmappable_skipped' => 0,
         'delete_missing_id' => 0,
         'update_missing_id_skipped' => 0,
+        'update_replaced' => 0,
     ];
 
     public function __construct()
@@ -54,7 +56,15 @@ final class OutlookEventMapper
             throw new \RuntimeException('OutlookEventMapper: action missing subEvents');
         }
 
-        $calendarId = $config->getCalendarId();
+        $calendarId = MapperShared::targetCalendarId($event, $config->getCalendarIds());
+        if ($calendarId === null) {
+            error_log(
+                'OutlookEventMapper: skipping action for a calendar that is not synced '
+                . 'identityHash=' . $action->identityHash
+                . ' sourceCalendarId=' . (string)($event['correlation']['sourceCalendarId'] ?? '')
+            );
+            return [];
+        }
 
         return match ($action->type) {
             ReconciliationAction::TYPE_CREATE => $this->mapCreate($action, $subEvents, $calendarId),
@@ -74,11 +84,13 @@ final class OutlookEventMapper
             $this->diagnostics['unmappable_skipped'] > 0
             || $this->diagnostics['delete_missing_id'] > 0
             || $this->diagnostics['update_missing_id_skipped'] > 0
+            || $this->diagnostics['update_replaced'] > 0
         ) {
             error_log(
                 'OutlookEventMapper summary: unmappable_skipped=' . $this->diagnostics['unmappable_skipped']
                 . ' delete_missing_id=' . $this->diagnostics['delete_missing_id']
                 . ' update_missing_id_skipped=' . $this->diagnostics['update_missing_id_skipped']
+                . ' update_replaced=' . $this->diagnostics['update_replaced']
             );
         }
 
@@ -86,6 +98,7 @@ final class OutlookEventMapper
             'unmappable_skipped' => 0,
             'delete_missing_id' => 0,
             'update_missing_id_skipped' => 0,
+            'update_replaced' => 0,
         ];
     }
 
@@ -130,11 +143,16 @@ final class OutlookEventMapper
     }
 
     /**
+     * Updates are PATCHed in place. When the current provider state of the
+     * event is known, only changed fields are sent; a recurring <-> single
+     * shape change cannot be patched and is sent as delete + create.
+     *
      * @param array<int,array<string,mixed>> $subEvents
      * @return list<OutlookMutation>
      */
     private function mapUpdate(ReconciliationAction $action, array $subEvents, string $calendarId): array
     {
+        $currentPayloads = $this->currentPayloadsByEventId($action);
         $mutations = [];
         foreach ($subEvents as $subEvent) {
             if (!is_array($subEvent)) {
@@ -168,6 +186,35 @@ final class OutlookEventMapper
                 continue;
             }
 
+            $current = $currentPayloads[$eventId] ?? null;
+            if ($current !== null) {
+                if (MapperShared::isRecurringPayload($current) !== MapperShared::isRecurringPayload($payload)) {
+                    $this->diagnostics['update_replaced']++;
+                    $mutations[] = new OutlookMutation(
+                        op: OutlookMutation::OP_DELETE,
+                        calendarId: $calendarId,
+                        outlookEventId: $eventId,
+                        payload: [],
+                        manifestEventId: $action->identityHash,
+                        subEventHash: 'delete:' . $eventId
+                    );
+                    $mutations[] = new OutlookMutation(
+                        op: OutlookMutation::OP_CREATE,
+                        calendarId: $calendarId,
+                        outlookEventId: null,
+                        payload: $payload,
+                        manifestEventId: $action->identityHash,
+                        subEventHash: $subEventHash
+                    );
+                    continue;
+                }
+
+                $payload = MapperShared::payloadPatch($current, $payload);
+                if ($payload === []) {
+                    continue;
+                }
+            }
+
             $mutations[] = new OutlookMutation(
                 op: OutlookMutation::OP_UPDATE,
                 calendarId: $calendarId,
@@ -881,6 +928,9 @@ final class OutlookEventMapper
         if (is_string($stateHash) && $stateHash !== '') {
             return $stateHash;
         }
+        if (HashScheme::active() !== HashScheme::SHA256_JSON) {
+            return HashScheme::digest($subEvent);
+        }
 
         $encoded = json_encode($subEvent, JSON_UNESCAPED_SLASHES);
         if (!is_string($encoded)) {
@@ -890,6 +940,56 @@ final class OutlookEventMapper
         return hash('sha256', $encoded);
     }
 
+    /**
+     * Payloads of the current provider-side event keyed by Outlook event id.
+     * Ids shared by several current SubEvents are ambiguous and left out.
+     *
+     * @return array<string,array<string,mixed>>
+     */
+    private function currentPayloadsByEventId(ReconciliationAction $action): array
+    {
+        $currentEvent = $action->currentEvent;
+        $currentSubEvents = is_array($currentEvent['subEvents'] ?? null) ? $currentEvent['subEvents'] : [];
+        if ($currentSubEvents === []) {
+            return [];
+        }
+
+        $currentAction = new ReconciliationAction(
+            $action->type,
+            $action->target,
+            $action->authority,
+            $action->identityHash,
+            $action->reason,
+            $currentEvent
+        );
+        $payloads = [];
+        $ambiguous = [];
+        foreach ($currentSubEvents as $currentSubEvent) {
+            if (!is_array($currentSubEvent)) {
+                continue;
+            }
+            $eventId = $this->resolveOutlookEventId(
+                $currentAction,
+                $currentSubEvent,
+                $this->deriveSubEventHash($currentSubEvent)
+            );
+            if ($eventId === null) {
+                continue;
+            }
+            if (isset($payloads[$eventId]) || isset($ambiguous[$eventId])) {
+                $ambiguous[$eventId] = true;
+                continue;
+            }
+            try {
+                $payloads[$eventId] = $this->buildPayload($currentAction, $currentSubEvent);
+            } catch (\RuntimeException) {
+                $ambiguous[$eventId] = true;
+            }
+        }
+
+        return array_diff_key($payloads, $ambiguous);
+    }
+
     /**
      * @param array<string,mixed> $subEvent
      */
@@ -936,8 +1036,8 @@ final class OutlookEventMapper
             return false;
         }
 
-        // Internal manifest identity hashes are sha256 and are never valid Graph event ids.
-        if (preg_match('/^[a-f0-9]{64}$/i', $value) === 1) {
+        // Internal manifest hashes (any HashScheme) are never valid provider event ids.
+        if (HashScheme::isDigest($value)) {
             return false;
         }
 
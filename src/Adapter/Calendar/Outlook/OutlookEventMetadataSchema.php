@@ -10,9 +10,18 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Adapter\Calendar\Outlook;
 
+use CalendarScheduler\Adapter\Calendar\PackedMetadata;
+
+/**
+ * Since VERSION 3 the keys are written packed into one extended property
+ * (PackedMetadata::KEY). Per-key (legacy) properties are still read until a
+ * calendar's managed events are migrated, and the packed value wins where
+ * both exist. Graph cannot remove extended properties, so migrated events
+ * keep their legacy properties; they are simply no longer expanded.
+ */
 final class OutlookEventMetadataSchema
 {
-    public const VERSION = '2';
+    public const VERSION = '3';
     public const EXTENDED_PROPERTY_SET_GUID = '00020329-0000-0000-C000-000000000046';
 
     public const KEY_MANIFEST_EVENT_ID = 'cs.manifestEventId';
@@ -140,27 +149,25 @@ final class OutlookEventMetadataSchema
      */
     public static function toSingleValueExtendedProperties(array $privateMetadata): array
     {
-        $out = [];
-        foreach ($privateMetadata as $key => $value) {
-            if (!is_string($key) || !str_starts_with($key, 'cs.')) {
-                continue;
-            }
-            if (!is_string($value)) {
-                continue;
-            }
-            $out[] = [
-                'id' => self::graphPropertyId($key),
-                'value' => $value,
-            ];
-        }
-
-        return $out;
+        return [[
+            'id' => self::graphPropertyId(PackedMetadata::KEY),
+            'value' => PackedMetadata::pack($privateMetadata),
+        ]];
     }
 
-    public static function graphExpandQuery(): string
+    /**
+     * @param bool $includeLegacy also expand the per-key properties (needed
+     *                            until the calendar's events are migrated)
+     */
+    public static function graphExpandQuery(bool $includeLegacy = true): string
     {
+        $ids = [self::graphPropertyId(PackedMetadata::KEY)];
+        if ($includeLegacy) {
+            $ids = array_merge($ids, self::graphPropertyIds());
+        }
+
         $predicates = [];
-        foreach (self::graphPropertyIds() as $id) {
+        foreach ($ids as $id) {
             $escaped = str_replace("'", "''", $id);
             $predicates[] = "id eq '{$escaped}'";
         }
@@ -168,12 +175,30 @@ final class OutlookEventMetadataSchema
         return 'singleValueExtendedProperties($filter=' . implode(' or ', $predicates) . ')';
     }
 
+    /**
+     * The event's full cs.* map when it has per-key (legacy) properties but no
+     * packed one, for ManagedMetadataMigration; null otherwise.
+     *
+     * @param array<string,mixed> $ev
+     * @return array<string,string>|null
+     */
+    public static function legacyPrivateMetadata(array $ev): ?array
+    {
+        $private = self::extractPrivateMapFromExtendedProperties($ev);
+        if ($private === [] || isset($private[PackedMetadata::KEY])) {
+            return null;
+        }
+
+        return $private;
+    }
+
     /**
      * @param array<string,mixed> $private
      * @return array<string,mixed>
      */
     public static function decodePrivateMetadata(array $private): array
     {
+        $private = PackedMetadata::expand($private);
         $settings = [];
 
         $type = self::readString($private, self::KEY_TYPE);
@@ -23,6 +23,14 @@ final class OverrideIntent
     public bool $enabled = true;
     public ?string $stopType = null;
 
+    /**
+     * Provider event id + snapshot row index of the override row (see
+     * SnapshotEvent::$sourceRefs); set by CalendarSnapshot.
+     *
+     * @var array{uid:string,row:int}|null
+     */
+    public ?array $sourceRef = null;
+
     /**
      * @param array $row Translated calendar provider row
      */
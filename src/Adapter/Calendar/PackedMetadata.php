@@ -0,0 +1,193 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Adapter/Calendar/PackedMetadata.php
+ * Purpose: Versioned single-value encoding of the scheduler's cs.* event
+ * metadata, shared by the Google and Outlook metadata schemas.
+ */
+
+namespace CalendarScheduler\Adapter\Calendar;
+
+/**
+ * PackedMetadata
+ *
+ * Scheduler metadata used to be written as one provider property per cs.*
+ * key (Google extendedProperties.private entries, Outlook single-value
+ * extended properties). It is now written as one property, KEY, holding:
+ *
+ *   <version>;<code>=<value>;<code>=<value>...
+ *
+ * Codes are the short names below; a key without a code is written under its
+ * full cs.* name. Values are rawurlencoded, so ';' and '=' never need
+ * escaping. unpack() returns exactly the cs.* map that was packed, so the
+ * schemas decode packed and legacy (per-key) events the same way.
+ *
+ * An unknown version unpacks to nothing; readers then fall back to the legacy
+ * keys, if any.
+ */
+final class PackedMetadata
+{
+    public const KEY = 'cs.meta';
+    public const VERSION = '1';
+
+    // Legacy keys are read again once the horizon has moved this far past the
+    // range the migration last checked, so the migration can re-verify it.
+    private const RETIRED_RECHECK_DAYS = 30;
+
+    /** @var array<string,string> cs.* key => code */
+    private const CODES = [
+        'cs.manifestEventId' => 'm',
+        'cs.subEventHash' => 'h',
+        'cs.provider' => 'p',
+        'cs.schemaVersion' => 'v',
+        'cs.formatVersion' => 'f',
+        'cs.type' => 't',
+        'cs.enabled' => 'e',
+        'cs.repeat' => 'r',
+        'cs.stopType' => 's',
+        'cs.executionOrder' => 'o',
+        'cs.executionOrderManual' => 'om',
+        'cs.symbolicStart' => 'ss',
+        'cs.symbolicStartOffset' => 'so',
+        'cs.symbolicEnd' => 'se',
+        'cs.symbolicEndOffset' => 'eo',
+        'cs.timezone' => 'z',
+        'cs.styleToken' => 'c',
+    ];
+
+    private function __construct()
+    {
+    }
+
+    /**
+     * @param array<string,mixed> $privateMetadata cs.* key => string value
+     */
+    public static function pack(array $privateMetadata): string
+    {
+        $parts = [self::VERSION];
+        foreach ($privateMetadata as $key => $value) {
+            if (!is_string($key) || $key === self::KEY || !str_starts_with($key, 'cs.') || !is_string($value)) {
+                continue;
+            }
+            $parts[] = (self::CODES[$key] ?? $key) . '=' . rawurlencode($value);
+        }
+
+        return implode(';', $parts);
+    }
+
+    /**
+     * @return array<string,string> cs.* key => value ([] for an unknown version)
+     */
+    public static function unpack(string $packed): array
+    {
+        $parts = explode(';', trim($packed));
+        if (array_shift($parts) !== self::VERSION) {
+            return [];
+        }
+
+        static $keysByCode = null;
+        $keysByCode ??= array_flip(self::CODES);
+
+        $out = [];
+        foreach ($parts as $part) {
+            $eq = strpos($part, '=');
+            if ($eq === false || $eq === 0) {
+                continue;
+            }
+            $code = substr($part, 0, $eq);
+            $key = $keysByCode[$code] ?? (str_starts_with($code, 'cs.') ? $code : null);
+            if ($key !== null) {
+                $out[$key] = rawurldecode(substr($part, $eq + 1));
+            }
+        }
+
+        return $out;
+    }
+
+    /**
+     * Merge a packed value found in a cs.* map over its per-key (legacy)
+     * entries; the packed value wins.
+     *
+     * @param array<string,mixed> $private
+     * @return array<string,mixed>
+     */
+    public static function expand(array $private): array
+    {
+        $packed = $private[self::KEY] ?? null;
+        unset($private[self::KEY]);
+        if (!is_string($packed) || $packed === '') {
+            return $private;
+        }
+
+        return array_merge($private, self::unpack($packed));
+    }
+
+    /**
+     * Per-key (legacy) cs.* entries of a provider property map.
+     *
+     * @param array<string,mixed> $private
+     * @return array<string,mixed>
+     */
+    public static function legacyEntries(array $private): array
+    {
+        $out = [];
+        foreach ($private as $key => $value) {
+            if (is_string($key) && $key !== self::KEY && str_starts_with($key, 'cs.')) {
+                $out[$key] = $value;
+            }
+        }
+
+        return $out;
+    }
+
+    /**
+     * Marker written once a calendar holds no more legacy-encoded managed
+     * events, next to the calendar snapshot (see ManagedMetadataMigration).
+     */
+    public static function migratedMarkerPath(string $directory, string $provider, string $calendarId): string
+    {
+        return rtrim($directory, '/') . '/metadata-migrated-' . $provider . '-'
+            . substr(hash('sha256', $calendarId), 0, 16) . '.json';
+    }
+
+    /**
+     * True when the marker shows no legacy-encoded managed events up to
+     * (nearly) $horizonEnd, i.e. legacy keys need not be read for the calendar.
+     */
+    public static function legacyRetired(string $markerPath, \DateTimeInterface $horizonEnd): bool
+    {
+        $raw = is_file($markerPath) ? @file_get_contents($markerPath) : false;
+        $decoded = is_string($raw) && $raw !== '' ? json_decode($raw, true) : null;
+        if (!is_array($decoded) || ($decoded['version'] ?? null) !== self::VERSION) {
+            return false;
+        }
+
+        $coveredUntil = is_string($decoded['coveredUntil'] ?? null) ? strtotime($decoded['coveredUntil']) : false;
+        return $coveredUntil !== false
+            && $coveredUntil + self::RETIRED_RECHECK_DAYS * 86400 >= $horizonEnd->getTimestamp();
+    }
+
+    /**
+     * Record that no legacy-encoded managed events exist up to $coveredUntil
+     * (the end of the horizon that was checked). Failures are non-fatal.
+     */
+    public static function writeMigratedMarker(string $markerPath, string $coveredUntil): void
+    {
+        $json = json_encode([
+            'version' => self::VERSION,
+            'coveredUntil' => $coveredUntil,
+            'writtenAt' => gmdate(DATE_ATOM),
+        ], JSON_UNESCAPED_SLASHES);
+        if (!is_string($json)) {
+            return;
+        }
+
+        $tmp = $markerPath . '.' . getmypid() . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $markerPath)) {
+            @unlink($tmp);
+        }
+    }
+}
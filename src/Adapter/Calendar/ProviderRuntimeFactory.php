@@ -7,6 +7,7 @@ use CalendarScheduler\Adapter\Calendar\Google\GoogleApiClient;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleApplyExecutor;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleConfig;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleEventMapper;
+use CalendarScheduler\Adapter\Calendar\Google\GoogleEventMetadataSchema;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleMutation;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleMutationResult;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleCalendarTranslator;
@@ -14,26 +15,80 @@ use CalendarScheduler\Adapter\Calendar\Outlook\OutlookApiClient;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookApplyExecutor;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookCalendarTranslator;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookConfig;
+use CalendarScheduler\Adapter\Calendar\Outlook\OutlookEventMetadataSchema;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookEventMapper;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookMutation;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookMutationResult;
 
 final class ProviderRuntimeFactory
 {
-    public static function createSnapshot(string $provider): ProviderSnapshotRuntime
+    /**
+     * Configured calendars for the provider, primary first.
+     *
+     * @return array<int,string>
+     */
+    public static function calendarIds(string $provider): array
     {
+        return self::normalizeProvider($provider) === 'outlook'
+            ? (new OutlookConfig('/home/fpp/media/config/calendar-scheduler/calendar/outlook'))->getCalendarIds()
+            : (new GoogleConfig('/home/fpp/media/config/calendar-scheduler/calendar/google'))->getCalendarIds();
+    }
+
+    /**
+     * Refresh the provider token once up front, so concurrent per-calendar
+     * workers all start from a valid token instead of racing to refresh it.
+     */
+    public static function authenticate(string $provider): void
+    {
+        if (self::normalizeProvider($provider) === 'outlook') {
+            (new OutlookApiClient(new OutlookConfig('/home/fpp/media/config/calendar-scheduler/calendar/outlook')))->ensureAuthenticated();
+            return;
+        }
+        (new GoogleApiClient(new GoogleConfig('/home/fpp/media/config/calendar-scheduler/calendar/google')))->ensureAuthenticated();
+    }
+
+    /**
+     * @param string|null $calendarId one of calendarIds(); defaults to the primary calendar
+     * @param string|null $translationCacheDir where the calendar's TranslationCache file and
+     *                                         metadata migration marker live (normally the
+     *                                         snapshot directory); null disables the cache
+     */
+    public static function createSnapshot(
+        string $provider,
+        ?string $calendarId = null,
+        ?string $translationCacheDir = null
+    ): ProviderSnapshotRuntime {
         $provider = self::normalizeProvider($provider);
         if ($provider === 'outlook') {
             $config = new OutlookConfig('/home/fpp/media/config/calendar-scheduler/calendar/outlook');
             $client = new OutlookApiClient($config);
-            $translator = new OutlookCalendarTranslator();
+            $calendarId ??= $config->getCalendarId();
+            $translator = new OutlookCalendarTranslator(
+                $translationCacheDir === null
+                    ? null
+                    : new TranslationCache(TranslationCache::pathFor($translationCacheDir, 'outlook', $calendarId))
+            );
+
+            // Once every managed event of the calendar carries packed metadata,
+            // only the packed property is expanded.
+            $params = [];
+            if (
+                $translationCacheDir !== null
+                && PackedMetadata::legacyRetired(
+                    PackedMetadata::migratedMarkerPath($translationCacheDir, 'outlook', $calendarId),
+                    $config->getSyncHorizon()->end()
+                )
+            ) {
+                $params['$expand'] = OutlookEventMetadataSchema::graphExpandQuery(false);
+            }
 
             return new class (
                 'outlook',
-                $config->getCalendarId(),
+                $calendarId,
+                $config->getSyncHorizon(),
                 static fn() => $translator->ingest(
-                    $client->listEvents($config->getCalendarId()),
-                    $config->getCalendarId()
+                    $client->streamEvents($calendarId, $params),
+                    $calendarId
                 )
             ) implements ProviderSnapshotRuntime {
                 /** @var callable():array<int,array<string,mixed>> */
@@ -45,6 +100,7 @@ final class ProviderRuntimeFactory
                 public function __construct(
                     private readonly string $provider,
                     private readonly string $calendarIdValue,
+                    private readonly SyncHorizon $horizon,
                     callable $translatedEventsFn
                 ) {
                     $this->translatedEventsFn = $translatedEventsFn;
@@ -60,6 +116,11 @@ final class ProviderRuntimeFactory
                     return $this->calendarIdValue;
                 }
 
+                public function syncHorizon(): SyncHorizon
+                {
+                    return $this->horizon;
+                }
+
                 public function translatedEvents(): array
                 {
                     return ($this->translatedEventsFn)();
@@ -69,14 +130,20 @@ final class ProviderRuntimeFactory
 
         $config = new GoogleConfig('/home/fpp/media/config/calendar-scheduler/calendar/google');
         $client = new GoogleApiClient($config);
-        $translator = new GoogleCalendarTranslator();
+        $calendarId ??= $config->getCalendarId();
+        $translator = new GoogleCalendarTranslator(
+            $translationCacheDir === null
+                ? null
+                : new TranslationCache(TranslationCache::pathFor($translationCacheDir, 'google', $calendarId))
+        );
 
         return new class (
             'google',
-            $config->getCalendarId(),
+            $calendarId,
+            $config->getSyncHorizon(),
             static fn() => $translator->ingest(
-                $client->listEvents($config->getCalendarId()),
-                $config->getCalendarId()
+                $client->streamEvents($calendarId),
+                $calendarId
             )
         ) implements ProviderSnapshotRuntime {
             /** @var callable():array<int,array<string,mixed>> */
@@ -88,6 +155,7 @@ final class ProviderRuntimeFactory
             public function __construct(
                 private readonly string $provider,
                 private readonly string $calendarIdValue,
+                private readonly SyncHorizon $horizon,
                 callable $translatedEventsFn
             ) {
                 $this->translatedEventsFn = $translatedEventsFn;
@@ -103,6 +171,11 @@ final class ProviderRuntimeFactory
                 return $this->calendarIdValue;
             }
 
+            public function syncHorizon(): SyncHorizon
+            {
+                return $this->horizon;
+            }
+
             public function translatedEvents(): array
             {
                 return ($this->translatedEventsFn)();
@@ -110,6 +183,126 @@ final class ProviderRuntimeFactory
         };
     }
 
+    /**
+     * @param string|null $calendarId one of calendarIds(); defaults to the primary calendar
+     */
+    public static function createStylePatch(string $provider, ?string $calendarId = null): ProviderStylePatchRuntime
+    {
+        $provider = self::normalizeProvider($provider);
+        if ($provider === 'outlook') {
+            $config = new OutlookConfig('/home/fpp/media/config/calendar-scheduler/calendar/outlook');
+            $client = new OutlookApiClient($config);
+        } else {
+            $config = new GoogleConfig('/home/fpp/media/config/calendar-scheduler/calendar/google');
+            $client = new GoogleApiClient($config);
+        }
+        $calendarId ??= $config->getCalendarId();
+        $patchFn = static fn(array $payloads, ?callable $onBatch): array
+            => $client->batchUpdateEvents($calendarId, $payloads, $onBatch);
+
+        return new class (
+            $provider,
+            $calendarId,
+            $patchFn
+        ) implements ProviderStylePatchRuntime {
+            /** @var callable(array<string,array<string,mixed>>,?callable):array<string,string> */
+            private $patchFn;
+
+            /**
+             * @param callable(array<string,array<string,mixed>>,?callable):array<string,string> $patchFn
+             */
+            public function __construct(
+                private readonly string $provider,
+                private readonly string $calendarIdValue,
+                callable $patchFn
+            ) {
+                $this->patchFn = $patchFn;
+            }
+
+            public function providerName(): string
+            {
+                return $this->provider;
+            }
+
+            public function calendarId(): string
+            {
+                return $this->calendarIdValue;
+            }
+
+            public function patchEvents(array $payloadsByEventId, ?callable $onBatch = null): array
+            {
+                return ($this->patchFn)($payloadsByEventId, $onBatch);
+            }
+        };
+    }
+
+    /**
+     * Single-event reads for post-apply verification; an empty calendar id
+     * addresses the configured primary calendar.
+     */
+    public static function createEventLookup(string $provider): ProviderEventLookupRuntime
+    {
+        $provider = self::normalizeProvider($provider);
+        if ($provider === 'outlook') {
+            $config = new OutlookConfig('/home/fpp/media/config/calendar-scheduler/calendar/outlook');
+            $client = new OutlookApiClient($config);
+            $lookupFn = static function (string $calendarId, string $eventId) use ($config, $client): ?array {
+                $event = $client->getEvent($calendarId !== '' ? $calendarId : $config->getCalendarId(), $eventId);
+                if ($event === null || ($event['isCancelled'] ?? false) === true) {
+                    return null;
+                }
+                $metadata = OutlookEventMetadataSchema::decodeFromOutlookEvent($event);
+                return [
+                    'manifestEventId' => $metadata['manifestEventId'] ?? null,
+                    'subEventHash' => $metadata['subEventHash'] ?? null,
+                ];
+            };
+        } else {
+            $config = new GoogleConfig('/home/fpp/media/config/calendar-scheduler/calendar/google');
+            $client = new GoogleApiClient($config);
+            $lookupFn = static function (string $calendarId, string $eventId) use ($config, $client): ?array {
+                $event = $client->getEvent($calendarId !== '' ? $calendarId : $config->getCalendarId(), $eventId);
+                if ($event === null || ($event['status'] ?? null) === 'cancelled') {
+                    return null;
+                }
+                $metadata = GoogleEventMetadataSchema::decodeFromGoogleEvent($event);
+                return [
+                    'manifestEventId' => $metadata['manifestEventId'] ?? null,
+                    'subEventHash' => $metadata['subEventHash'] ?? null,
+                ];
+            };
+        }
+
+        return new class ($provider, $lookupFn) implements ProviderEventLookupRuntime {
+            /** @var callable(string,string):?array */
+            private $lookupFn;
+
+            /**
+             * @param callable(string,string):?array $lookupFn
+             */
+            public function __construct(
+                private readonly string $provider,
+                callable $lookupFn
+            ) {
+                $this->lookupFn = $lookupFn;
+            }
+
+            public function providerName(): string
+            {
+                return $this->provider;
+            }
+
+            public function lookupEvents(string $calendarId, array $eventIds): array
+            {
+                $out = [];
+                foreach ($eventIds as $eventId) {
+                    $out[(string)$eventId] = ($this->lookupFn)($calendarId, (string)$eventId);
+                }
+                return $out;
+            }
+        };
+    }
+
     public static function createApply(string $provider): ?CalendarApplyRuntime
     {
         $provider = self::normalizeProvider($provider);
@@ -129,14 +322,18 @@ final class ProviderRuntimeFactory
                 'outlook',
                 'outlookEventId',
                 'outlookEventIds',
-                static function (array $actions) use ($executor): array {
-                    $results = $executor->applyActions($actions);
+                static function (
+                    array $actions,
+                    ?CalendarMutationJournal $journal = null,
+                    ?callable $onProgress = null
+                ) use ($executor): array {
+                    $results = $executor->applyActions($actions, $journal, $onProgress);
                     $links = [];
                     foreach ($results as $result) {
                         if (!($result instanceof OutlookMutationResult)) {
                             continue;
                         }
-                        if (($result->op ?? '') !== OutlookMutation::OP_CREATE && ($result->op ?? '') !== OutlookMutation::OP_UPDATE) {
+                        if (!in_array($result->op ?? '', [OutlookMutation::OP_CREATE, OutlookMutation::OP_UPDATE, OutlookMutation::OP_DELETE], true)) {
                             continue;
                         }
                         $eventId = is_string($result->outlookEventId ?? null) ? trim((string)$result->outlookEventId) : '';
@@ -152,7 +349,8 @@ final class ProviderRuntimeFactory
                             (string)$result->op,
                             $manifestEventId,
                             $subEventHash,
-                            $eventId
+                            $eventId,
+                            (string)$result->calendarId
                         );
                     }
                     return $links;
@@ -174,14 +372,18 @@ final class ProviderRuntimeFactory
             'google',
             'googleEventId',
             'googleEventIds',
-            static function (array $actions) use ($executor): array {
-                $results = $executor->applyActions($actions);
+            static function (
+                    array $actions,
+                    ?CalendarMutationJournal $journal = null,
+                    ?callable $onProgress = null
+                ) use ($executor): array {
+                $results = $executor->applyActions($actions, $journal, $onProgress);
                 $links = [];
                 foreach ($results as $result) {
                     if (!($result instanceof GoogleMutationResult)) {
                         continue;
                     }
-                    if (($result->op ?? '') !== GoogleMutation::OP_CREATE && ($result->op ?? '') !== GoogleMutation::OP_UPDATE) {
+                    if (!in_array($result->op ?? '', [GoogleMutation::OP_CREATE, GoogleMutation::OP_UPDATE, GoogleMutation::OP_DELETE], true)) {
                         continue;
                     }
                     $eventId = is_string($result->googleEventId ?? null) ? trim((string)$result->googleEventId) : '';
@@ -197,7 +399,8 @@ final class ProviderRuntimeFactory
                         (string)$result->op,
                         $manifestEventId,
                         $subEventHash,
-                        $eventId
+                        $eventId,
+                        (string)$result->calendarId
                     );
                 }
                 return $links;
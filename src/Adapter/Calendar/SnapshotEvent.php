@@ -35,7 +35,16 @@ final class SnapshotEvent
     /** @var OverrideIntent[] */
     public array $overrides = [];
 
-    // Optional: retained only for debugging / diffing
+    /**
+     * Provider rows this event was built from, as references: provider event
+     * id + row index into the rows given to CalendarSnapshot::snapshot() (the
+     * calendar snapshot file's events list, for a scheduler run).
+     *
+     * @var array<int,array{uid:string,row:int}>
+     */
+    public array $sourceRefs = [];
+
+    // Full provider rows; retained only in debug mode (see CalendarSnapshot).
     public array $sourceRows = [];
 
     public function __construct(array $row)
@@ -49,7 +58,6 @@ final class SnapshotEvent
         $this->timezone = $row['timezone'] ?? null;
         $this->isAllDay = $row['isAllDay'] ?? false;
         $this->payload = $row['payload'] ?? [];
-        $this->sourceRows[] = $row;
 
         // -----------------------------------------------------------------
         // Normalize start/end into a stable provider-agnostic shape.
@@ -86,6 +94,11 @@ final class SnapshotEvent
         $this->overrides[] = $override;
     }
 
+    public function addSourceRef(string $uid, int $row): void
+    {
+        $this->sourceRefs[] = ['uid' => $uid, 'row' => $row];
+    }
+
     public function addSourceRow(array $row): void
     {
         $this->sourceRows[] = $row;
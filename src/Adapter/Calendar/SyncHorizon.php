@@ -0,0 +1,135 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Adapter/Calendar/SyncHorizon.php
+ * Purpose: Rolling provider fetch window (days back / days forward) shared by
+ * provider listing and manifest archiving.
+ */
+
+namespace CalendarScheduler\Adapter\Calendar;
+
+/**
+ * SyncHorizon
+ *
+ * Bounds are anchored to UTC midnight of the run day so repeated refreshes on
+ * the same day request the identical window. The window start doubles as the
+ * archive cutoff: manifest events that end before it are frozen, not re-synced.
+ */
+final class SyncHorizon
+{
+    public const DEFAULT_DAYS_BACK = 30;
+    public const DEFAULT_DAYS_FORWARD = 730;
+
+    private \DateTimeImmutable $start;
+    private \DateTimeImmutable $end;
+
+    public function __construct(
+        private readonly int $daysBack = self::DEFAULT_DAYS_BACK,
+        private readonly int $daysForward = self::DEFAULT_DAYS_FORWARD,
+        ?\DateTimeImmutable $now = null
+    ) {
+        if ($daysBack < 0 || $daysForward < 1) {
+            throw new \RuntimeException(
+                "Invalid sync horizon: days_back={$daysBack}, days_forward={$daysForward}"
+            );
+        }
+
+        $utc = new \DateTimeZone('UTC');
+        $today = ($now ?? new \DateTimeImmutable('now', $utc))->setTimezone($utc)->setTime(0, 0, 0);
+        $this->start = $today->modify("-{$daysBack} days");
+        $this->end = $today->modify("+{$daysForward} days");
+    }
+
+    /**
+     * Read sync_horizon_days_back / sync_horizon_days_forward from provider
+     * config data. CS_SYNC_HORIZON_DAYS_BACK / _FORWARD override both.
+     *
+     * @param array<string,mixed> $data
+     */
+    public static function fromConfig(array $data, ?\DateTimeImmutable $now = null): self
+    {
+        return new self(
+            self::readDays('CS_SYNC_HORIZON_DAYS_BACK', $data['sync_horizon_days_back'] ?? null, self::DEFAULT_DAYS_BACK),
+            self::readDays('CS_SYNC_HORIZON_DAYS_FORWARD', $data['sync_horizon_days_forward'] ?? null, self::DEFAULT_DAYS_FORWARD),
+            $now
+        );
+    }
+
+    public function daysBack(): int
+    {
+        return $this->daysBack;
+    }
+
+    public function daysForward(): int
+    {
+        return $this->daysForward;
+    }
+
+    public function start(): \DateTimeImmutable
+    {
+        return $this->start;
+    }
+
+    public function end(): \DateTimeImmutable
+    {
+        return $this->end;
+    }
+
+    /**
+     * Archive cutoff date (Y-m-d). Events ending strictly before it are archived.
+     */
+    public function archiveBeforeDate(): string
+    {
+        return $this->start->format('Y-m-d');
+    }
+
+    /**
+     * Snapshot wrapper representation; read back by the engine as the archive cutoff.
+     *
+     * @return array{start:string,end:string,days_back:int,days_forward:int}
+     */
+    public function toArray(): array
+    {
+        return [
+            'start' => $this->start->format('Y-m-d\TH:i:s\Z'),
+            'end' => $this->end->format('Y-m-d\TH:i:s\Z'),
+            'days_back' => $this->daysBack,
+            'days_forward' => $this->daysForward,
+        ];
+    }
+
+    /**
+     * Archive cutoff recorded in a calendar snapshot wrapper, or null when the
+     * snapshot predates bounded fetching (full history was pulled).
+     *
+     * @param array<string,mixed> $snapshot
+     */
+    public static function archiveBeforeDateFromSnapshot(array $snapshot): ?string
+    {
+        $start = $snapshot['horizon']['start'] ?? null;
+        if (!is_string($start) || preg_match('/^(\d{4}-\d{2}-\d{2})/', $start, $m) !== 1) {
+            return null;
+        }
+        return $m[1];
+    }
+
+    private static function readDays(string $envName, mixed $configured, int $default): int
+    {
+        $override = getenv($envName);
+        if (is_string($override) && trim($override) !== '') {
+            $configured = trim($override);
+        }
+
+        if (is_int($configured)) {
+            return $configured;
+        }
+        if (is_string($configured) && preg_match('/^\d+$/', trim($configured)) === 1) {
+            return (int)trim($configured);
+        }
+
+        return $default;
+    }
+}
@@ -0,0 +1,125 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Adapter/Calendar/TranslationCache.php
+ * Purpose: Reuse translated calendar rows for provider events whose change
+ * token (Google etag / Graph changeKey) is unchanged since the last fetch.
+ */
+
+namespace CalendarScheduler\Adapter\Calendar;
+
+/**
+ * TranslationCache
+ *
+ * One file per provider calendar, kept next to the calendar snapshot.
+ * Entries are keyed by provider event id + change token; the whole file is
+ * bound to a translator schema string (translator version, managed metadata
+ * format, local timezone, calendar id), and any mismatch discards it.
+ *
+ * Lifecycle per translation pass: begin() loads the previous pass, get()/put()
+ * serve and record rows, save() keeps only the rows seen in this pass, so
+ * deleted events drop out.
+ *
+ * Cache failures are non-fatal; events are simply translated again.
+ */
+final class TranslationCache
+{
+    private const FORMAT_VERSION = 1;
+
+    private string $schema = '';
+
+    /** @var array<string,array<string,mixed>> */
+    private array $previous = [];
+
+    /** @var array<string,array<string,mixed>> */
+    private array $current = [];
+
+    private int $hits = 0;
+
+    public function __construct(
+        private readonly string $path
+    ) {}
+
+    /**
+     * Cache file for one provider calendar, in the snapshot directory.
+     */
+    public static function pathFor(string $directory, string $provider, string $calendarId): string
+    {
+        return rtrim($directory, '/') . '/translation-cache-' . $provider . '-'
+            . substr(hash('sha256', $calendarId), 0, 16) . '.json';
+    }
+
+    public function begin(string $schema): void
+    {
+        $this->schema = $schema;
+        $this->previous = [];
+        $this->current = [];
+        $this->hits = 0;
+
+        $raw = is_file($this->path) ? @file_get_contents($this->path) : false;
+        $decoded = is_string($raw) && $raw !== '' ? json_decode($raw, true) : null;
+        if (
+            is_array($decoded)
+            && ($decoded['version'] ?? null) === self::FORMAT_VERSION
+            && ($decoded['schema'] ?? null) === $schema
+            && is_array($decoded['rows'] ?? null)
+        ) {
+            $this->previous = $decoded['rows'];
+        }
+    }
+
+    /**
+     * @return array<string,mixed>|null
+     */
+    public function get(string $providerId, string $changeToken): ?array
+    {
+        $key = $providerId . '|' . $changeToken;
+        $row = $this->previous[$key] ?? null;
+        if (!is_array($row)) {
+            return null;
+        }
+
+        $this->hits++;
+        $this->current[$key] = $row;
+        return $row;
+    }
+
+    /**
+     * @param array<string,mixed> $row
+     */
+    public function put(string $providerId, string $changeToken, array $row): void
+    {
+        $this->current[$providerId . '|' . $changeToken] = $row;
+    }
+
+    public function hits(): int
+    {
+        return $this->hits;
+    }
+
+    public function save(): void
+    {
+        $json = json_encode([
+            'version' => self::FORMAT_VERSION,
+            'schema' => $this->schema,
+            'rows' => (object)$this->current,
+        ], JSON_UNESCAPED_SLASHES);
+        $this->previous = [];
+        if (!is_string($json)) {
+            return;
+        }
+
+        $dir = dirname($this->path);
+        if (!is_dir($dir) && !@mkdir($dir, 0775, true) && !is_dir($dir)) {
+            return;
+        }
+
+        $tmp = $this->path . '.' . getmypid() . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $this->path)) {
+            @unlink($tmp);
+        }
+    }
+}
@@ -12,6 +12,7 @@ namespace CalendarScheduler\Adapter;
 
 use CalendarScheduler\Intent\NormalizationContext;
 use CalendarScheduler\Platform\FPPSemantics;
+use CalendarScheduler\Platform\HashScheme;
 
 /**
  * FppScheduleAdapter
@@ -30,6 +31,11 @@ final class FppScheduleAdapter
 {
     private const FPP_SCHEDULE_API_URL = 'http://127.0.0.1/api/schedule';
 
+    public const DEFAULT_SCHEDULE_CACHE_PATH = '/home/fpp/media/config/calendar-scheduler/runtime/fpp-schedule-cache.json';
+
+    // Bump when the translation below changes shape, so cached events are rebuilt.
+    private const SCHEDULE_CACHE_VERSION = 2;
+
     /** @var array<string,bool> */
     private const COMMAND_EXCLUDE_KEYS = [
         'enabled' => true,
@@ -50,6 +56,20 @@ final class FppScheduleAdapter
         // If FPP ever adds additional scheduler keys, add them here (adapter-only).
     ];
 
+    /** @var array<string,array<int,array<string,mixed>>> last translated schedule.json, by memo key */
+    private static array $scheduleMemo = [];
+
+    /** @var array<string,array{event:array<string,mixed>,aggregateKey:string}> translated rows of the last schedule */
+    private static array $entryMemo = [];
+
+    /**
+     * @param string|null $scheduleCachePath Cross-run cache of translated schedule.json
+     *                                       events (null keeps the memo in-process only)
+     */
+    public function __construct(
+        private readonly ?string $scheduleCachePath = self::DEFAULT_SCHEDULE_CACHE_PATH
+    ) {}
+
     /**
      * Split an FPP time field into canonical hard/symbolic parts.
      *
@@ -113,8 +133,16 @@ final class FppScheduleAdapter
     }
 
     /**
-     * Load and convert all FPP schedule entries into canonical manifest-event arrays
-     * from the live FPP schedule API.
+     * Load and convert all FPP schedule entries into canonical manifest-event arrays.
+     *
+     * Source:
+     * - schedule.json when it is readable; translated events are reused while the
+     *   file fingerprint (inode/size/mtime), timezone and local date are unchanged
+     *   (per process, and across runs through the runtime cache file), and rows
+     *   of an edited file that are themselves unchanged are not translated again
+     * - the live FPP schedule API otherwise
+     *
+     * Either way every event is stamped with the load time, as before.
      *
      * @return array<int,array<string,mixed>> manifest-events
      */
@@ -122,8 +150,154 @@ final class FppScheduleAdapter
         NormalizationContext $context,
         string $schedulePath
     ): array {
-        $raw = $this->fetchLiveScheduleViaApi();
-        return $this->normalizeRawEntriesToManifestEvents($context, $raw, time());
+        $now = time();
+        $fingerprint = self::scheduleFileFingerprint($schedulePath);
+        if ($fingerprint === null) {
+            $raw = $this->fetchLiveScheduleViaApi();
+            return $this->normalizeRawEntriesToManifestEvents($context, $raw, $now);
+        }
+
+        $memoKey = $this->scheduleMemoKey($fingerprint, $context->timezone);
+        $events = self::$scheduleMemo[$memoKey] ?? null;
+        if ($events === null) {
+            $cached = $this->readScheduleCache();
+            if (($cached['key'] ?? null) === $memoKey) {
+                $events = $cached['events'];
+            } elseif ($cached !== null && self::$entryMemo === []) {
+                // Schedule changed since the last run: only new or edited rows
+                // are translated again.
+                self::$entryMemo = $cached['entries'];
+            }
+        }
+        if ($events === null) {
+            $events = $this->normalizeRawEntriesToManifestEvents(
+                $context,
+                $this->loadScheduleEntriesFromFile($schedulePath),
+                $now
+            );
+            // A file modified within the current second may still change
+            // without moving its mtime; parse it again next time.
+            if ($fingerprint['mtime'] < $now) {
+                self::$scheduleMemo = [$memoKey => $events];
+                $this->writeScheduleCache($memoKey, $events, $schedulePath);
+            }
+        } else {
+            self::$scheduleMemo = [$memoKey => $events];
+        }
+
+        foreach ($events as &$event) {
+            $event['updatedAtEpoch'] = $now;
+            $event['sourceUpdatedAt'] = $now;
+        }
+        unset($event);
+
+        return $events;
+    }
+
+    /**
+     * Identity of the schedule file as last written, or null when it cannot be read.
+     *
+     * @return array{path:string,ino:int,size:int,mtime:int}|null
+     */
+    private static function scheduleFileFingerprint(string $schedulePath): ?array
+    {
+        if ($schedulePath === '') {
+            return null;
+        }
+        clearstatcache(true, $schedulePath);
+        if (!is_file($schedulePath) || !is_readable($schedulePath)) {
+            return null;
+        }
+        $stat = @stat($schedulePath);
+        if (!is_array($stat)) {
+            return null;
+        }
+
+        return [
+            'path' => $schedulePath,
+            'ino' => (int)$stat['ino'],
+            'size' => (int)$stat['size'],
+            'mtime' => (int)$stat['mtime'],
+        ];
+    }
+
+    /**
+     * Guard-date stripping depends on the local date, so it is part of the key.
+     *
+     * @param array{path:string,ino:int,size:int,mtime:int} $fingerprint
+     */
+    private function scheduleMemoKey(array $fingerprint, \DateTimeZone $fppTz): string
+    {
+        return hash('sha256', json_encode([
+            self::SCHEDULE_CACHE_VERSION,
+            $fingerprint,
+            $fppTz->getName(),
+            (new \DateTimeImmutable('now', $fppTz))->format('Y-m-d'),
+        ], JSON_THROW_ON_ERROR));
+    }
+
+    /**
+     * @return array{key:string,events:array<int,array<string,mixed>>,entries:array<string,array{event:array<string,mixed>,aggregateKey:string}>}|null
+     */
+    private function readScheduleCache(): ?array
+    {
+        if ($this->scheduleCachePath === null || !is_file($this->scheduleCachePath)) {
+            return null;
+        }
+
+        $raw = @file_get_contents($this->scheduleCachePath);
+        $decoded = is_string($raw) && $raw !== '' ? json_decode($raw, true) : null;
+        if (
+            !is_array($decoded)
+            || ($decoded['version'] ?? null) !== self::SCHEDULE_CACHE_VERSION
+            || !is_string($decoded['key'] ?? null)
+            || !is_array($decoded['events'] ?? null)
+            || !array_is_list($decoded['events'])
+            || !is_array($decoded['entries'] ?? null)
+        ) {
+            return null;
+        }
+
+        return $decoded;
+    }
+
+    /**
+     * Cache failures are non-fatal; the next load parses schedule.json again.
+     * A cache path naming the schedule file itself is never written, so a
+     * misplaced constructor argument cannot replace FPP's schedule.
+     *
+     * @param array<int,array<string,mixed>> $events
+     */
+    private function writeScheduleCache(string $memoKey, array $events, string $schedulePath): void
+    {
+        if ($this->scheduleCachePath === null || self::isSameFile($this->scheduleCachePath, $schedulePath)) {
+            return;
+        }
+        $json = json_encode([
+            'version' => self::SCHEDULE_CACHE_VERSION,
+            'key' => $memoKey,
+            'events' => $events,
+            'entries' => (object)self::$entryMemo,
+        ], JSON_UNESCAPED_SLASHES);
+        if (!is_string($json)) {
+            return;
+        }
+
+        $dir = dirname($this->scheduleCachePath);
+        if (!is_dir($dir) && !@mkdir($dir, 0775, true) && !is_dir($dir)) {
+            return;
+        }
+
+        $tmp = $this->scheduleCachePath . '.' . getmypid() . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $this->scheduleCachePath)) {
+            @unlink($tmp);
+        }
+    }
+
+    private static function isSameFile(string $a, string $b): bool
+    {
+        $realA = realpath($a);
+        return $a === $b || ($realA !== false && $realA === realpath($b));
     }
 
     /**
@@ -156,11 +330,12 @@ final class FppScheduleAdapter
         $fppTz = $context->timezone;
         $yearHints = [];
         $globalYearHint = null;
-        foreach ($raw as $entry) {
+        $identityKeys = [];
+        foreach ($raw as $entryIndex => $entry) {
             if (!is_array($entry)) {
                 continue;
             }
-            $key = $this->deriveEntryIdentityKey($entry);
+            $key = $identityKeys[$entryIndex] = $this->deriveEntryIdentityKey($entry);
             if ($key === null) {
                 continue;
             }
@@ -181,43 +356,53 @@ final class FppScheduleAdapter
             }
         }
 
+        $tzName = $fppTz->getName();
+        $localDate = (new \DateTimeImmutable('now', $fppTz))->format('Y-m-d');
+        $scheme = HashScheme::active();
+        $entryMemo = [];
+
         /** @var array<string,array<string,mixed>> $aggregated */
         $aggregated = [];
         foreach ($raw as $entryIndex => $entry) {
             if (!is_array($entry)) {
                 continue;
             }
-            $key = $this->deriveEntryIdentityKey($entry);
+            $key = $identityKeys[$entryIndex];
             $yearHint = (is_string($key) && isset($yearHints[$key]))
                 ? (int)$yearHints[$key]
                 : (is_int($globalYearHint) ? $globalYearHint : null);
-            $event = $this->fromScheduleEntry(
-                $entry,
-                $fppTz,
-                $updatedAt,
-                $yearHint,
-                is_int($entryIndex) ? $entryIndex : null
-            );
 
-            $aggregateKey = $this->deriveManifestAggregateKey($event);
+            // Translation depends only on the row, its year hint, the timezone
+            // and (guard dates) the local date; load-time fields are set below.
+            $entryKey = md5(serialize([$entry, $yearHint, $tzName, $localDate, $scheme]));
+            $translated = $entryMemo[$entryKey] ?? self::$entryMemo[$entryKey] ?? null;
+            if (!is_array($translated['event']['subEvents'][0] ?? null) || !is_string($translated['aggregateKey'] ?? null)) {
+                $event = $this->fromScheduleEntry($entry, $fppTz, $updatedAt, $yearHint);
+                $translated = ['event' => $event, 'aggregateKey' => $this->deriveManifestAggregateKey($event)];
+            }
+            $entryMemo[$entryKey] = $translated;
+
+            $event = $translated['event'];
+            $event['updatedAtEpoch'] = $updatedAt;
+            $event['sourceUpdatedAt'] = $updatedAt;
+            $event['subEvents'][0]['executionOrder'] = is_int($entryIndex) && $entryIndex >= 0 ? $entryIndex : 0;
+
+            $aggregateKey = $translated['aggregateKey'];
             if (!isset($aggregated[$aggregateKey])) {
                 $aggregated[$aggregateKey] = $event;
                 continue;
             }
-
-            $existingSubs = is_array($aggregated[$aggregateKey]['subEvents'] ?? null)
-                ? $aggregated[$aggregateKey]['subEvents']
-                : [];
-            $newSubs = is_array($event['subEvents'] ?? null)
-                ? $event['subEvents']
-                : [];
-            $aggregated[$aggregateKey]['subEvents'] = array_merge($existingSubs, $newSubs);
+            $aggregated[$aggregateKey]['subEvents'][] = $event['subEvents'][0];
         }
+        // Keep only rows of the current schedule, so the memo stays bounded.
+        self::$entryMemo = $entryMemo;
 
         foreach ($aggregated as &$event) {
-            $subs = is_array($event['subEvents'] ?? null) ? $event['subEvents'] : [];
-            usort($subs, fn(array $a, array $b): int => $this->compareSubEventsForManifest($a, $b));
-            $event['subEvents'] = $subs;
+            $subs = $event['subEvents'];
+            if (count($subs) > 1) {
+                $subs = $this->sortSubEventsForManifest($subs);
+                $event['subEvents'] = $subs;
+            }
 
             $identityTiming = $this->selectIdentityTiming($subs);
             if ($identityTiming !== []) {
@@ -543,63 +728,54 @@ final class FppScheduleAdapter
             'days' => $timing['days'] ?? null,
         ];
 
-        return hash('sha256', json_encode($shape, JSON_THROW_ON_ERROR));
-    }
-
-    /**
-     * @param array<string,mixed> $a
-     * @param array<string,mixed> $b
-     */
-    private function compareSubEventsByStart(array $a, array $b): int
-    {
-        $timingA = is_array($a['timing'] ?? null) ? $a['timing'] : [];
-        $timingB = is_array($b['timing'] ?? null) ? $b['timing'] : [];
-        $dateA = is_array($timingA['start_date'] ?? null) ? $timingA['start_date'] : [];
-        $dateB = is_array($timingB['start_date'] ?? null) ? $timingB['start_date'] : [];
-        $timeA = is_array($timingA['start_time'] ?? null) ? $timingA['start_time'] : [];
-        $timeB = is_array($timingB['start_time'] ?? null) ? $timingB['start_time'] : [];
-
-        $keyA = implode('|', [
-            (string)($dateA['hard'] ?? ''),
-            (string)($dateA['symbolic'] ?? ''),
-            (string)($timeA['hard'] ?? ''),
-            (string)($timeA['symbolic'] ?? ''),
-            (string)($timeA['offset'] ?? 0),
-        ]);
-        $keyB = implode('|', [
-            (string)($dateB['hard'] ?? ''),
-            (string)($dateB['symbolic'] ?? ''),
-            (string)($timeB['hard'] ?? ''),
-            (string)($timeB['symbolic'] ?? ''),
-            (string)($timeB['offset'] ?? 0),
-        ]);
-
-        return $keyA <=> $keyB;
+        return HashScheme::digest($shape);
     }
 
     /**
      * Keep explicit scheduler order when available; otherwise default to
      * deterministic chronological ordering.
      *
-     * @param array<string,mixed> $a
-     * @param array<string,mixed> $b
+     * Sort keys are built once per SubEvent rather than per comparison.
+     *
+     * @param array<int,array<string,mixed>> $subEvents
+     * @return array<int,array<string,mixed>>
      */
-    private function compareSubEventsForManifest(array $a, array $b): int
+    private function sortSubEventsForManifest(array $subEvents): array
     {
-        $aOrder = $this->subEventExecutionOrder($a);
-        $bOrder = $this->subEventExecutionOrder($b);
-        if ($aOrder !== null && $bOrder !== null && $aOrder !== $bOrder) {
-            return $aOrder <=> $bOrder;
+        $keys = [];
+        foreach ($subEvents as $i => $subEvent) {
+            $timing = is_array($subEvent['timing'] ?? null) ? $subEvent['timing'] : [];
+            $date = is_array($timing['start_date'] ?? null) ? $timing['start_date'] : [];
+            $time = is_array($timing['start_time'] ?? null) ? $timing['start_time'] : [];
+            $keys[$i] = [
+                $this->subEventExecutionOrder($subEvent),
+                implode('|', [
+                    (string)($date['hard'] ?? ''),
+                    (string)($date['symbolic'] ?? ''),
+                    (string)($time['hard'] ?? ''),
+                    (string)($time['symbolic'] ?? ''),
+                    (string)($time['offset'] ?? 0),
+                ]),
+                is_string($subEvent['stateHash'] ?? null) ? (string)$subEvent['stateHash'] : '',
+            ];
         }
 
-        $cmp = $this->compareSubEventsByStart($a, $b);
-        if ($cmp !== 0) {
-            return $cmp;
+        $order = array_keys($subEvents);
+        usort($order, static function (int $a, int $b) use ($keys): int {
+            [$aOrder, $aStart, $aHash] = $keys[$a];
+            [$bOrder, $bStart, $bHash] = $keys[$b];
+            if ($aOrder !== null && $bOrder !== null && $aOrder !== $bOrder) {
+                return $aOrder <=> $bOrder;
+            }
+            return ($aStart <=> $bStart) ?: strcmp($aHash, $bHash);
+        });
+
+        $sorted = [];
+        foreach ($order as $i) {
+            $sorted[] = $subEvents[$i];
         }
 
-        $aHash = is_string($a['stateHash'] ?? null) ? (string)$a['stateHash'] : '';
-        $bHash = is_string($b['stateHash'] ?? null) ? (string)$b['stateHash'] : '';
-        return strcmp($aHash, $bHash);
+        return $sorted;
     }
 
     /**
@@ -0,0 +1,299 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Apply/ApplyJob.php
+ * Purpose: File-backed apply job (state + append-only stage events) shared by
+ * the UI API request that starts an apply, the detached worker that runs it,
+ * and the progress stream that reports it.
+ */
+
+namespace CalendarScheduler\Apply;
+
+/**
+ * ApplyJob
+ *
+ * Two files per job under the jobs directory:
+ * - <id>.json:   current state (status, syncMode, timestamps, result/error),
+ *                replaced atomically
+ * - <id>.events: one JSON line per stage event; an event's sequence number is
+ *                its 1-based line number, so readers resume with "after <seq>"
+ *
+ * Only the worker writes events. A torn trailing line is not reported until
+ * it is complete. At most one job is active at a time; a running job whose
+ * worker process is gone is failed when it is next looked up.
+ */
+final class ApplyJob
+{
+    public const DEFAULT_DIR = '/home/fpp/media/config/calendar-scheduler/runtime/apply-jobs';
+
+    public const STATUS_QUEUED = 'queued';
+    public const STATUS_RUNNING = 'running';
+    public const STATUS_DONE = 'done';
+    public const STATUS_FAILED = 'failed';
+
+    // A worker that has not reported anything for this long is presumed dead.
+    private const STALE_SECONDS = 1800;
+    // A queued job whose worker has not picked it up within this window failed to start.
+    private const START_TIMEOUT_SECONDS = 60;
+    private const KEEP_FINISHED = 10;
+
+    private function __construct(
+        private readonly string $dir,
+        public readonly string $id,
+        public readonly bool $created = false
+    ) {}
+
+    /**
+     * Create a queued job, or return the job that is already active
+     * ($created tells the caller whether a worker must be started).
+     * $confirmResume lets the worker replay a pending apply journal that
+     * would otherwise be refused as stale.
+     */
+    public static function start(string $syncMode, string $dir = self::DEFAULT_DIR, bool $confirmResume = false): self
+    {
+        self::ensureDir($dir);
+        $lock = @fopen(rtrim($dir, '/') . '/.lock', 'c');
+        if ($lock === false) {
+            throw new \RuntimeException('ApplyJob: unable to lock ' . $dir);
+        }
+
+        try {
+            flock($lock, LOCK_EX);
+            $active = self::active($dir);
+            if ($active !== null) {
+                return $active;
+            }
+
+            self::prune($dir);
+            $job = new self($dir, gmdate('YmdHis') . '-' . bin2hex(random_bytes(4)), true);
+            $now = gmdate(DATE_ATOM);
+            $job->writeState([
+                'id' => $job->id,
+                'status' => self::STATUS_QUEUED,
+                'syncMode' => $syncMode,
+                'confirmResume' => $confirmResume,
+                'createdAt' => $now,
+                'updatedAt' => $now,
+                'pid' => null,
+            ]);
+            @touch($job->eventsPath());
+
+            return $job;
+        } finally {
+            flock($lock, LOCK_UN);
+            fclose($lock);
+        }
+    }
+
+    public static function open(string $id, string $dir = self::DEFAULT_DIR): ?self
+    {
+        if (preg_match('/^[0-9]{14}-[0-9a-f]{8}$/', $id) !== 1) {
+            return null;
+        }
+        $job = new self($dir, $id);
+        return $job->state() !== null ? $job : null;
+    }
+
+    /**
+     * Newest queued/running job, if any.
+     */
+    public static function active(string $dir = self::DEFAULT_DIR): ?self
+    {
+        $paths = glob(rtrim($dir, '/') . '/*.json') ?: [];
+        rsort($paths, SORT_STRING);
+        foreach ($paths as $path) {
+            $job = self::open(basename($path, '.json'), $dir);
+            if ($job !== null && !$job->isFinished()) {
+                return $job;
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * @return array<string,mixed>|null
+     */
+    public function state(): ?array
+    {
+        $raw = @file_get_contents($this->statePath());
+        if (!is_string($raw) || $raw === '') {
+            return null;
+        }
+        $state = json_decode($raw, true);
+        if (!is_array($state)) {
+            return null;
+        }
+
+        $status = $state['status'] ?? null;
+        if ($status === self::STATUS_RUNNING && $this->workerGone($state)) {
+            $this->fail('Apply worker exited before finishing');
+            return $this->state();
+        }
+        if ($status === self::STATUS_QUEUED && $this->idleFor($state) > self::START_TIMEOUT_SECONDS) {
+            $this->fail('Apply worker did not start');
+            return $this->state();
+        }
+
+        return $state;
+    }
+
+    public function isFinished(): bool
+    {
+        $status = $this->state()['status'] ?? null;
+        return $status === self::STATUS_DONE || $status === self::STATUS_FAILED;
+    }
+
+    public function markRunning(int $pid): void
+    {
+        $this->updateState(['status' => self::STATUS_RUNNING, 'pid' => $pid]);
+    }
+
+    /**
+     * Record a stage event (fetch, plan, fpp_commit, mutation, verify, ...).
+     *
+     * @param array<string,mixed> $data
+     */
+    public function emit(string $stage, array $data = []): void
+    {
+        $line = json_encode(
+            ['stage' => $stage, 'at' => gmdate(DATE_ATOM)] + $data,
+            JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR
+        ) . "\n";
+        if (@file_put_contents($this->eventsPath(), $line, FILE_APPEND | LOCK_EX) === false) {
+            throw new \RuntimeException('ApplyJob: unable to append to ' . $this->eventsPath());
+        }
+        $this->updateState([]);
+    }
+
+    /**
+     * @param array<string,mixed> $result
+     */
+    public function finish(array $result): void
+    {
+        $this->updateState(['status' => self::STATUS_DONE, 'result' => $result]);
+        $this->emit(self::STATUS_DONE);
+    }
+
+    public function fail(string $error, ?string $correlationId = null): void
+    {
+        $this->updateState([
+            'status' => self::STATUS_FAILED,
+            'error' => $error,
+            'correlationId' => $correlationId,
+        ]);
+        $this->emit(self::STATUS_FAILED, ['error' => $error]);
+    }
+
+    /**
+     * Events after the given sequence number, keyed by sequence number.
+     *
+     * @return array<int,array<string,mixed>>
+     */
+    public function events(int $after = 0): array
+    {
+        $raw = @file_get_contents($this->eventsPath());
+        if (!is_string($raw) || $raw === '') {
+            return [];
+        }
+
+        $out = [];
+        $lines = explode("\n", $raw);
+        array_pop($lines); // incomplete (or empty) remainder after the last newline
+        foreach ($lines as $i => $line) {
+            $seq = $i + 1;
+            if ($seq <= $after) {
+                continue;
+            }
+            $event = json_decode($line, true);
+            if (is_array($event)) {
+                $out[$seq] = $event;
+            }
+        }
+
+        return $out;
+    }
+
+    /**
+     * @param array<string,mixed> $state
+     */
+    private function workerGone(array $state): bool
+    {
+        $pid = (int)($state['pid'] ?? 0);
+        if ($pid > 0 && function_exists('posix_kill') && !@posix_kill($pid, 0)) {
+            // EPERM: the process exists but belongs to another user.
+            return posix_get_last_error() !== 1;
+        }
+
+        return $this->idleFor($state) > self::STALE_SECONDS;
+    }
+
+    /**
+     * @param array<string,mixed> $state
+     */
+    private function idleFor(array $state): int
+    {
+        $updatedAt = strtotime((string)($state['updatedAt'] ?? ''));
+        return $updatedAt === false ? 0 : time() - $updatedAt;
+    }
+
+    /**
+     * @param array<string,mixed> $changes
+     */
+    private function updateState(array $changes): void
+    {
+        $raw = @file_get_contents($this->statePath());
+        $state = is_string($raw) ? json_decode($raw, true) : null;
+        if (!is_array($state)) {
+            throw new \RuntimeException('ApplyJob: missing state for job ' . $this->id);
+        }
+        $this->writeState(array_merge($state, $changes, ['updatedAt' => gmdate(DATE_ATOM)]));
+    }
+
+    /**
+     * @param array<string,mixed> $state
+     */
+    private function writeState(array $state): void
+    {
+        $json = json_encode($state, JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR);
+        $tmp = $this->statePath() . '.' . getmypid() . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $this->statePath())) {
+            @unlink($tmp);
+            throw new \RuntimeException('ApplyJob: unable to write ' . $this->statePath());
+        }
+    }
+
+    /**
+     * Keep only the newest finished jobs.
+     */
+    private static function prune(string $dir): void
+    {
+        $paths = glob(rtrim($dir, '/') . '/*.json') ?: [];
+        rsort($paths, SORT_STRING);
+        foreach (array_slice($paths, self::KEEP_FINISHED) as $path) {
+            $id = basename($path, '.json');
+            @unlink($path);
+            @unlink(rtrim($dir, '/') . '/' . $id . '.events');
+        }
+    }
+
+    private static function ensureDir(string $dir): void
+    {
+        if (!is_dir($dir) && !@mkdir($dir, 0775, true) && !is_dir($dir)) {
+            throw new \RuntimeException('ApplyJob: unable to create ' . $dir);
+        }
+    }
+
+    private function statePath(): string
+    {
+        return rtrim($this->dir, '/') . '/' . $this->id . '.json';
+    }
+
+    private function eventsPath(): string
+    {
+        return rtrim($this->dir, '/') . '/' . $this->id . '.events';
+    }
+}
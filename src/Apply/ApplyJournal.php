@@ -0,0 +1,435 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Apply/ApplyJournal.php
+ * Purpose: Durable apply journal (persisted plan + per-mutation checkpoints)
+ * so an interrupted apply resumes with only the unacknowledged work.
+ */
+
+namespace CalendarScheduler\Apply;
+
+use CalendarScheduler\Adapter\Calendar\CalendarMutationJournal;
+use CalendarScheduler\Diff\ReconciliationAction;
+use CalendarScheduler\Diff\ReconciliationResult;
+
+/**
+ * ApplyJournal
+ *
+ * Two files under the runtime directory:
+ * - apply-journal.json: the plan being applied (target manifest + executable
+ *   actions), written atomically once when a real apply begins
+ * - apply-journal.log:  append-only JSON lines, one per completed step
+ *   (FPP schedule commit, each provider mutation), flushed and fsync'd
+ *   before the step is considered done
+ *
+ * Both files are removed once the manifest is persisted. Their presence means
+ * the last apply did not finish; ApplyRunner::resume() replays the stored plan
+ * and every acknowledged step is skipped. A torn trailing log line (crash
+ * mid-write) is ignored, so that step simply runs again.
+ *
+ * The plan also records the writable targets it was applied with, when it
+ * started, and a fingerprint of schedule.json before the apply (the FPP
+ * commit line records the one after). resumeBlocker() uses them to refuse a
+ * plan that is too old, or whose schedule.json has been edited since, as
+ * replaying it would overwrite newer changes.
+ */
+final class ApplyJournal implements CalendarMutationJournal
+{
+    public const DEFAULT_DIR = '/home/fpp/media/config/calendar-scheduler/runtime';
+
+    // Older plans are only resumed with explicit confirmation.
+    public const DEFAULT_MAX_RESUME_AGE_SECONDS = 3600;
+
+    private const VERSION = 2;
+    private const PLAN_FILE = 'apply-journal.json';
+    private const LOG_FILE = 'apply-journal.log';
+
+    /** @var array<string,string>|null mutation key => provider event id */
+    private ?array $acks = null;
+
+    private bool $fppCommitted = false;
+
+    // schedule.json fingerprint recorded with the FPP commit
+    private ?string $committedSchedule = null;
+
+    /** @var resource|null */
+    private $log = null;
+    private int $logPid = 0;
+
+    public function __construct(
+        private readonly string $dir = self::DEFAULT_DIR
+    ) {}
+
+    public function __destruct()
+    {
+        if (is_resource($this->log)) {
+            fclose($this->log);
+        }
+    }
+
+    /**
+     * True when a previous apply started but never finalized its manifest.
+     */
+    public function hasPending(): bool
+    {
+        return is_file($this->planPath());
+    }
+
+    /**
+     * Summary of the pending apply for status surfaces, or null when none.
+     *
+     * @return array{planHash:string,startedAt:string,targets:array<int,string>,actions:int,acknowledged:int,fppCommitted:bool}|null
+     */
+    public function pendingSummary(): ?array
+    {
+        $plan = $this->readPlan();
+        if ($plan === null) {
+            return null;
+        }
+        $this->loadLog();
+
+        return [
+            'planHash' => (string)$plan['planHash'],
+            'startedAt' => (string)($plan['startedAt'] ?? ''),
+            'targets' => $plan['targets'],
+            'actions' => count($plan['actions']),
+            'acknowledged' => count($this->acks ?? []),
+            'fppCommitted' => $this->fppCommitted,
+        ];
+    }
+
+    /**
+     * Rebuild the stored plan; executable actions only, in their original order.
+     */
+    public function pendingResult(): ?ReconciliationResult
+    {
+        $plan = $this->readPlan();
+        if ($plan === null) {
+            return null;
+        }
+
+        $actions = [];
+        foreach ($plan['actions'] as $row) {
+            if (!is_array($row)) {
+                continue;
+            }
+            $actions[] = new ReconciliationAction(
+                (string)($row['type'] ?? ''),
+                (string)($row['target'] ?? ''),
+                (string)($row['authority'] ?? ''),
+                (string)($row['identityHash'] ?? ''),
+                (string)($row['reason'] ?? ''),
+                is_array($row['event'] ?? null) ? $row['event'] : null,
+                is_array($row['currentEvent'] ?? null) ? $row['currentEvent'] : null
+            );
+        }
+
+        return new ReconciliationResult($plan['targetManifest'], $actions);
+    }
+
+    /**
+     * Options the stored plan was applied with. Resume is always fail-closed:
+     * an action outside the stored targets fails it.
+     */
+    public function pendingOptions(): ?ApplyOptions
+    {
+        $plan = $this->readPlan();
+        return $plan !== null ? ApplyOptions::apply($plan['targets'], true) : null;
+    }
+
+    /**
+     * Why the pending plan must not be replayed without confirmation, or null
+     * when it may resume.
+     *
+     * @param string|null $currentSchedule schedule.json fingerprint now (see FppScheduleWriter::fingerprint())
+     */
+    public function resumeBlocker(?string $currentSchedule, int $maxAgeSeconds = self::DEFAULT_MAX_RESUME_AGE_SECONDS): ?string
+    {
+        $plan = $this->readPlan();
+        if ($plan === null) {
+            return 'the apply journal is unreadable or from an older version';
+        }
+
+        $age = time() - $plan['startedAtEpoch'];
+        if ($age > $maxAgeSeconds) {
+            return sprintf('the interrupted apply started %d minutes ago (limit %d)', intdiv($age, 60), intdiv($maxAgeSeconds, 60));
+        }
+
+        $this->loadLog();
+        $expected = $this->fppCommitted ? $this->committedSchedule : $plan['scheduleFingerprint'];
+        if ($expected !== $currentSchedule) {
+            return 'schedule.json changed since the interrupted apply';
+        }
+
+        return null;
+    }
+
+    /**
+     * Start journaling a real apply. Re-beginning the same plan keeps its
+     * acknowledgements (resume); a different plan discards the stale journal.
+     *
+     * @param string|null $scheduleFingerprint schedule.json before the apply
+     */
+    public function begin(ReconciliationResult $result, ApplyOptions $options, ?string $scheduleFingerprint): void
+    {
+        $planHash = self::planHash($result);
+        $existing = $this->readPlan();
+        if ($existing !== null && $existing['planHash'] === $planHash) {
+            $this->loadLog();
+            return;
+        }
+
+        $this->discard();
+        $actions = [];
+        foreach ($result->executableActions() as $action) {
+            $actions[] = [
+                'type' => $action->type,
+                'target' => $action->target,
+                'authority' => $action->authority,
+                'identityHash' => $action->identityHash,
+                'reason' => $action->reason,
+                'event' => $action->event,
+                'currentEvent' => $action->currentEvent,
+            ];
+        }
+
+        $this->writeAtomic($this->planPath(), [
+            'version' => self::VERSION,
+            'planHash' => $planHash,
+            'startedAt' => gmdate(DATE_ATOM),
+            'startedAtEpoch' => time(),
+            'targets' => $options->writableTargets(),
+            'scheduleFingerprint' => $scheduleFingerprint,
+            'targetManifest' => $result->targetManifest(),
+            'actions' => $actions,
+        ]);
+        $this->acks = [];
+        $this->fppCommitted = false;
+        $this->committedSchedule = null;
+    }
+
+    public function fppCommitted(): bool
+    {
+        $this->loadLog();
+        return $this->fppCommitted;
+    }
+
+    /**
+     * @param string|null $scheduleFingerprint schedule.json after the commit
+     */
+    public function markFppCommitted(?string $scheduleFingerprint): void
+    {
+        $this->append(['kind' => 'fpp', 'schedule' => $scheduleFingerprint]);
+        $this->fppCommitted = true;
+        $this->committedSchedule = $scheduleFingerprint;
+    }
+
+    public function acknowledged(
+        string $op,
+        string $manifestEventId,
+        string $subEventHash,
+        ?string $providerEventId
+    ): ?string {
+        $this->loadLog();
+        return $this->acks[self::mutationKey($op, $manifestEventId, $subEventHash, $providerEventId)] ?? null;
+    }
+
+    public function acknowledge(
+        string $op,
+        string $manifestEventId,
+        string $subEventHash,
+        ?string $providerEventId,
+        string $resultEventId
+    ): void {
+        $key = self::mutationKey($op, $manifestEventId, $subEventHash, $providerEventId);
+        $this->append([
+            'kind' => 'mutation',
+            'key' => $key,
+            'op' => $op,
+            'manifestEventId' => $manifestEventId,
+            'providerEventId' => $resultEventId,
+        ]);
+        $this->acks ??= [];
+        $this->acks[$key] = $resultEventId;
+    }
+
+    /**
+     * Manifest persisted: the journal has nothing left to protect.
+     */
+    public function complete(): void
+    {
+        $this->discard();
+    }
+
+    /**
+     * Drop a pending plan without replaying it (operator decision); the next
+     * apply plans from the current state.
+     */
+    public function discard(): void
+    {
+        if (is_resource($this->log)) {
+            fclose($this->log);
+        }
+        $this->log = null;
+        @unlink($this->logPath());
+        @unlink($this->planPath());
+        $this->acks = null;
+        $this->fppCommitted = false;
+        $this->committedSchedule = null;
+    }
+
+    /**
+     * Hash of everything that determines the mutations to send: executable
+     * actions (with event payloads) and the target manifest.
+     */
+    private static function planHash(ReconciliationResult $result): string
+    {
+        $actions = [];
+        foreach ($result->executableActions() as $action) {
+            $actions[] = [
+                $action->type,
+                $action->target,
+                $action->identityHash,
+                $action->event,
+                $action->currentEvent,
+            ];
+        }
+
+        return hash('sha256', json_encode(
+            [$actions, $result->targetManifest()],
+            JSON_THROW_ON_ERROR | JSON_UNESCAPED_SLASHES
+        ));
+    }
+
+    private static function mutationKey(
+        string $op,
+        string $manifestEventId,
+        string $subEventHash,
+        ?string $providerEventId
+    ): string {
+        return $op . '|' . $manifestEventId . '|' . $subEventHash . '|' . ($providerEventId ?? '');
+    }
+
+    /**
+     * @return array{planHash:string,startedAt?:string,startedAtEpoch:int,targets:array<int,string>,scheduleFingerprint:?string,targetManifest:array<string,mixed>,actions:array<int,mixed>}|null
+     */
+    private function readPlan(): ?array
+    {
+        $raw = @file_get_contents($this->planPath());
+        if (!is_string($raw) || $raw === '') {
+            return null;
+        }
+        $plan = json_decode($raw, true);
+        if (
+            !is_array($plan)
+            || ($plan['version'] ?? null) !== self::VERSION
+            || !is_string($plan['planHash'] ?? null)
+            || !is_int($plan['startedAtEpoch'] ?? null)
+            || !is_array($plan['targets'] ?? null)
+            || !(is_string($plan['scheduleFingerprint'] ?? null) || ($plan['scheduleFingerprint'] ?? null) === null)
+            || !is_array($plan['targetManifest'] ?? null)
+            || !is_array($plan['actions'] ?? null)
+        ) {
+            return null;
+        }
+
+        return $plan;
+    }
+
+    private function loadLog(): void
+    {
+        if ($this->acks !== null) {
+            return;
+        }
+
+        $this->acks = [];
+        $this->fppCommitted = false;
+        $this->committedSchedule = null;
+        $lines = @file($this->logPath(), FILE_IGNORE_NEW_LINES | FILE_SKIP_EMPTY_LINES);
+        if (!is_array($lines)) {
+            return;
+        }
+
+        foreach ($lines as $line) {
+            $row = json_decode($line, true);
+            if (!is_array($row)) {
+                continue;
+            }
+            if (($row['kind'] ?? null) === 'fpp') {
+                $this->fppCommitted = true;
+                $this->committedSchedule = is_string($row['schedule'] ?? null) ? $row['schedule'] : null;
+                continue;
+            }
+            if (
+                ($row['kind'] ?? null) === 'mutation'
+                && is_string($row['key'] ?? null)
+                && is_string($row['providerEventId'] ?? null)
+            ) {
+                $this->acks[$row['key']] = $row['providerEventId'];
+            }
+        }
+    }
+
+    /**
+     * @param array<string,mixed> $row
+     */
+    private function append(array $row): void
+    {
+        // Per-calendar apply workers are forked from the process that owns the
+        // journal; each opens its own handle so the append lock is per process.
+        if (!is_resource($this->log) || $this->logPid !== getmypid()) {
+            $this->ensureDir();
+            $log = @fopen($this->logPath(), 'ab');
+            if ($log === false) {
+                throw new \RuntimeException('ApplyJournal: unable to open ' . $this->logPath());
+            }
+            $this->log = $log;
+            $this->logPid = getmypid();
+        }
+
+        $line = json_encode($row, JSON_THROW_ON_ERROR | JSON_UNESCAPED_SLASHES) . "\n";
+        flock($this->log, LOCK_EX);
+        try {
+            if (@fwrite($this->log, $line) !== strlen($line) || !fflush($this->log)) {
+                throw new \RuntimeException('ApplyJournal: failed to append to ' . $this->logPath());
+            }
+            @fsync($this->log);
+        } finally {
+            flock($this->log, LOCK_UN);
+        }
+    }
+
+    /**
+     * @param array<string,mixed> $doc
+     */
+    private function writeAtomic(string $path, array $doc): void
+    {
+        $this->ensureDir();
+        $json = json_encode($doc, JSON_THROW_ON_ERROR | JSON_UNESCAPED_SLASHES);
+        $tmp = $path . '.' . getmypid() . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $path)) {
+            @unlink($tmp);
+            throw new \RuntimeException('ApplyJournal: unable to write ' . $path);
+        }
+    }
+
+    private function ensureDir(): void
+    {
+        if (!is_dir($this->dir) && !@mkdir($this->dir, 0775, true) && !is_dir($this->dir)) {
+            throw new \RuntimeException('ApplyJournal: unable to create ' . $this->dir);
+        }
+    }
+
+    private function planPath(): string
+    {
+        return rtrim($this->dir, '/') . '/' . self::PLAN_FILE;
+    }
+
+    private function logPath(): string
+    {
+        return rtrim($this->dir, '/') . '/' . self::LOG_FILE;
+    }
+}
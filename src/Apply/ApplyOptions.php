@@ -116,6 +116,14 @@ final class ApplyOptions
         return ($this->writableTargets[$target] ?? false) === true;
     }
 
+    /**
+     * @return array<int,string>
+     */
+    public function writableTargets(): array
+    {
+        return array_keys($this->writableTargets);
+    }
+
     /**
      * @param array<int,string> $targets
      * @return array<string,bool>
@@ -0,0 +1,54 @@
+<?php
+
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Apply/ApplyOutcome.php
+ * Purpose: Record what one ApplyRunner::apply() call actually executed, so the
+ * caller can project the converged state without another engine run.
+ */
+
+namespace CalendarScheduler\Apply;
+
+use CalendarScheduler\Adapter\Calendar\CalendarMutationLink;
+use CalendarScheduler\Diff\ReconciliationAction;
+
+/**
+ * ApplyOutcome
+ *
+ * - manifest: the target manifest as persisted, including the provider event
+ *   ids written back from the calendar mutation links
+ * - links: one per provider mutation sent (or replayed from the journal)
+ * - fppActions / calendarActions: the executable actions that were applied;
+ *   empty for a target that was not written (plan, dry-run, target policy)
+ */
+final class ApplyOutcome
+{
+    /**
+     * @param array<string,mixed> $manifest
+     * @param array<int,CalendarMutationLink> $links
+     * @param array<int,ReconciliationAction> $fppActions
+     * @param array<int,ReconciliationAction> $calendarActions
+     */
+    public function __construct(
+        public readonly array $manifest,
+        public readonly array $links,
+        public readonly array $fppActions,
+        public readonly array $calendarActions,
+        public readonly bool $fppApplied,
+        public readonly bool $calendarApplied
+    ) {}
+
+    /**
+     * @return array<int,ReconciliationAction>
+     */
+    public function appliedActions(): array
+    {
+        return array_merge(
+            $this->fppApplied ? $this->fppActions : [],
+            $this->calendarApplied ? $this->calendarActions : []
+        );
+    }
+}
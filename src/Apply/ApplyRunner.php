@@ -18,12 +18,28 @@ use CalendarScheduler\Adapter\Calendar\CalendarApplyRuntime;
 use CalendarScheduler\Adapter\Calendar\CalendarMutationLink;
 use CalendarScheduler\Adapter\FppScheduleAdapter;
 use CalendarScheduler\Apply\FppScheduleWriter;
+use CalendarScheduler\Platform\Trace;
 
 /**
  * ApplyRunner
  *
  * The ONLY layer allowed to mutate external state.
  * Operates exclusively on executable actions from ReconciliationResult.
+ *
+ * With an ApplyJournal, real applies checkpoint the FPP commit and every
+ * provider mutation; resume() finishes an interrupted apply from its stored
+ * plan, sending only what was not acknowledged.
+ *
+ * The FPP commit and the provider mutation stream run concurrently: the
+ * commit is started non-blocking and pumped between provider mutations, then
+ * both are joined before the manifest is persisted. A failure on either side
+ * still fails the apply and leaves the manifest untouched.
+ *
+ * An optional stage listener receives ($stage, $data) for progress reporting:
+ * fpp_commit (started/done), mutation (done/total) and manifest.
+ *
+ * apply() returns an ApplyOutcome describing what was executed, so callers can
+ * project the post-apply state (see PostApplyProjection) instead of planning again.
  */
 final class ApplyRunner
 {
@@ -31,13 +47,59 @@ final class ApplyRunner
         private readonly ManifestWriter $manifestWriter,
         private readonly ?FppScheduleAdapter $fppAdapter = null,
         private readonly ?FppScheduleWriter $fppWriter = null,
-        private readonly ?CalendarApplyRuntime $calendarRuntime = null
+        private readonly ?CalendarApplyRuntime $calendarRuntime = null,
+        private readonly ?ApplyJournal $journal = null,
+        private readonly ?\Closure $onStage = null
     ) {}
 
+    /**
+     * Finish a previously interrupted apply from the journal, with the targets
+     * it was started with (fail-closed, see ApplyJournal::pendingOptions()).
+     *
+     * Refused when the stored targets go beyond $allowedTargets (the current
+     * sync mode) and, unless $confirmed, when ApplyJournal::resumeBlocker()
+     * reports the plan stale.
+     *
+     * @param array<int,string> $allowedTargets
+     * @return bool False when there was nothing pending
+     */
+    public function resume(array $allowedTargets, bool $confirmed = false): bool
+    {
+        if ($this->journal === null || !$this->journal->hasPending()) {
+            return false;
+        }
+
+        $pending = $this->journal->pendingResult();
+        $options = $this->journal->pendingOptions();
+        if ($pending === null || $options === null) {
+            throw new \RuntimeException(
+                'Resume refused: the apply journal is unreadable or from an older version; discard the pending apply'
+            );
+        }
+
+        $disallowed = array_diff($options->writableTargets(), $allowedTargets);
+        if ($disallowed !== []) {
+            throw new \RuntimeException(
+                'Resume refused: the interrupted apply writes ' . implode(', ', $disallowed)
+                . ', which the current sync mode does not allow; discard the pending apply'
+            );
+        }
+
+        $blocker = $this->journal->resumeBlocker($this->fppWriter?->fingerprint());
+        if ($blocker !== null && !$confirmed) {
+            throw new \RuntimeException(
+                "Resume refused: {$blocker}; confirm to resume anyway or discard the pending apply"
+            );
+        }
+
+        $this->apply($pending, $options);
+        return true;
+    }
+
     public function apply(
         ReconciliationResult $result,
         ApplyOptions $options
-    ): void
+    ): ApplyOutcome
     {
         $targetManifest = $result->targetManifest();
         $executable = $result->executableActions();
@@ -75,9 +137,55 @@ final class ApplyRunner
         $calendarActions = $actionsByTarget[ReconciliationAction::TARGET_CALENDAR];
         $fppApplied = false;
         $calendarApplied = false;
+        $links = [];
+
+        $journal = (!$options->isPlan() && !$options->isDryRun()) ? $this->journal : null;
+        $journal?->begin($result, $options, $this->fppWriter?->fingerprint());
+        $stage = $this->onStage ?? static function (string $stage, array $data = []): void {
+        };
+
+        // In-flight FPP commit; pumped between provider mutations, joined before the manifest write.
+        $fppCommit = null;
+        $fppCommitStartedAt = 0;
+
+        $fppWriter = $this->fppWriter;
+        $joinFpp = static function () use (&$fppCommit, &$fppCommitStartedAt, &$fppApplied, $journal, $fppWriter, $stage): void {
+            if ($fppCommit === null) {
+                return;
+            }
+            $commit = $fppCommit;
+            $fppCommit = null;
+            $commit->wait();
+            Trace::complete(
+                'fpp commit',
+                'apply',
+                $fppCommitStartedAt,
+                Trace::now() - $fppCommitStartedAt,
+                [],
+                Trace::BACKGROUND_LANE
+            );
+            $journal?->markFppCommitted($fppWriter?->fingerprint());
+            $fppApplied = true;
+            $stage('fpp_commit', ['status' => 'done']);
+        };
+        // Also called on every worker-pool poll with unchanged counts; only a
+        // change in progress becomes a 'mutation' stage event.
+        $lastProgress = null;
+        $pumpFpp = static function (int $done = 0, int $total = 0) use (&$fppCommit, &$lastProgress, $joinFpp, $stage): void {
+            if ($total > 0 && $lastProgress !== [$done, $total]) {
+                $lastProgress = [$done, $total];
+                $stage('mutation', ['done' => $done, 'total' => $total]);
+            }
+            if ($fppCommit !== null && $fppCommit->pump()) {
+                $joinFpp();
+            }
+        };
 
         try {
-            if ($fppActions !== []) {
+            if ($fppActions !== [] && $journal?->fppCommitted() === true) {
+                // Resumed apply: schedule.json already holds this plan's target.
+                $fppApplied = true;
+            } elseif ($fppActions !== []) {
                 if ($this->fppAdapter === null || $this->fppWriter === null) {
                     throw new \RuntimeException(
                         'FPP actions present but FppScheduleAdapter and/or FppScheduleWriter not configured'
@@ -145,6 +253,7 @@ final class ApplyRunner
                     }
                 }
 
+                Trace::begin('stage fpp schedule', 'apply', ['entries' => count($singleEvents)]);
                 $scheduleEntries = [];
                 foreach ($this->sortSingleEventsForFppWrite($singleEvents) as $single) {
                     $scheduleEntries[] = $this->fppAdapter->toScheduleEntry($single);
@@ -152,11 +261,14 @@ final class ApplyRunner
 
                 // ALWAYS write staged schedule (even in plan/dry-run)
                 $this->fppWriter->writeStaged($scheduleEntries);
+                Trace::end();
 
-                // Only commit to live schedule.json during real apply
+                // Only commit to live schedule.json during real apply; joined
+                // after the provider mutations below have been sent.
                 if (!$options->isPlan() && !$options->isDryRun()) {
-                    $this->fppWriter->commitStaged();
-                    $fppApplied = true;
+                    $fppCommitStartedAt = Trace::now();
+                    $fppCommit = $this->fppWriter->beginCommitStaged();
+                    $stage('fpp_commit', ['status' => 'started']);
                 }
             }
 
@@ -167,7 +279,26 @@ final class ApplyRunner
                             'Calendar actions present but no CalendarApplyRuntime configured'
                         );
                     }
-                    $links = $this->calendarRuntime->applyActions($calendarActions);
+                    Trace::begin('calendar mutations', 'apply', ['actions' => count($calendarActions)]);
+                    try {
+                        $links = $this->calendarRuntime->applyActions($calendarActions, $journal, $pumpFpp);
+                        Trace::end();
+                    } catch (\Throwable $e) {
+                        Trace::end(['error' => $e->getMessage()]);
+                        // Let an in-flight FPP commit settle (and be journaled)
+                        // before surfacing the provider failure; the provider
+                        // error is the one rethrown, so an FPP failure is logged.
+                        try {
+                            $joinFpp();
+                        } catch (\Throwable $fppError) {
+                            error_log(
+                                'ApplyRunner: FPP schedule commit failed after calendar apply failure:'
+                                . ' fpp_error=' . $fppError->getMessage()
+                                . ' calendar_error=' . $e->getMessage()
+                            );
+                        }
+                        throw $e;
+                    }
                     $targetManifest = $this->applyCalendarMutationLinksToManifest(
                         $targetManifest,
                         $links,
@@ -178,13 +309,28 @@ final class ApplyRunner
                 }
             }
 
+            $joinFpp();
+
             // Persist canonical manifest ONLY during real apply
             if (!$options->isPlan() && !$options->isDryRun()) {
+                Trace::begin('write manifest', 'apply');
                 $this->manifestWriter->applyTargetManifest($targetManifest);
+                Trace::end();
+                $journal?->complete();
+                $stage('manifest');
             }
         } catch (\Throwable $e) {
             throw $e;
         }
+
+        return new ApplyOutcome(
+            $targetManifest,
+            $links,
+            $fppActions,
+            $calendarActions,
+            $fppApplied,
+            $calendarApplied
+        );
     }
 
     /**
@@ -208,7 +354,7 @@ final class ApplyRunner
         }
 
         foreach ($links as $link) {
-            if (!($link instanceof CalendarMutationLink)) {
+            if (!($link instanceof CalendarMutationLink) || $link->op === CalendarMutationLink::OP_DELETE) {
                 continue;
             }
             $id = $link->manifestEventId;
@@ -0,0 +1,168 @@
+<?php
+
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Apply/FppScheduleCommit.php
+ * Purpose: Non-blocking commit of a staged schedule through the FPP schedule
+ * API (backup GET, then POST) driven by curl_multi.
+ */
+
+namespace CalendarScheduler\Apply;
+
+use CalendarScheduler\Platform\Trace;
+
+/**
+ * FppScheduleCommit
+ *
+ * In-flight commit started by FppScheduleWriter::beginCommitStaged().
+ *
+ * - pump() advances the transfers without blocking; ApplyRunner calls it
+ *   between provider mutations so FPP processes the commit concurrently
+ * - wait() blocks until the commit finishes and rethrows any failure
+ *
+ * Steps and failure semantics match the blocking commit: the backup must be
+ * written before the POST is sent, and any HTTP/JSON error fails the commit.
+ */
+final class FppScheduleCommit
+{
+    private const STEP_BACKUP = 'backup';
+    private const STEP_POST = 'post';
+    private const STEP_DONE = 'done';
+
+    private \CurlMultiHandle $multi;
+    private ?\CurlHandle $handle = null;
+    private string $step = self::STEP_BACKUP;
+    private ?\Throwable $failure = null;
+    private int $traceStart = 0;
+
+    public function __construct(
+        private readonly string $apiUrl,
+        private readonly string $stagedJson,
+        private readonly string $backupPath
+    ) {
+        if (!function_exists('curl_multi_init')) {
+            throw new \RuntimeException('FPP schedule API access requires cURL');
+        }
+
+        $this->multi = curl_multi_init();
+        $this->start('GET');
+    }
+
+    public function __destruct()
+    {
+        $this->release();
+        curl_multi_close($this->multi);
+    }
+
+    /**
+     * Advance without blocking.
+     *
+     * @return bool True once the commit has finished (successfully or not)
+     */
+    public function pump(): bool
+    {
+        if ($this->step === self::STEP_DONE) {
+            return true;
+        }
+
+        try {
+            do {
+                $status = curl_multi_exec($this->multi, $running);
+            } while ($status === CURLM_CALL_MULTI_PERFORM);
+
+            if ($status !== CURLM_OK) {
+                throw new \RuntimeException('FPP schedule API transfer failed: ' . curl_multi_strerror($status));
+            }
+
+            while (($info = curl_multi_info_read($this->multi)) !== false) {
+                $this->onTransferDone((int)$info['result']);
+            }
+        } catch (\Throwable $e) {
+            $this->failure = $e;
+            $this->step = self::STEP_DONE;
+            $this->release();
+        }
+
+        return $this->step === self::STEP_DONE;
+    }
+
+    /**
+     * Block until finished; throws if the commit failed.
+     */
+    public function wait(): void
+    {
+        while (!$this->pump()) {
+            curl_multi_select($this->multi, 0.25);
+        }
+
+        if ($this->failure !== null) {
+            throw $this->failure;
+        }
+    }
+
+    private function onTransferDone(int $curlResult): void
+    {
+        if ($this->handle === null) {
+            return;
+        }
+
+        $method = $this->step === self::STEP_BACKUP ? 'GET' : 'POST';
+        $rawBody = curl_multi_getcontent($this->handle);
+        Trace::http(
+            $this->handle,
+            $method . ' fpp schedule',
+            $this->traceStart,
+            ['method' => $method, 'step' => $this->step],
+            Trace::BACKGROUND_LANE
+        );
+        $httpCode = (int)curl_getinfo($this->handle, CURLINFO_HTTP_CODE);
+        $curlError = $curlResult !== CURLE_OK ? curl_strerror($curlResult) : '';
+        $this->release();
+
+        $payload = FppScheduleWriter::decodeApiResponse(
+            $method,
+            $curlResult === CURLE_OK ? $rawBody : null,
+            $httpCode,
+            $curlError
+        );
+
+        if ($this->step === self::STEP_BACKUP) {
+            $current = FppScheduleWriter::scheduleListFromPayload($payload);
+            $backupJson = json_encode($current, JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR);
+            if (@file_put_contents($this->backupPath, (string)$backupJson . PHP_EOL, LOCK_EX) === false) {
+                throw new \RuntimeException('Failed to create schedule backup: ' . $this->backupPath);
+            }
+
+            $this->step = self::STEP_POST;
+            $this->start('POST');
+            return;
+        }
+
+        $this->step = self::STEP_DONE;
+    }
+
+    private function start(string $method): void
+    {
+        $ch = curl_init($this->apiUrl);
+        if ($ch === false) {
+            throw new \RuntimeException('Unable to initialize cURL for FPP schedule API');
+        }
+
+        curl_setopt_array($ch, FppScheduleWriter::requestOptions($method, $method === 'POST' ? $this->stagedJson : null));
+        curl_multi_add_handle($this->multi, $ch);
+        $this->handle = $ch;
+        $this->traceStart = Trace::now();
+    }
+
+    private function release(): void
+    {
+        if ($this->handle !== null) {
+            curl_multi_remove_handle($this->multi, $this->handle);
+            curl_close($this->handle);
+            $this->handle = null;
+        }
+    }
+}
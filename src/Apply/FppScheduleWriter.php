@@ -11,20 +11,24 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Apply;
 
+use CalendarScheduler\Platform\Trace;
+
 /**
  * FppScheduleWriter
  *
  * Reads/writes schedule.json via FPP REST API.
  *
  * Runtime behavior:
- * - Read via GET /api/schedule
+ * - Read schedule.json directly when readable, else via GET /api/schedule
  * - Write via POST /api/schedule
  * - Keep staged and backup artifacts in plugin staging directory
+ * - Commits can run non-blocking (beginCommitStaged) alongside provider writes
  */
 final class FppScheduleWriter
 {
     private const FPP_SCHEDULE_API_URL = 'http://127.0.0.1/api/schedule';
 
+    private string $schedulePath;
     private string $stagingDirectory;
 
     public function __construct(string $schedulePath, string $stagingDirectory)
@@ -40,6 +44,7 @@ final class FppScheduleWriter
             throw new \InvalidArgumentException('stagingDirectory must not be empty');
         }
 
+        $this->schedulePath = $schedulePath;
         $this->stagingDirectory = $stagingDirectory;
     }
 
@@ -48,7 +53,17 @@ final class FppScheduleWriter
      */
     public function load(): array
     {
-        return $this->loadViaApi();
+        return $this->loadFromFile() ?? $this->loadViaApi();
+    }
+
+    /**
+     * Content hash of the live schedule.json, or null when it cannot be read
+     * (apply journal staleness check).
+     */
+    public function fingerprint(): ?string
+    {
+        $raw = is_file($this->schedulePath) ? @file_get_contents($this->schedulePath) : false;
+        return is_string($raw) ? hash('sha256', $raw) : null;
     }
 
     /**
@@ -92,6 +107,17 @@ final class FppScheduleWriter
      * - Atomically replaces live schedule.json
      */
     public function commitStaged(): void
+    {
+        $this->beginCommitStaged()->wait();
+    }
+
+    /**
+     * Start committing the staged schedule without blocking.
+     *
+     * The returned commit must be pumped/waited by the caller; the backup GET
+     * and the POST run as curl_multi transfers.
+     */
+    public function beginCommitStaged(): FppScheduleCommit
     {
         $stagedPath = $this->stagingDirectory . '/schedule.staged.json';
         $backupPath = $this->stagingDirectory . '/schedule.backup.json';
@@ -100,50 +126,71 @@ final class FppScheduleWriter
             throw new \RuntimeException('No staged schedule to commit: ' . $stagedPath);
         }
 
-        $this->commitStagedViaApi($stagedPath, $backupPath);
+        $stagedJson = file_get_contents($stagedPath);
+        if (!is_string($stagedJson) || trim($stagedJson) === '') {
+            throw new \RuntimeException('Failed to read staged schedule payload: ' . $stagedPath);
+        }
+
+        $decodedStaged = json_decode($stagedJson, true, 512, JSON_THROW_ON_ERROR);
+        if (!is_array($decodedStaged) || !array_is_list($decodedStaged)) {
+            throw new \RuntimeException('Staged schedule JSON must be a list payload');
+        }
+
+        // Preserve the same local backup artifact behavior as file-mode commit.
+        return new FppScheduleCommit(self::FPP_SCHEDULE_API_URL, $stagedJson, $backupPath);
     }
 
     /**
-     * @return array<int,array<string,mixed>>
+     * @return array<int,array<string,mixed>>|null null when the file cannot be read
      */
-    private function loadViaApi(): array
+    private function loadFromFile(): ?array
     {
-        $payload = $this->requestScheduleApi('GET');
-        if ($payload === []) {
-            return [];
+        if (!is_file($this->schedulePath) || !is_readable($this->schedulePath)) {
+            return null;
         }
 
-        if (array_is_list($payload)) {
-            return $payload;
+        $raw = @file_get_contents($this->schedulePath);
+        if (!is_string($raw)) {
+            return null;
         }
 
-        if (isset($payload['schedule']) && is_array($payload['schedule']) && array_is_list($payload['schedule'])) {
-            return $payload['schedule'];
+        $decoded = json_decode($raw, true);
+        if (!is_array($decoded) || !array_is_list($decoded)) {
+            throw new \RuntimeException('FPP schedule file has invalid payload shape: ' . $this->schedulePath);
         }
 
-        throw new \RuntimeException('FPP schedule API returned unexpected payload shape');
+        return $decoded;
     }
 
-    private function commitStagedViaApi(string $stagedPath, string $backupPath): void
+    /**
+     * @return array<int,array<string,mixed>>
+     */
+    private function loadViaApi(): array
     {
-        $stagedJson = file_get_contents($stagedPath);
-        if (!is_string($stagedJson) || trim($stagedJson) === '') {
-            throw new \RuntimeException('Failed to read staged schedule payload: ' . $stagedPath);
+        return self::scheduleListFromPayload($this->requestScheduleApi('GET'));
+    }
+
+    /**
+     * Extract the schedule row list from a GET /api/schedule payload.
+     *
+     * @param array<string,mixed>|array<int,array<string,mixed>> $payload
+     * @return array<int,array<string,mixed>>
+     */
+    public static function scheduleListFromPayload(array $payload): array
+    {
+        if ($payload === []) {
+            return [];
         }
 
-        $decodedStaged = json_decode($stagedJson, true, 512, JSON_THROW_ON_ERROR);
-        if (!is_array($decodedStaged) || !array_is_list($decodedStaged)) {
-            throw new \RuntimeException('Staged schedule JSON must be a list payload');
+        if (array_is_list($payload)) {
+            return $payload;
         }
 
-        // Preserve the same local backup artifact behavior as file-mode commit.
-        $current = $this->loadViaApi();
-        $backupJson = json_encode($current, JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR);
-        if (@file_put_contents($backupPath, (string)$backupJson . PHP_EOL, LOCK_EX) === false) {
-            throw new \RuntimeException('Failed to create schedule backup: ' . $backupPath);
+        if (isset($payload['schedule']) && is_array($payload['schedule']) && array_is_list($payload['schedule'])) {
+            return $payload['schedule'];
         }
 
-        $this->requestScheduleApi('POST', $stagedJson);
+        throw new \RuntimeException('FPP schedule API returned unexpected payload shape');
     }
 
     /**
@@ -160,6 +207,25 @@ final class FppScheduleWriter
             throw new \RuntimeException('Unable to initialize cURL for FPP schedule API');
         }
 
+        curl_setopt_array($ch, self::requestOptions($method, $jsonBody));
+
+        $traceStart = Trace::now();
+        $rawBody = curl_exec($ch);
+        Trace::http($ch, $method . ' fpp schedule', $traceStart, ['method' => $method]);
+        $httpCode = (int)curl_getinfo($ch, CURLINFO_HTTP_CODE);
+        $curlError = curl_error($ch);
+        curl_close($ch);
+
+        return self::decodeApiResponse($method, $rawBody, $httpCode, $curlError);
+    }
+
+    /**
+     * cURL options for one schedule API request (shared with FppScheduleCommit).
+     *
+     * @return array<int,mixed>
+     */
+    public static function requestOptions(string $method, ?string $jsonBody = null): array
+    {
         $opts = [
             CURLOPT_RETURNTRANSFER => true,
             CURLOPT_TIMEOUT => 20,
@@ -175,13 +241,16 @@ final class FppScheduleWriter
             $opts[CURLOPT_HTTPGET] = true;
         }
 
-        curl_setopt_array($ch, $opts);
-
-        $rawBody = curl_exec($ch);
-        $httpCode = (int)curl_getinfo($ch, CURLINFO_HTTP_CODE);
-        $curlError = curl_error($ch);
-        curl_close($ch);
+        return $opts;
+    }
 
+    /**
+     * Validate a schedule API response and decode its JSON body.
+     *
+     * @return array<string,mixed>|array<int,array<string,mixed>>
+     */
+    public static function decodeApiResponse(string $method, mixed $rawBody, int $httpCode, string $curlError): array
+    {
         if (!is_string($rawBody)) {
             $err = $curlError !== '' ? $curlError : 'request failed';
             throw new \RuntimeException("FPP schedule API {$method} failed: {$err}");
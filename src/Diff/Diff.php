@@ -41,24 +41,24 @@ final class Diff
     /**
      * Diff two manifest documents.
      *
-     * @param array<string,mixed> $nextManifest Desired manifest (next)
-     * @param array<string,mixed> $currentManifest Current manifest (previous)
+     * Either side may be passed pre-indexed so callers that already hold an
+     * IndexedManifest (the engine) do not pay for a second indexing pass.
+     *
+     * @param array<string,mixed>|IndexedManifest $nextManifest Desired manifest (next)
+     * @param array<string,mixed>|IndexedManifest $currentManifest Current manifest (previous)
      */
-    public function diff(array $nextManifest, array $currentManifest): DiffResult
+    public function diff(array|IndexedManifest $nextManifest, array|IndexedManifest $currentManifest): DiffResult
     {
-        $nextById = $this->indexEventsByIdentity($nextManifest);
-        $currentById = $this->indexEventsByIdentity($currentManifest);
+        $next = IndexedManifest::of($nextManifest);
+        $current = IndexedManifest::of($currentManifest);
 
         // Enforce unmanaged collision rule:
         // If an identity exists in current as unmanaged, next must NOT attempt to manage it.
-        foreach ($currentById as $id => $cur) {
-            if (!$this->isManagedEvent($cur)) {
-                $next = $nextById[$id] ?? null;
-                if ($next !== null && $this->isManagedEvent($next)) {
-                    throw new \RuntimeException(
-                        'Managed/unmanaged collision: next attempts to manage an unmanaged identity: ' . $id
-                    );
-                }
+        foreach ($current->ids() as $id) {
+            if (!$current->isManaged($id) && $next->isManaged($id)) {
+                throw new \RuntimeException(
+                    'Managed/unmanaged collision: next attempts to manage an unmanaged identity: ' . $id
+                );
             }
         }
 
@@ -67,39 +67,34 @@ final class Diff
         $deletes = [];
 
         // Creates & Updates (managed only)
-        foreach ($nextById as $id => $nextEvent) {
-            if (!$this->isManagedEvent($nextEvent)) {
+        foreach ($next->events() as $id => $nextEvent) {
+            if (!$next->isManaged($id)) {
                 continue;
             }
 
-            $curEvent = $currentById[$id] ?? null;
-
-            if ($curEvent === null) {
+            if (!$current->has($id)) {
                 $creates[] = $nextEvent;
                 continue;
             }
 
             // If current is unmanaged and next is managed, collision was already handled above.
-            if (!$this->isManagedEvent($curEvent)) {
+            if (!$current->isManaged($id)) {
                 continue;
             }
 
-            $nextState = $this->readEventStateHash($nextEvent);
-            $curState = $this->readEventStateHash($curEvent);
-
-            if ($nextState !== $curState) {
+            if ($this->readEventStateHash($next, $id) !== $this->readEventStateHash($current, $id)) {
                 $updates[] = $nextEvent;
             }
         }
 
         // Deletes (managed only)
-        foreach ($currentById as $id => $curEvent) {
-            if (!$this->isManagedEvent($curEvent)) {
+        foreach ($current->events() as $id => $curEvent) {
+            if (!$current->isManaged($id)) {
                 continue;
             }
 
             // If desired state does not include this identity => delete
-            if (!isset($nextById[$id])) {
+            if (!$next->has($id)) {
                 $deletes[] = $curEvent;
             }
         }
@@ -118,92 +113,6 @@ final class Diff
         return new DiffResult($creates, $updates, $deletes);
     }
 
-    /**
-     * Index manifest events by canonical identity key.
-     *
-     * Supported shapes:
-     * - { "events": { "<id>": { ...event... }, ... } }
-     * - { "events": [ { ...event... }, ... ] }  (rare; tolerated)
-     *
-     * Identity key resolution (in order):
-     * - manifest.events key if associative
-     * - event.id
-     * - event.identityHash
-     *
-     * @param array<string,mixed> $manifest
-     * @return array<string,array<string,mixed>>
-     */
-    private function indexEventsByIdentity(array $manifest): array
-    {
-        $map = [];
-
-        $events = $manifest['events'] ?? [];
-        if (!is_array($events)) {
-            return $map;
-        }
-
-        // If events is a list, derive identity from event fields.
-        $isList = array_keys($events) === range(0, count($events) - 1);
-        if ($isList) {
-            foreach ($events as $i => $event) {
-                if (!is_array($event)) {
-                    continue;
-                }
-                $id = $this->readEventIdentityKey($event, null);
-                if ($id === '') {
-                    throw new \RuntimeException('Manifest event missing identity key at events[' . $i . ']');
-                }
-                if (isset($map[$id])) {
-                    throw new \RuntimeException('Duplicate manifest identity detected: ' . $id);
-                }
-                $map[$id] = $event;
-            }
-            return $map;
-        }
-
-        // Associative map keyed by id
-        foreach ($events as $eventKey => $event) {
-            if (!is_array($event)) {
-                continue;
-            }
-            $id = $this->readEventIdentityKey($event, is_string($eventKey) ? $eventKey : null);
-            if ($id === '') {
-                throw new \RuntimeException('Manifest event missing identity key at events[' . (string)$eventKey . ']');
-            }
-            if (isset($map[$id])) {
-                throw new \RuntimeException('Duplicate manifest identity detected: ' . $id);
-            }
-            $map[$id] = $event;
-        }
-
-        return $map;
-    }
-
-    private function readEventIdentityKey(array $event, ?string $fallbackKey): string
-    {
-        if (is_string($fallbackKey) && trim($fallbackKey) !== '') {
-            return trim($fallbackKey);
-        }
-        $id = $event['id'] ?? null;
-        if (is_string($id) && trim($id) !== '') {
-            return trim($id);
-        }
-        $id2 = $event['identityHash'] ?? null;
-        if (is_string($id2) && trim($id2) !== '') {
-            return trim($id2);
-        }
-        return '';
-    }
-
-    private function isManagedEvent(array $event): bool
-    {
-        $ownership = $event['ownership'] ?? null;
-        if (!is_array($ownership)) {
-            return false;
-        }
-        return (bool)($ownership['managed'] ?? false);
-    }
-
     /**
      * Read the event-level stateHash.
      *
@@ -211,18 +120,13 @@ final class Diff
      * - stateHash MUST exist for managed events during Phase 4
      * - unmanaged events may omit it (ignored for mutation)
      */
-    private function readEventStateHash(array $event): string
+    private function readEventStateHash(IndexedManifest $manifest, string $id): string
     {
-        $v = $event['stateHash'] ?? null;
-        if (is_string($v) && trim($v) !== '') {
-            return trim($v);
-        }
-
-        if ($this->isManagedEvent($event)) {
-            $id = (string)($event['id'] ?? $event['identityHash'] ?? '');
+        $v = $manifest->stateHash($id);
+        if ($v === '' && $manifest->isManaged($id)) {
             throw new \RuntimeException('Managed manifest event missing stateHash: ' . $id);
         }
 
-        return '';
+        return $v;
     }
 }
@@ -0,0 +1,277 @@
+<?php
+
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Diff/IndexedManifest.php
+ * Purpose: Immutable identity-indexed view of a manifest document, built once
+ * per run and shared by Diff, Reconciler, the engine and UI shaping.
+ */
+
+namespace CalendarScheduler\Diff;
+
+/**
+ * IndexedManifest
+ *
+ * Indexes manifest events by canonical identity key in a single pass and
+ * records the per-event facts every consumer re-derived on its own:
+ *  - managed / locked / archived ownership flags
+ *  - event-level stateHash ('' when absent)
+ *  - replacement signature (computed on first use, then memoized)
+ *
+ * Supported shapes:
+ * - { "events": { "<id>": { ...event... }, ... } }
+ * - { "events": [ { ...event... }, ... ] }  (rare; tolerated)
+ *
+ * Identity key resolution (in order):
+ * - manifest.events key if associative
+ * - event.id
+ * - event.identityHash
+ *
+ * Missing or duplicate identities are hard failures, as they were in the
+ * per-consumer indexers this replaces.
+ */
+final class IndexedManifest
+{
+    /** @var array<string,?string> Lazily filled replacement signatures */
+    private array $signatures = [];
+
+    /**
+     * @param array<string,array<string,mixed>> $events
+     * @param array<string,true> $managed
+     * @param array<string,true> $locked
+     * @param array<string,true> $archived
+     * @param array<string,string> $stateHashes
+     */
+    private function __construct(
+        private readonly array $events,
+        private readonly array $managed,
+        private readonly array $locked,
+        private readonly array $archived,
+        private readonly array $stateHashes
+    ) {}
+
+    /**
+     * Accept either a raw manifest document or an existing index.
+     *
+     * @param array<string,mixed>|self $manifest
+     */
+    public static function of(array|self $manifest): self
+    {
+        return $manifest instanceof self ? $manifest : self::fromManifest($manifest);
+    }
+
+    /**
+     * @param array<string,mixed> $manifest
+     */
+    public static function fromManifest(array $manifest): self
+    {
+        $map = [];
+        $events = $manifest['events'] ?? [];
+        if (!is_array($events)) {
+            $events = [];
+        }
+
+        $isList = array_is_list($events);
+        foreach ($events as $eventKey => $event) {
+            if (!is_array($event)) {
+                continue;
+            }
+            $id = self::readEventIdentityKey($event, !$isList && is_string($eventKey) ? $eventKey : null);
+            if ($id === '') {
+                throw new \RuntimeException('Manifest event missing identity key at events[' . (string)$eventKey . ']');
+            }
+            if (isset($map[$id])) {
+                throw new \RuntimeException('Duplicate manifest identity detected: ' . $id);
+            }
+            $map[$id] = $event;
+        }
+
+        $managed = [];
+        $locked = [];
+        $archived = [];
+        $stateHashes = [];
+        foreach ($map as $id => $event) {
+            $ownership = is_array($event['ownership'] ?? null) ? $event['ownership'] : [];
+            if ((bool)($ownership['managed'] ?? false)) {
+                $managed[$id] = true;
+            }
+            if ((bool)($ownership['locked'] ?? false)) {
+                $locked[$id] = true;
+            }
+            if (($event['archived'] ?? false) === true) {
+                $archived[$id] = true;
+            }
+            $v = $event['stateHash'] ?? null;
+            $stateHashes[$id] = is_string($v) ? trim($v) : '';
+        }
+
+        return new self($map, $managed, $locked, $archived, $stateHashes);
+    }
+
+    /**
+     * Derived index without the given identities; no events are re-read.
+     *
+     * @param array<string,mixed> $ids identity => any
+     */
+    public function without(array $ids): self
+    {
+        if ($ids === []) {
+            return $this;
+        }
+
+        $out = new self(
+            array_diff_key($this->events, $ids),
+            array_diff_key($this->managed, $ids),
+            array_diff_key($this->locked, $ids),
+            array_diff_key($this->archived, $ids),
+            array_diff_key($this->stateHashes, $ids)
+        );
+        $out->signatures = array_diff_key($this->signatures, $ids);
+        return $out;
+    }
+
+    /**
+     * @return array<string,array<string,mixed>> identity => event
+     */
+    public function events(): array
+    {
+        return $this->events;
+    }
+
+    /**
+     * @return array<int,string>
+     */
+    public function ids(): array
+    {
+        return array_keys($this->events);
+    }
+
+    public function count(): int
+    {
+        return count($this->events);
+    }
+
+    public function has(string $id): bool
+    {
+        return isset($this->events[$id]);
+    }
+
+    /**
+     * @return array<string,mixed>|null
+     */
+    public function get(string $id): ?array
+    {
+        return $this->events[$id] ?? null;
+    }
+
+    public function isManaged(string $id): bool
+    {
+        return isset($this->managed[$id]);
+    }
+
+    /**
+     * Locked is enforced only from CURRENT manifest.
+     */
+    public function isLocked(string $id): bool
+    {
+        return isset($this->locked[$id]);
+    }
+
+    /**
+     * Archived is set by the engine on current-manifest events that ended
+     * before the calendar sync horizon.
+     */
+    public function isArchived(string $id): bool
+    {
+        return isset($this->archived[$id]);
+    }
+
+    /**
+     * Trimmed event-level stateHash, or '' when absent/unknown.
+     */
+    public function stateHash(string $id): string
+    {
+        return $this->stateHashes[$id] ?? '';
+    }
+
+    /**
+     * Signature for pairing cross-identity replacements, or null when the
+     * event lacks a type/target (or is not indexed).
+     *
+     * Deliberately excludes start_date/end_date so date-anchoring changes (e.g. holiday
+     * symbolic vs override hard date) can still be matched as the same logical stream.
+     */
+    public function replacementSignature(string $id): ?string
+    {
+        if (!array_key_exists($id, $this->signatures)) {
+            $event = $this->events[$id] ?? null;
+            $this->signatures[$id] = is_array($event) ? self::computeReplacementSignature($event) : null;
+        }
+
+        return $this->signatures[$id];
+    }
+
+    /**
+     * @param array<string,mixed> $event
+     */
+    private static function readEventIdentityKey(array $event, ?string $fallbackKey): string
+    {
+        if (is_string($fallbackKey) && trim($fallbackKey) !== '') {
+            return trim($fallbackKey);
+        }
+        $id = $event['id'] ?? null;
+        if (is_string($id) && trim($id) !== '') {
+            return trim($id);
+        }
+        $id2 = $event['identityHash'] ?? null;
+        if (is_string($id2) && trim($id2) !== '') {
+            return trim($id2);
+        }
+        return '';
+    }
+
+    /**
+     * @param array<string,mixed> $event
+     */
+    private static function computeReplacementSignature(array $event): ?string
+    {
+        $identity = is_array($event['identity'] ?? null) ? $event['identity'] : [];
+        $firstSub = (is_array($event['subEvents'] ?? null) && isset($event['subEvents'][0]) && is_array($event['subEvents'][0]))
+            ? $event['subEvents'][0]
+            : [];
+        $identityTiming = is_array($identity['timing'] ?? null) ? $identity['timing'] : [];
+        $subTiming = is_array($firstSub['timing'] ?? null) ? $firstSub['timing'] : [];
+        $timing = $identityTiming !== [] ? $identityTiming : $subTiming;
+
+        $target = $identity['target'] ?? ($event['target'] ?? null);
+        $type = $identity['type'] ?? ($event['type'] ?? null);
+        if (!is_string($target) || trim($target) === '' || !is_string($type) || trim($type) === '') {
+            return null;
+        }
+
+        $startTime = is_array($timing['start_time'] ?? null) ? $timing['start_time'] : [];
+        $endTime = is_array($timing['end_time'] ?? null) ? $timing['end_time'] : [];
+        if ($endTime === []) {
+            $endTime = $startTime;
+        }
+        $days = is_array($timing['days'] ?? null) ? $timing['days'] : null;
+
+        $payload = [
+            'type' => strtolower(trim($type)),
+            'target' => trim($target),
+            'all_day' => (bool)($timing['all_day'] ?? false),
+            'start_time_hard' => is_string($startTime['hard'] ?? null) ? trim((string)$startTime['hard']) : null,
+            'start_time_symbolic' => is_string($startTime['symbolic'] ?? null) ? trim((string)$startTime['symbolic']) : null,
+            'start_time_offset' => (int)($startTime['offset'] ?? 0),
+            'end_time_hard' => is_string($endTime['hard'] ?? null) ? trim((string)$endTime['hard']) : null,
+            'end_time_symbolic' => is_string($endTime['symbolic'] ?? null) ? trim((string)$endTime['symbolic']) : null,
+            'end_time_offset' => (int)($endTime['offset'] ?? 0),
+            'days' => $days,
+        ];
+
+        return hash('sha256', json_encode($payload, JSON_THROW_ON_ERROR));
+    }
+}
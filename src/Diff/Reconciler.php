@@ -11,6 +11,8 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Diff;
 
+use CalendarScheduler\Platform\HashScheme;
+
 /**
  * Phase 4 — Reconciler
  *
@@ -35,52 +37,58 @@ final class Reconciler
     /**
      * Reconcile two candidate manifests into a target manifest and an action plan.
      *
-     * @param array<string,mixed> $calendarManifest
-     * @param array<string,mixed> $fppManifest
-     * @param array<string,mixed> $currentManifest The last applied manifest (for managed/unmanaged/locked rules)
+     * Manifests may be passed pre-indexed (IndexedManifest) to share one
+     * indexing pass with Diff and the engine.
+     *
+     * @param array<string,mixed>|IndexedManifest $calendarManifest
+     * @param array<string,mixed>|IndexedManifest $fppManifest
+     * @param array<string,mixed>|IndexedManifest $currentManifest The last applied manifest (for managed/unmanaged/locked rules)
      * @param array<string,int>   $calendarUpdatedAtById identityHash => epoch seconds (event updatedAt)
      * @param array<string,int>   $fppUpdatedAtById      identityHash => epoch seconds (event updatedAt; may be schedule.json mtime)
      * @param array{calendar:array<string,int>,fpp:array<string,int>} $tombstonesBySource
      * @param int $calendarSnapshotEpoch epoch seconds when calendar snapshot was taken (absence timestamp proxy)
      * @param int $fppSnapshotEpoch      epoch seconds when fpp snapshot was taken (absence timestamp proxy)
+     * @param string|array<int,string> $calendarScope active calendar id, or every synced calendar id (primary first)
      */
     public function reconcile(
-        array $calendarManifest,
-        array $fppManifest,
-        array $currentManifest,
+        array|IndexedManifest $calendarManifest,
+        array|IndexedManifest $fppManifest,
+        array|IndexedManifest $currentManifest,
         array $calendarUpdatedAtById,
         array $fppUpdatedAtById,
         array $tombstonesBySource,
         int $calendarSnapshotEpoch,
         int $fppSnapshotEpoch,
         string $syncMode = self::MODE_BOTH,
-        string $calendarScope = 'default'
+        string|array $calendarScope = 'default'
     ): ReconciliationResult {
         $syncMode = $this->normalizeMode($syncMode);
-        $calendarScope = trim($calendarScope) !== '' ? trim($calendarScope) : 'default';
-        $cal = $this->indexEventsByIdentity($calendarManifest);
-        $fpp = $this->indexEventsByIdentity($fppManifest);
-        $cur = $this->indexEventsByIdentity($currentManifest);
+        $calendarScopes = $this->normalizeCalendarScopes($calendarScope);
+        $calIndex = IndexedManifest::of($calendarManifest);
+        $fppIndex = IndexedManifest::of($fppManifest);
+        $curIndex = IndexedManifest::of($currentManifest);
+        $cal = $calIndex->events();
+        $fpp = $fppIndex->events();
+        $cur = $curIndex->events();
 
         // Safety guard applies only to two-way mode. In one-way mirror modes,
         // zero overlap is a normal state (for example after calendar switching).
         if ($syncMode === self::MODE_BOTH && $cal !== [] && $fpp !== []) {
-            $sharedIds = array_intersect(array_keys($cal), array_keys($fpp));
-            if ($sharedIds === []) {
+            if (array_intersect_key($cal, $fpp) === []) {
                 throw new \RuntimeException(
                     'Reconciler safety stop: calendar and FPP manifests have zero shared identity hashes; refusing destructive convergence plan'
                 );
             }
         }
 
-        $allIds = array_unique(array_merge(array_keys($cal), array_keys($fpp), array_keys($cur)));
+        $allIds = array_keys($cal + $fpp + $cur);
         sort($allIds);
 
         if ($syncMode === self::MODE_BOTH) {
             $tombstonesBySource = $this->inferCrossIdentityTombstones(
                 $allIds,
-                $cal,
-                $fpp,
+                $calIndex,
+                $fppIndex,
                 $calendarUpdatedAtById,
                 $fppUpdatedAtById,
                 $tombstonesBySource,
@@ -99,7 +107,7 @@ final class Reconciler
 
             // Preserve unmanaged/locked invariants based on CURRENT manifest
             if ($curEvent !== null) {
-                if ($this->isLockedEvent($curEvent)) {
+                if ($curIndex->isLocked($id)) {
                     // locked: never mutate; keep current in target
                     $targetEvents[$id] = $curEvent;
                     $actions[] = new ReconciliationAction(
@@ -112,7 +120,7 @@ final class Reconciler
                     );
                     continue;
                 }
-                if (!$this->isManagedEvent($curEvent)) {
+                if (!$curIndex->isManaged($id)) {
                     // unmanaged: never mutate; keep current in target
                     $targetEvents[$id] = $curEvent;
                     $actions[] = new ReconciliationAction(
@@ -125,6 +133,19 @@ final class Reconciler
                     );
                     continue;
                 }
+                if ($curIndex->isArchived($id) && $calEvent === null) {
+                    // archived: ended before the sync horizon; frozen as-is
+                    $targetEvents[$id] = $curEvent;
+                    $actions[] = new ReconciliationAction(
+                        ReconciliationAction::TYPE_NOOP,
+                        ReconciliationAction::TARGET_FPP,
+                        ReconciliationAction::AUTHORITY_FPP,
+                        $id,
+                        'archived: preserved current manifest event (before sync horizon)',
+                        $curEvent
+                    );
+                    continue;
+                }
             }
 
             // If both sources have no opinion and current doesn't exist, skip.
@@ -154,7 +175,7 @@ final class Reconciler
                     $tombstonesBySource,
                     $calendarSnapshotEpoch,
                     $fppSnapshotEpoch,
-                    $calendarScope
+                    $calendarScopes
                 );
 
                 $winner = $decision['winner']; // 'calendar'|'fpp'
@@ -165,7 +186,7 @@ final class Reconciler
             if (is_array($winningEvent)) {
                 $winningEvent = $this->carryCurrentProviderCorrelation($winningEvent, $curEvent);
                 $winningEvent = $this->carryCalendarProviderCorrelation($winningEvent, $calEvent);
-                $winningEvent = $this->assignActiveCalendarScope($winningEvent, $calendarScope);
+                $winningEvent = $this->assignActiveCalendarScope($winningEvent, $calEvent, $calendarScopes);
             }
 
             // Build target manifest events
@@ -186,6 +207,7 @@ final class Reconciler
         }
 
         $targetManifest = [
+            'hashScheme' => HashScheme::active(),
             'events' => $targetEvents,
         ];
 
@@ -214,8 +236,6 @@ final class Reconciler
      * logical event after one side reshapes recurrence/override identity.
      *
      * @param array<int,string> $allIds
-     * @param array<string,array<string,mixed>> $cal
-     * @param array<string,array<string,mixed>> $fpp
      * @param array<string,int> $calUpdatedAtById
      * @param array<string,int> $fppUpdatedAtById
      * @param array{calendar:array<string,int>,fpp:array<string,int>} $tombstonesBySource
@@ -223,8 +243,8 @@ final class Reconciler
      */
     private function inferCrossIdentityTombstones(
         array $allIds,
-        array $cal,
-        array $fpp,
+        IndexedManifest $cal,
+        IndexedManifest $fpp,
         array $calUpdatedAtById,
         array $fppUpdatedAtById,
         array $tombstonesBySource,
@@ -234,8 +254,8 @@ final class Reconciler
         $calOnly = [];
         $fppOnly = [];
         foreach ($allIds as $id) {
-            $calEvent = $cal[$id] ?? null;
-            $fppEvent = $fpp[$id] ?? null;
+            $calEvent = $cal->get($id);
+            $fppEvent = $fpp->get($id);
             if ($calEvent !== null && $fppEvent === null) {
                 $calOnly[$id] = $calEvent;
                 continue;
@@ -250,8 +270,8 @@ final class Reconciler
         }
 
         $fppBySignature = [];
-        foreach ($fppOnly as $id => $event) {
-            $sig = $this->replacementSignature($event);
+        foreach (array_keys($fppOnly) as $id) {
+            $sig = $fpp->replacementSignature($id);
             if ($sig === null) {
                 continue;
             }
@@ -263,7 +283,7 @@ final class Reconciler
 
         $usedFppIds = [];
         foreach ($calOnly as $calId => $calEvent) {
-            $sig = $this->replacementSignature($calEvent);
+            $sig = $cal->replacementSignature($calId);
             if ($sig === null || !isset($fppBySignature[$sig])) {
                 continue;
             }
@@ -308,53 +328,6 @@ final class Reconciler
         return $tombstonesBySource;
     }
 
-    /**
-     * Build a signature for pairing cross-identity replacements.
-     *
-     * Deliberately excludes start_date/end_date so date-anchoring changes (e.g. holiday
-     * symbolic vs override hard date) can still be matched as the same logical stream.
-     *
-     * @param array<string,mixed> $event
-     */
-    private function replacementSignature(array $event): ?string
-    {
-        $identity = is_array($event['identity'] ?? null) ? $event['identity'] : [];
-        $firstSub = (is_array($event['subEvents'] ?? null) && isset($event['subEvents'][0]) && is_array($event['subEvents'][0]))
-            ? $event['subEvents'][0]
-            : [];
-        $identityTiming = is_array($identity['timing'] ?? null) ? $identity['timing'] : [];
-        $subTiming = is_array($firstSub['timing'] ?? null) ? $firstSub['timing'] : [];
-        $timing = $identityTiming !== [] ? $identityTiming : $subTiming;
-
-        $target = $identity['target'] ?? ($event['target'] ?? null);
-        $type = $identity['type'] ?? ($event['type'] ?? null);
-        if (!is_string($target) || trim($target) === '' || !is_string($type) || trim($type) === '') {
-            return null;
-        }
-
-        $startTime = is_array($timing['start_time'] ?? null) ? $timing['start_time'] : [];
-        $endTime = is_array($timing['end_time'] ?? null) ? $timing['end_time'] : [];
-        if ($endTime === []) {
-            $endTime = $startTime;
-        }
-        $days = is_array($timing['days'] ?? null) ? $timing['days'] : null;
-
-        $payload = [
-            'type' => strtolower(trim($type)),
-            'target' => trim($target),
-            'all_day' => (bool)($timing['all_day'] ?? false),
-            'start_time_hard' => is_string($startTime['hard'] ?? null) ? trim((string)$startTime['hard']) : null,
-            'start_time_symbolic' => is_string($startTime['symbolic'] ?? null) ? trim((string)$startTime['symbolic']) : null,
-            'start_time_offset' => (int)($startTime['offset'] ?? 0),
-            'end_time_hard' => is_string($endTime['hard'] ?? null) ? trim((string)$endTime['hard']) : null,
-            'end_time_symbolic' => is_string($endTime['symbolic'] ?? null) ? trim((string)$endTime['symbolic']) : null,
-            'end_time_offset' => (int)($endTime['offset'] ?? 0),
-            'days' => $days,
-        ];
-
-        return hash('sha256', json_encode($payload, JSON_THROW_ON_ERROR));
-    }
-
     /**
      * Preserve provider linkage from current manifest when the reconciled winner
      * does not carry it (common when FPP is authoritative for state changes).
@@ -462,7 +435,7 @@ final class Reconciler
         array $tombstonesBySource,
         int $calSnapshotEpoch,
         int $fppSnapshotEpoch,
-        string $calendarScope
+        array $calendarScopes
     ): array {
         $orderOnlyDrift = $this->eventsDifferOnlyByExecutionOrder($calEvent, $fppEvent);
 
@@ -491,7 +464,7 @@ final class Reconciler
                 if (
                     $calTombstoneTs > 0
                     && $calTombstoneTs >= $fppTs
-                    && $this->currentEventSupportsCalendarDeleteIntent($curEvent, $calendarScope)
+                    && $this->currentEventSupportsCalendarDeleteIntent($curEvent, $calendarScopes)
                 ) {
                     return [
                         'winner' => 'calendar',
@@ -634,13 +607,31 @@ final class Reconciler
         return $out;
     }
 
+    /**
+     * @param string|array<int,string> $calendarScope
+     * @return array<int,string> non-empty, primary first
+     */
+    private function normalizeCalendarScopes(string|array $calendarScope): array
+    {
+        $scopes = [];
+        foreach ((array)$calendarScope as $scope) {
+            $scope = is_string($scope) ? trim($scope) : '';
+            if ($scope !== '' && !in_array($scope, $scopes, true)) {
+                $scopes[] = $scope;
+            }
+        }
+
+        return $scopes !== [] ? $scopes : ['default'];
+    }
+
     /**
      * Calendar tombstones are only trusted when current manifest provenance
-     * ties the identity to the active calendar scope.
+     * ties the identity to an active calendar scope.
      *
      * @param array<string,mixed>|null $currentEvent
+     * @param array<int,string> $calendarScopes
      */
-    private function currentEventSupportsCalendarDeleteIntent(?array $currentEvent, string $calendarScope): bool
+    private function currentEventSupportsCalendarDeleteIntent(?array $currentEvent, array $calendarScopes): bool
     {
         if (!is_array($currentEvent)) {
             return false;
@@ -657,19 +648,33 @@ final class Reconciler
             return false;
         }
 
-        return trim($sourceCalendarId) === $calendarScope;
+        return in_array(trim($sourceCalendarId), $calendarScopes, true);
     }
 
     /**
-     * Ensure reconciled manifest events are associated with the active calendar scope.
+     * Ensure reconciled manifest events are associated with an active calendar scope.
+     *
+     * With several calendars the event stays in the calendar it was observed
+     * in (or was last written to); anything else goes to the primary calendar.
      *
      * @param array<string,mixed> $event
+     * @param array<string,mixed>|null $calendarEvent
+     * @param array<int,string> $calendarScopes
      * @return array<string,mixed>
      */
-    private function assignActiveCalendarScope(array $event, string $calendarScope): array
+    private function assignActiveCalendarScope(array $event, ?array $calendarEvent, array $calendarScopes): array
     {
         $correlation = is_array($event['correlation'] ?? null) ? $event['correlation'] : [];
-        $correlation['sourceCalendarId'] = $calendarScope;
+        $scope = $calendarScopes[0];
+        if (count($calendarScopes) > 1) {
+            foreach ([$calendarEvent['correlation']['sourceCalendarId'] ?? null, $correlation['sourceCalendarId'] ?? null] as $candidate) {
+                if (is_string($candidate) && in_array(trim($candidate), $calendarScopes, true)) {
+                    $scope = trim($candidate);
+                    break;
+                }
+            }
+        }
+        $correlation['sourceCalendarId'] = $scope;
         $event['correlation'] = $correlation;
 
         return $event;
@@ -861,106 +866,15 @@ final class Reconciler
             $authority,
             $id,
             $reason . ($forceUpdate ? '; force format refresh update' : '; update'),
-            $desired
+            $desired,
+            $existing
         );
     }
 
     // ---------------------------------------------------------------------
-    // Manifest helpers (local to reconciler; avoids importing Diff.php)
+    // Event helpers
     // ---------------------------------------------------------------------
 
-    /**
-     * @param array<string,mixed> $manifest
-     * @return array<string,array<string,mixed>>
-     */
-    private function indexEventsByIdentity(array $manifest): array
-    {
-        $map = [];
-        $events = $manifest['events'] ?? [];
-        if (!is_array($events)) {
-            return $map;
-        }
-
-        $isList = array_keys($events) === range(0, count($events) - 1);
-        if ($isList) {
-            foreach ($events as $i => $event) {
-                if (!is_array($event)) {
-                    continue;
-                }
-                $id = $this->readEventIdentityKey($event, null);
-                if ($id === '') {
-                    throw new \RuntimeException('Manifest event missing identity key at events[' . $i . ']');
-                }
-                if (isset($map[$id])) {
-                    throw new \RuntimeException('Duplicate manifest identity detected: ' . $id);
-                }
-                $map[$id] = $event;
-            }
-            return $map;
-        }
-
-        foreach ($events as $eventKey => $event) {
-            if (!is_array($event)) {
-                continue;
-            }
-            $id = $this->readEventIdentityKey($event, is_string($eventKey) ? $eventKey : null);
-            if ($id === '') {
-                throw new \RuntimeException('Manifest event missing identity key at events[' . (string)$eventKey . ']');
-            }
-            if (isset($map[$id])) {
-                throw new \RuntimeException('Duplicate manifest identity detected: ' . $id);
-            }
-            $map[$id] = $event;
-        }
-
-        return $map;
-    }
-
-    /**
-     * @param array<string,mixed> $event
-     */
-    private function readEventIdentityKey(array $event, ?string $fallbackKey): string
-    {
-        if (is_string($fallbackKey) && trim($fallbackKey) !== '') {
-            return trim($fallbackKey);
-        }
-        $id = $event['id'] ?? null;
-        if (is_string($id) && trim($id) !== '') {
-            return trim($id);
-        }
-        $id2 = $event['identityHash'] ?? null;
-        if (is_string($id2) && trim($id2) !== '') {
-            return trim($id2);
-        }
-        return '';
-    }
-
-    /**
-     * @param array<string,mixed> $event
-     */
-    private function isManagedEvent(array $event): bool
-    {
-        $ownership = $event['ownership'] ?? null;
-        if (!is_array($ownership)) {
-            return false;
-        }
-        return (bool)($ownership['managed'] ?? false);
-    }
-
-    /**
-     * Locked is enforced only from CURRENT manifest.
-     *
-     * @param array<string,mixed> $event
-     */
-    private function isLockedEvent(array $event): bool
-    {
-        $ownership = $event['ownership'] ?? null;
-        if (!is_array($ownership)) {
-            return false;
-        }
-        return (bool)($ownership['locked'] ?? false);
-    }
-
     /**
      * @param array<string,mixed> $event
      */
@@ -66,8 +66,18 @@ final class ReconciliationAction
      */
     public ?array $event;
 
+    /**
+     * For updates: the event currently on the target side (the one being
+     * replaced), so apply layers can diff fields and patch in place.
+     * Null for other action types or when the target state is unknown.
+     *
+     * @var array<string,mixed>|null
+     */
+    public ?array $currentEvent;
+
     /**
      * @param array<string,mixed>|null $event
+     * @param array<string,mixed>|null $currentEvent
      */
     public function __construct(
         string $type,
@@ -75,7 +85,8 @@ final class ReconciliationAction
         string $authority,
         string $identityHash,
         string $reason,
-        ?array $event
+        ?array $event,
+        ?array $currentEvent = null
     ) {
         $this->type = $type;
         $this->target = $target;
@@ -83,6 +94,7 @@ final class ReconciliationAction
         $this->identityHash = $identityHash;
         $this->reason = $reason;
         $this->event = $event;
+        $this->currentEvent = $currentEvent;
 
         if (
             in_array($type, [self::TYPE_CREATE, self::TYPE_UPDATE, self::TYPE_DELETE], true)
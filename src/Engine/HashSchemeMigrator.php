@@ -0,0 +1,338 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Engine/HashSchemeMigrator.php
+ * Purpose: One-time rewrite of every persisted hash (manifest, correlation
+ * maps, tombstones, FPP event timestamps) into a different hash scheme.
+ */
+
+namespace CalendarScheduler\Engine;
+
+use CalendarScheduler\Apply\ManifestWriter;
+use CalendarScheduler\Intent\Intent;
+use CalendarScheduler\Intent\IntentNormalizer;
+use CalendarScheduler\Intent\NormalizationContext;
+use CalendarScheduler\Platform\FppEventTimestampStore;
+use CalendarScheduler\Platform\HashScheme;
+
+/**
+ * HashSchemeMigrator
+ *
+ * Hashes are content-derived, so each stored hash is recomputed from the
+ * content it was derived from:
+ * - identityHash: the manifest stores the canonical identity that was hashed
+ * - subEvent stateHash: each manifest event is re-normalized under the old
+ *   and the new scheme; a SubEvent is "verified" when the old-scheme result
+ *   reproduces its stored hash, so the new-scheme result is exactly what the
+ *   next run will compute
+ * - event stateHash: re-aggregated from the new SubEvent hashes
+ *
+ * Unverified SubEvents still receive a new-scheme hash; at worst the next
+ * run sees them as changed and rewrites them once. Provider-side metadata
+ * (FPP cs_manifestEventId, calendar private properties) is correlation only
+ * and is refreshed on the next write of each event.
+ *
+ * Must not run while an apply journal is pending (its stored plan carries
+ * old-scheme hashes).
+ */
+final class HashSchemeMigrator
+{
+    private readonly NormalizationContext $context;
+    private readonly IntentNormalizer $normalizer;
+
+    public function __construct(
+        private readonly string $manifestPath,
+        private readonly string $tombstonesPath,
+        private readonly string $timestampsPath,
+        ?NormalizationContext $context = null
+    ) {
+        $this->context = $context ?? FppEventTimestampStore::runtimeNormalizationContext();
+        $this->normalizer = new IntentNormalizer();
+    }
+
+    /**
+     * @return array{from:string,to:string,migrated:bool,events:int,verified:int,unverified:int,tombstones:int,timestamps:int}
+     */
+    public function migrate(string $toScheme, bool $dryRun = false): array
+    {
+        HashScheme::assertSupported($toScheme);
+
+        $manifest = $this->readJson($this->manifestPath);
+        $fromScheme = HashScheme::fromManifest($manifest);
+        HashScheme::assertSupported($fromScheme);
+
+        $report = [
+            'from' => $fromScheme,
+            'to' => $toScheme,
+            'migrated' => false,
+            'events' => 0,
+            'verified' => 0,
+            'unverified' => 0,
+            'tombstones' => 0,
+            'timestamps' => 0,
+        ];
+        if ($fromScheme === $toScheme) {
+            return $report;
+        }
+
+        $identityMap = [];
+        $intentStateMap = [];
+        $events = is_array($manifest['events'] ?? null) ? $manifest['events'] : [];
+        $migratedEvents = [];
+        foreach ($events as $key => $event) {
+            if (!is_array($event)) {
+                continue;
+            }
+            $oldId = (string)($event['identityHash'] ?? ($event['id'] ?? $key));
+            $event = $this->migrateEvent($event, $fromScheme, $toScheme, $intentStateMap, $report);
+            $identityMap[$oldId] = $event['identityHash'];
+            $migratedEvents[$event['identityHash']] = $event;
+            $report['events']++;
+        }
+        $manifest['events'] = $migratedEvents;
+        $manifest['hashScheme'] = $toScheme;
+
+        $tombstones = $this->readJson($this->tombstonesPath);
+        $tombstones = $this->migrateTombstones($tombstones, $identityMap, $report);
+        $timestamps = $this->readJson($this->timestampsPath);
+        $timestamps = $this->migrateTimestamps($timestamps, $identityMap, $intentStateMap, $report);
+
+        if ($dryRun) {
+            return $report;
+        }
+
+        // Side files first: the manifest's hashScheme marks the migration done.
+        if ($tombstones !== []) {
+            $this->writeJson($this->tombstonesPath, $tombstones);
+        }
+        if ($timestamps !== []) {
+            $this->writeJson($this->timestampsPath, $timestamps);
+        }
+        (new ManifestWriter($this->manifestPath))->applyTargetManifest($manifest);
+        $report['migrated'] = true;
+
+        return $report;
+    }
+
+    /**
+     * @param array<string,mixed> $event
+     * @param array<string,string> $intentStateMap old => new Intent event stateHash
+     * @param array<string,mixed> $report
+     * @return array<string,mixed>
+     */
+    private function migrateEvent(
+        array $event,
+        string $fromScheme,
+        string $toScheme,
+        array &$intentStateMap,
+        array &$report
+    ): array {
+        $identity = is_array($event['identity'] ?? null) ? $event['identity'] : [];
+        $newId = HashScheme::digestWith($toScheme, $identity);
+
+        $raw = $this->rawEventFor($event);
+        $fromIntent = $this->normalizeWith($fromScheme, $raw);
+        $toIntent = $this->normalizeWith($toScheme, $raw);
+        if ($fromIntent !== null && $toIntent !== null) {
+            $intentStateMap[$fromIntent->eventStateHash] = $toIntent->eventStateHash;
+        }
+
+        // Intent SubEvents follow the manifest SubEvent order (non-array rows skipped).
+        $subMap = [];
+        $position = 0;
+        $subEvents = is_array($event['subEvents'] ?? null) ? $event['subEvents'] : [];
+        foreach ($subEvents as $i => $sub) {
+            if (!is_array($sub)) {
+                continue;
+            }
+            $n = $position++;
+            $oldHash = is_string($sub['stateHash'] ?? null) ? $sub['stateHash'] : '';
+            $newHash = $toIntent?->subEvents[$n]['stateHash'] ?? null;
+            $verified = is_string($newHash)
+                && $oldHash !== ''
+                && ($fromIntent?->subEvents[$n]['stateHash'] ?? null) === $oldHash;
+            if (!is_string($newHash)) {
+                $newHash = HashScheme::digestStringWith($toScheme, $oldHash);
+            }
+
+            $report[$verified ? 'verified' : 'unverified']++;
+            if ($oldHash !== '') {
+                $subMap[$oldHash] = $newHash;
+            }
+            $sub['stateHash'] = $newHash;
+            $subEvents[$i] = $sub;
+        }
+
+        $subStateHashes = [];
+        foreach ($subEvents as $sub) {
+            $subStateHashes[] = is_array($sub) ? (string)($sub['stateHash'] ?? '') : '';
+        }
+        sort($subStateHashes, SORT_STRING);
+
+        $event['id'] = $newId;
+        $event['identityHash'] = $newId;
+        $event['stateHash'] = HashScheme::digestStringWith($toScheme, implode('|', $subStateHashes));
+        $event['subEvents'] = $subEvents;
+
+        // Provider event-id maps are keyed by SubEvent stateHash.
+        $correlation = is_array($event['correlation'] ?? null) ? $event['correlation'] : [];
+        foreach ($correlation as $field => $value) {
+            if (!is_string($field) || !str_ends_with($field, 'EventIds') || !is_array($value)) {
+                continue;
+            }
+            $rekeyed = [];
+            foreach ($value as $subHash => $providerId) {
+                $rekeyed[$subMap[$subHash] ?? $subHash] = $providerId;
+            }
+            $correlation[$field] = $rekeyed;
+        }
+        $event['correlation'] = $correlation;
+
+        return $event;
+    }
+
+    /**
+     * Manifest event => the canonical raw event shape IntentNormalizer accepts.
+     *
+     * @param array<string,mixed> $event
+     * @return array<string,mixed>
+     */
+    private function rawEventFor(array $event): array
+    {
+        $identity = is_array($event['identity'] ?? null) ? $event['identity'] : [];
+        $subEvents = [];
+        foreach (is_array($event['subEvents'] ?? null) ? $event['subEvents'] : [] as $sub) {
+            if (!is_array($sub)) {
+                continue;
+            }
+            $subEvents[] = [
+                'timing' => is_array($sub['timing'] ?? null) ? $sub['timing'] : [],
+                'payload' => is_array($sub['payload'] ?? null) ? $sub['payload'] : [],
+                'behavior' => is_array($sub['behavior'] ?? null) ? $sub['behavior'] : [],
+                'executionOrder' => $sub['executionOrder'] ?? null,
+                'executionOrderManual' => $sub['executionOrderManual'] ?? null,
+            ];
+        }
+        $first = $subEvents[0] ?? [];
+
+        return [
+            'type' => $identity['type'] ?? null,
+            'target' => $identity['target'] ?? null,
+            'payload' => array_merge($first['payload'] ?? [], $first['behavior'] ?? []),
+            'ownership' => is_array($event['ownership'] ?? null) ? $event['ownership'] : [],
+            'correlation' => is_array($event['correlation'] ?? null) ? $event['correlation'] : [],
+            'subEvents' => $subEvents,
+        ];
+    }
+
+    /**
+     * @param array<string,mixed> $raw
+     */
+    private function normalizeWith(string $scheme, array $raw): ?Intent
+    {
+        $previous = HashScheme::active();
+        HashScheme::activate($scheme);
+        try {
+            return $this->normalizer->fromManifestEvent($raw, $this->context);
+        } catch (\Throwable) {
+            return null;
+        } finally {
+            HashScheme::activate($previous);
+        }
+    }
+
+    /**
+     * Calendar keys are "<calendarScope>::<identityHash>", FPP keys are bare.
+     *
+     * @param array<string,mixed> $doc
+     * @param array<string,string> $identityMap
+     * @param array<string,mixed> $report
+     * @return array<string,mixed>
+     */
+    private function migrateTombstones(array $doc, array $identityMap, array &$report): array
+    {
+        $sources = is_array($doc['sources'] ?? null) ? $doc['sources'] : [];
+        foreach (['calendar', 'fpp'] as $source) {
+            $rows = is_array($sources[$source] ?? null) ? $sources[$source] : [];
+            $out = [];
+            foreach ($rows as $key => $ts) {
+                $key = (string)$key;
+                $sep = strrpos($key, '::');
+                $prefix = $sep === false ? '' : substr($key, 0, $sep + 2);
+                $id = $sep === false ? $key : substr($key, $sep + 2);
+                if (isset($identityMap[$id])) {
+                    $id = $identityMap[$id];
+                    $report['tombstones']++;
+                }
+                $out[$prefix . $id] = $ts;
+            }
+            ksort($out, SORT_STRING);
+            $sources[$source] = $out;
+        }
+        if ($doc !== []) {
+            $doc['sources'] = $sources;
+        }
+
+        return $doc;
+    }
+
+    /**
+     * @param array<string,mixed> $doc
+     * @param array<string,string> $identityMap
+     * @param array<string,string> $intentStateMap
+     * @param array<string,mixed> $report
+     * @return array<string,mixed>
+     */
+    private function migrateTimestamps(array $doc, array $identityMap, array $intentStateMap, array &$report): array
+    {
+        if (!is_array($doc['events'] ?? null)) {
+            return $doc;
+        }
+
+        $out = [];
+        foreach ($doc['events'] as $id => $row) {
+            $id = (string)$id;
+            if (isset($identityMap[$id])) {
+                $id = $identityMap[$id];
+                $report['timestamps']++;
+            }
+            if (is_array($row) && is_string($row['stateHash'] ?? null) && isset($intentStateMap[$row['stateHash']])) {
+                $row['stateHash'] = $intentStateMap[$row['stateHash']];
+            }
+            $out[$id] = $row;
+        }
+        ksort($out, SORT_STRING);
+        $doc['events'] = $out;
+
+        return $doc;
+    }
+
+    /**
+     * @return array<string,mixed>
+     */
+    private function readJson(string $path): array
+    {
+        $raw = is_file($path) ? @file_get_contents($path) : false;
+        if (!is_string($raw) || trim($raw) === '') {
+            return [];
+        }
+        $doc = json_decode($raw, true);
+        return is_array($doc) ? $doc : [];
+    }
+
+    /**
+     * @param array<string,mixed> $doc
+     */
+    private function writeJson(string $path, array $doc): void
+    {
+        $json = json_encode($doc, JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR);
+        $tmp = $path . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $path)) {
+            @unlink($tmp);
+            throw new \RuntimeException("HashSchemeMigrator: unable to write {$path}");
+        }
+    }
+}
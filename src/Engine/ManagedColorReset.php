@@ -0,0 +1,439 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Engine/ManagedColorReset.php
+ * Purpose: Reset provider colors/categories of managed calendar events from the
+ * cached calendar snapshot using batched, delta-only provider patches.
+ */
+
+namespace CalendarScheduler\Engine;
+
+use CalendarScheduler\Adapter\Calendar\MapperShared;
+use CalendarScheduler\Adapter\Calendar\ProviderRuntimeFactory;
+use CalendarScheduler\Adapter\Calendar\ProviderStylePatchRuntime;
+
+/**
+ * ManagedColorReset
+ *
+ * Engine operation that converges managed event styling without a full
+ * provider pull per reset:
+ * - Reuses calendar-snapshot.json when it matches provider/calendar, is fresh
+ *   and was fetched after the last apply (manifest.json mtime); an apply with
+ *   a projected preview leaves the pre-apply snapshot in place, whose event
+ *   ids may since have been deleted or replaced
+ * - An explicit reset ($refresh) always fetches a fresh snapshot instead
+ * - Managed rows are those carrying a scheduler type; duplicates the
+ *   translator collapsed (provenance.duplicates) are reset with their row
+ * - Computes the mismatched set locally from observed provenance style fields
+ * - Pushes only mismatched events as batched PATCH requests, per configured
+ *   calendar through that calendar's patch runtime
+ * - Writes the patched style back into the snapshot so repeat resets are no-ops
+ */
+final class ManagedColorReset
+{
+    public const DEFAULT_SNAPSHOT_MAX_AGE_SECONDS = 900;
+
+    public const PHASE_SNAPSHOT = 'snapshot';
+    public const PHASE_PATCH = 'patch';
+    public const PHASE_DONE = 'done';
+
+    public function __construct(
+        private readonly string $calendarSnapshotPath,
+        private readonly int $snapshotMaxAgeSeconds = self::DEFAULT_SNAPSHOT_MAX_AGE_SECONDS,
+        private readonly ?ProviderStylePatchRuntime $patchRuntime = null,
+        private readonly ?string $manifestPath = null
+    ) {}
+
+    /**
+     * @param callable(array{phase:string,done:int,total:int}):void|null $onProgress
+     * @param bool $refresh always fetch a fresh snapshot (an explicit, user-requested reset)
+     * @return array<string,int|string>
+     */
+    public function run(string $provider, ?callable $onProgress = null, bool $refresh = false): array
+    {
+        $provider = strtolower(trim($provider)) === 'outlook' ? 'outlook' : 'google';
+        $calendarIds = $this->patchRuntime !== null
+            ? [$this->patchRuntime->calendarId()]
+            : ProviderRuntimeFactory::calendarIds($provider);
+
+        $this->report($onProgress, self::PHASE_SNAPSHOT, 0, 0);
+        [$snapshot, $snapshotSource] = $this->loadSnapshot($provider, $calendarIds, $refresh);
+        $rows = is_array($snapshot['events'] ?? null) ? $snapshot['events'] : [];
+
+        // A multi-calendar snapshot holds the rows of every synced calendar;
+        // each calendar's rows are patched through that calendar.
+        $patchesByCalendar = [];
+        $scanned = 0;
+        $managed = 0;
+        $total = 0;
+        foreach ($calendarIds as $calendarId) {
+            $plan = self::planPatches($provider, array_values(array_filter(
+                $rows,
+                static fn (mixed $row): bool => self::rowInCalendar($row, $calendarId)
+            )));
+            $patchesByCalendar[$calendarId] = $plan['patches'];
+            $scanned += $plan['scanned'];
+            $managed += $plan['managed'];
+            $total += count($plan['patches']);
+        }
+        $this->report($onProgress, self::PHASE_PATCH, 0, $total);
+
+        $done = 0;
+        $updated = 0;
+        $failures = [];
+        foreach ($patchesByCalendar as $calendarId => $patches) {
+            if ($patches === []) {
+                continue;
+            }
+            $calendarId = (string)$calendarId;
+            $runtime = $this->patchRuntime ?? ProviderRuntimeFactory::createStylePatch($provider, $calendarId);
+            $calendarFailures = $runtime->patchEvents(
+                $patches,
+                function (int $batchDone) use ($onProgress, $done, $total): void {
+                    $this->report($onProgress, self::PHASE_PATCH, $done + $batchDone, $total);
+                }
+            );
+            $done += count($patches);
+
+            $applied = array_diff_key($patches, $calendarFailures);
+            if ($applied !== []) {
+                $rows = self::applyPatchesToRows($provider, $rows, $applied, $calendarId);
+                $updated += count($applied);
+            }
+            $failures = array_merge($failures, array_values($calendarFailures));
+        }
+
+        if ($updated > 0) {
+            $snapshot['events'] = $rows;
+            $this->writeSnapshot($snapshot);
+        }
+        $this->report($onProgress, self::PHASE_DONE, $total, $total);
+
+        $summary = [
+            'provider' => $provider,
+            'snapshot' => $snapshotSource,
+            'scanned' => $scanned,
+            'managed' => $managed,
+            'updated' => $updated,
+            'failed' => count($failures),
+        ];
+        if ($failures !== []) {
+            $summary['firstError'] = (string)reset($failures);
+        }
+
+        return $summary;
+    }
+
+    /**
+     * Compute delta-only style patches from translated snapshot rows.
+     *
+     * @param array<int,mixed> $rows
+     * @return array{scanned:int,managed:int,patches:array<string,array<string,mixed>>}
+     */
+    public static function planPatches(string $provider, array $rows): array
+    {
+        $scanned = 0;
+        $managed = 0;
+        $patches = [];
+
+        foreach ($rows as $row) {
+            if (!is_array($row)) {
+                continue;
+            }
+            $scanned++;
+
+            $eventId = is_string($row['uid'] ?? null) ? trim((string)$row['uid']) : '';
+            if ($eventId === '' || ($row['status'] ?? null) === 'cancelled') {
+                continue;
+            }
+
+            // Managed = carries a scheduler type, as read from the provider
+            // event itself (not whether it is linked to the manifest).
+            $metadata = is_array($row['payload']['metadata'] ?? null) ? $row['payload']['metadata'] : [];
+            $settings = is_array($metadata['settings'] ?? null) ? $metadata['settings'] : [];
+            $type = is_string($settings['type'] ?? null) ? trim((string)$settings['type']) : '';
+            if ($type === '') {
+                continue;
+            }
+            $provenance = is_array($row['provenance'] ?? null) ? $row['provenance'] : [];
+
+            // Duplicates the translator collapsed into this row carry their
+            // own uid, observed style and settings, and are reset with it.
+            $targets = [[$eventId, $provenance, $settings]];
+            foreach (is_array($provenance['duplicates'] ?? null) ? $provenance['duplicates'] : [] as $duplicate) {
+                $duplicateId = is_array($duplicate) && is_string($duplicate['uid'] ?? null) ? trim($duplicate['uid']) : '';
+                if ($duplicateId === '') {
+                    continue;
+                }
+                $scanned++;
+                $duplicateSettings = array_filter(
+                    ['type' => $duplicate['type'] ?? null, 'enabled' => $duplicate['enabled'] ?? null],
+                    static fn (mixed $value): bool => $value !== null
+                );
+                if (trim((string)($duplicateSettings['type'] ?? '')) !== '') {
+                    $targets[] = [$duplicateId, $duplicate, $duplicateSettings];
+                }
+            }
+
+            foreach ($targets as [$targetId, $observed, $targetSettings]) {
+                $managed++;
+                $type = trim((string)$targetSettings['type']);
+                $enabled = array_key_exists('enabled', $targetSettings)
+                    ? (bool)($targetSettings['enabled'] ?? false)
+                    : true;
+                if ($provider === 'outlook') {
+                    $desired = MapperShared::managedOutlookCategories($type, $enabled);
+                    sort($desired, SORT_STRING);
+                    if (self::observedOutlookCategories($observed, $targetSettings) !== $desired) {
+                        $patches[$targetId] = ['categories' => $desired];
+                    }
+                    continue;
+                }
+
+                $desiredColorId = MapperShared::managedGoogleColorId($type, $enabled);
+                if (self::observedGoogleColorId($observed, $targetSettings) !== $desiredColorId) {
+                    $patches[$targetId] = ['colorId' => $desiredColorId];
+                }
+            }
+        }
+
+        return [
+            'scanned' => $scanned,
+            'managed' => $managed,
+            'patches' => $patches,
+        ];
+    }
+
+    /**
+     * @param array<string,mixed> $provenance
+     * @param array<string,mixed> $settings
+     */
+    private static function observedGoogleColorId(array $provenance, array $settings): string
+    {
+        if (array_key_exists('colorId', $provenance)) {
+            return is_string($provenance['colorId']) ? trim($provenance['colorId']) : '';
+        }
+
+        // Snapshots written before colorId was tracked only carry the style token.
+        $styleToken = is_string($settings['styleToken'] ?? null) ? (string)$settings['styleToken'] : '';
+        return match ($styleToken) {
+            'disabled' => '8',
+            'sequence' => '10',
+            'command' => '6',
+            'playlist' => '9',
+            default => '',
+        };
+    }
+
+    /**
+     * @param array<string,mixed> $provenance
+     * @param array<string,mixed> $settings
+     * @return array<int,string>
+     */
+    private static function observedOutlookCategories(array $provenance, array $settings): array
+    {
+        if (is_array($provenance['categories'] ?? null)) {
+            $current = array_values(array_filter(
+                $provenance['categories'],
+                static fn ($v): bool => is_string($v) && trim($v) !== ''
+            ));
+            sort($current, SORT_STRING);
+            return $current;
+        }
+
+        $styleToken = is_string($settings['styleToken'] ?? null) ? (string)$settings['styleToken'] : '';
+        if (!in_array($styleToken, ['disabled', 'sequence', 'command', 'playlist'], true)) {
+            return [];
+        }
+
+        return MapperShared::managedOutlookCategories(
+            $styleToken === 'disabled' ? '' : $styleToken,
+            $styleToken !== 'disabled'
+        );
+    }
+
+    /**
+     * @param array<int,mixed> $rows
+     * @param array<string,array<string,mixed>> $applied
+     * @return array<int,mixed>
+     */
+    private static function applyPatchesToRows(string $provider, array $rows, array $applied, string $calendarId): array
+    {
+        foreach ($rows as $i => $row) {
+            if (!is_array($row) || !self::rowInCalendar($row, $calendarId)) {
+                continue;
+            }
+            $eventId = is_string($row['uid'] ?? null) ? trim((string)$row['uid']) : '';
+            $provenance = is_array($row['provenance'] ?? null) ? $row['provenance'] : [];
+            if (is_array($provenance['duplicates'] ?? null)) {
+                foreach ($provenance['duplicates'] as $d => $duplicate) {
+                    $patch = is_array($duplicate) ? ($applied[(string)($duplicate['uid'] ?? '')] ?? null) : null;
+                    if ($patch !== null) {
+                        $rows[$i]['provenance']['duplicates'][$d] = array_merge($duplicate, $patch);
+                    }
+                }
+            }
+            if ($eventId === '' || !isset($applied[$eventId])) {
+                continue;
+            }
+
+            $patch = $applied[$eventId];
+            $provenance = is_array($rows[$i]['provenance'] ?? null) ? $rows[$i]['provenance'] : [];
+            if ($provider === 'outlook') {
+                $provenance['categories'] = $patch['categories'];
+                $styleToken = MapperShared::outlookCategoriesToStyleToken($patch['categories']);
+            } else {
+                $provenance['colorId'] = $patch['colorId'];
+                $styleToken = MapperShared::googleColorIdToStyleToken($patch['colorId']);
+            }
+            $rows[$i]['provenance'] = $provenance;
+
+            if (is_string($styleToken) && is_array($row['payload']['metadata']['settings'] ?? null)) {
+                $rows[$i]['payload']['metadata']['settings']['styleToken'] = $styleToken;
+            }
+        }
+
+        return $rows;
+    }
+
+    /**
+     * Rows without a calendar_id predate multi-calendar snapshots and belong
+     * to the single calendar the snapshot was taken from.
+     */
+    private static function rowInCalendar(mixed $row, string $calendarId): bool
+    {
+        return is_array($row)
+            && (!is_string($row['calendar_id'] ?? null) || $row['calendar_id'] === $calendarId);
+    }
+
+    /**
+     * A cached snapshot is only used when it was taken from exactly the
+     * calendars being reset (primary first).
+     *
+     * @param array<int,string> $calendarIds
+     * @return array{0:array<string,mixed>,1:string} [snapshot, 'cached'|'refreshed']
+     */
+    private function loadSnapshot(string $provider, array $calendarIds, bool $refresh): array
+    {
+        $cached = $refresh ? null : $this->readSnapshot();
+        if (
+            $cached !== null
+            && $this->isReusable($cached, $provider, $calendarIds[0])
+            && self::snapshotCalendarIds($cached) === $calendarIds
+        ) {
+            return [$cached, 'cached'];
+        }
+
+        (new SchedulerEngine())->refreshCalendarSnapshotFromProvider($this->calendarSnapshotPath, $provider);
+        $refreshed = $this->readSnapshot();
+        if ($refreshed === null) {
+            throw new \RuntimeException("Calendar snapshot unreadable after refresh: {$this->calendarSnapshotPath}");
+        }
+
+        return [$refreshed, 'refreshed'];
+    }
+
+    /**
+     * @param array<string,mixed> $snapshot
+     * @return array<int,string>
+     */
+    private static function snapshotCalendarIds(array $snapshot): array
+    {
+        return is_array($snapshot['calendar_ids'] ?? null)
+            ? array_values($snapshot['calendar_ids'])
+            : [(string)($snapshot['calendar_id'] ?? '')];
+    }
+
+    /**
+     * Whether $snapshot may stand in for a provider fetch.
+     *
+     * @param array<string,mixed> $snapshot
+     */
+    public function isReusable(array $snapshot, string $provider, string $calendarId): bool
+    {
+        if (($snapshot['provider'] ?? null) !== $provider) {
+            return false;
+        }
+        if ((string)($snapshot['calendar_id'] ?? '') !== $calendarId) {
+            return false;
+        }
+
+        $generatedAt = is_string($snapshot['generated_at'] ?? null)
+            ? strtotime((string)$snapshot['generated_at'])
+            : false;
+        if ($generatedAt === false) {
+            return false;
+        }
+
+        // Every apply rewrites the manifest; a snapshot fetched before that
+        // no longer describes the calendar.
+        if ($this->manifestPath !== null) {
+            clearstatcache(true, $this->manifestPath);
+        }
+        $appliedAt = $this->manifestPath !== null && is_file($this->manifestPath)
+            ? @filemtime($this->manifestPath)
+            : false;
+        if ($appliedAt !== false && $generatedAt <= $appliedAt) {
+            return false;
+        }
+
+        return (time() - $generatedAt) <= $this->snapshotMaxAgeSeconds;
+    }
+
+    /**
+     * @return array<string,mixed>|null
+     */
+    private function readSnapshot(): ?array
+    {
+        if (!is_file($this->calendarSnapshotPath)) {
+            return null;
+        }
+
+        $raw = @file_get_contents($this->calendarSnapshotPath);
+        if (!is_string($raw) || trim($raw) === '') {
+            return null;
+        }
+
+        $decoded = json_decode($raw, true);
+        return is_array($decoded) && is_array($decoded['events'] ?? null) ? $decoded : null;
+    }
+
+    /**
+     * @param array<string,mixed> $snapshot
+     */
+    private function writeSnapshot(array $snapshot): void
+    {
+        $json = json_encode(
+            $snapshot,
+            JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR
+        );
+
+        $tmp = $this->calendarSnapshotPath . '.tmp';
+        if (file_put_contents($tmp, $json . PHP_EOL) === false) {
+            throw new \RuntimeException("Failed to write temp calendar snapshot: {$tmp}");
+        }
+        if (!rename($tmp, $this->calendarSnapshotPath)) {
+            @unlink($tmp);
+            throw new \RuntimeException("Failed to replace calendar snapshot: {$this->calendarSnapshotPath}");
+        }
+    }
+
+    /**
+     * @param callable(array{phase:string,done:int,total:int}):void|null $onProgress
+     */
+    private function report(?callable $onProgress, string $phase, int $done, int $total): void
+    {
+        if ($onProgress === null) {
+            return;
+        }
+
+        $onProgress([
+            'phase' => $phase,
+            'done' => $done,
+            'total' => $total,
+        ]);
+    }
+}
@@ -0,0 +1,249 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Engine/ManagedMetadataMigration.php
+ * Purpose: Rewrite managed calendar events that still carry per-key (legacy)
+ * scheduler metadata into the packed single-property encoding, a bounded
+ * batch at a time, from the cached calendar snapshot.
+ */
+
+namespace CalendarScheduler\Engine;
+
+use CalendarScheduler\Adapter\Calendar\Google\GoogleEventMetadataSchema;
+use CalendarScheduler\Adapter\Calendar\Outlook\OutlookEventMetadataSchema;
+use CalendarScheduler\Adapter\Calendar\PackedMetadata;
+use CalendarScheduler\Adapter\Calendar\ProviderRuntimeFactory;
+use CalendarScheduler\Adapter\Calendar\ProviderStylePatchRuntime;
+
+/**
+ * ManagedMetadataMigration
+ *
+ * Background counterpart of the packed metadata encoding (see PackedMetadata):
+ * - Candidates are managed snapshot rows whose provenance.legacyMetadata the
+ *   translator filled in; their metadata is packed as-is, so nothing the
+ *   scheduler reads changes
+ * - At most $batchLimit events are patched per run, through the same batched
+ *   PATCH runtime as ManagedColorReset
+ * - Google patches also delete the legacy keys; Graph cannot delete extended
+ *   properties, so Outlook events keep theirs
+ * - Once a calendar has no legacy rows left, an Outlook calendar gets its
+ *   migrated marker and later fetches expand only the packed property
+ *
+ * The snapshot is never refreshed here: a run only uses a snapshot taken at or
+ * after $notBefore, so it never packs metadata that an apply has just
+ * replaced. A snapshot taken before an apply may be used when the events that
+ * apply touched are passed as $skipEventIds.
+ */
+final class ManagedMetadataMigration
+{
+    public const DEFAULT_BATCH_LIMIT = 200;
+
+    public function __construct(
+        private readonly string $calendarSnapshotPath,
+        private readonly int $batchLimit = self::DEFAULT_BATCH_LIMIT,
+        private readonly ?ProviderStylePatchRuntime $patchRuntime = null
+    ) {}
+
+    /**
+     * @param array<int,string> $skipEventIds provider event ids left for a later run
+     * @return array<string,int|string>
+     */
+    public function run(string $provider, int $notBefore = 0, array $skipEventIds = []): array
+    {
+        $provider = strtolower(trim($provider)) === 'outlook' ? 'outlook' : 'google';
+        $summary = [
+            'provider' => $provider,
+            'pending' => 0,
+            'migrated' => 0,
+            'failed' => 0,
+        ];
+
+        $snapshot = $this->readSnapshot();
+        if ($snapshot === null || ($snapshot['provider'] ?? null) !== $provider) {
+            return $summary + ['skipped' => 'no-snapshot'];
+        }
+        $generatedAt = is_string($snapshot['generated_at'] ?? null) ? strtotime((string)$snapshot['generated_at']) : false;
+        if ($generatedAt === false || $generatedAt < $notBefore) {
+            return $summary + ['skipped' => 'stale-snapshot'];
+        }
+
+        $rows = is_array($snapshot['events'] ?? null) ? $snapshot['events'] : [];
+        $skip = array_fill_keys($skipEventIds, true);
+        $calendarIds = $this->patchRuntime !== null
+            ? [$this->patchRuntime->calendarId()]
+            : ProviderRuntimeFactory::calendarIds($provider);
+        $horizonEnd = is_string($snapshot['horizon']['end'] ?? null) ? (string)$snapshot['horizon']['end'] : null;
+
+        $budget = max(0, $this->batchLimit);
+        $applied = [];
+        foreach ($calendarIds as $calendarId) {
+            $candidates = self::planPatches($provider, array_values(array_filter(
+                $rows,
+                static fn (mixed $row): bool => self::rowInCalendar($row, $calendarId)
+            )));
+            $patches = array_diff_key($candidates, $skip);
+            $summary['pending'] += count($patches);
+
+            $batch = array_slice($patches, 0, $budget, true);
+            $budget -= count($batch);
+            $failures = [];
+            if ($batch !== []) {
+                $runtime = $this->patchRuntime ?? ProviderRuntimeFactory::createStylePatch($provider, $calendarId);
+                $failures = $runtime->patchEvents($batch);
+                $applied[$calendarId] = array_diff_key($batch, $failures);
+                $summary['migrated'] += count($applied[$calendarId]);
+                $summary['failed'] += count($failures);
+                if ($failures !== [] && !isset($summary['firstError'])) {
+                    $summary['firstError'] = (string)reset($failures);
+                }
+            }
+
+            $complete = count($batch) === count($candidates) && $failures === [];
+            if ($complete && $provider === 'outlook' && $horizonEnd !== null) {
+                PackedMetadata::writeMigratedMarker(
+                    PackedMetadata::migratedMarkerPath(dirname($this->calendarSnapshotPath), $provider, $calendarId),
+                    $horizonEnd
+                );
+            }
+        }
+
+        if ($summary['migrated'] > 0) {
+            $snapshot['events'] = self::clearMigratedRows($rows, $applied);
+            if (!$this->writeSnapshot($snapshot, (string)$snapshot['generated_at'])) {
+                $summary['snapshot'] = 'replaced';
+            }
+        }
+        $summary['pending'] -= $summary['migrated'];
+
+        return $summary;
+    }
+
+    /**
+     * Packed-metadata patches for managed rows that still carry legacy keys.
+     * A Google row whose packed value would exceed the provider's property
+     * value limit is left on its legacy keys.
+     *
+     * @param array<int,mixed> $rows
+     * @return array<string,array<string,mixed>> patch payloads keyed by provider event id
+     */
+    public static function planPatches(string $provider, array $rows): array
+    {
+        $patches = [];
+        foreach ($rows as $row) {
+            if (!is_array($row) || ($row['status'] ?? null) === 'cancelled') {
+                continue;
+            }
+
+            $eventId = is_string($row['uid'] ?? null) ? trim((string)$row['uid']) : '';
+            $legacy = $row['provenance']['legacyMetadata'] ?? null;
+            $manifestEventId = $row['payload']['metadata']['manifestEventId'] ?? null;
+            if ($eventId === '' || !is_array($legacy) || $legacy === [] || !is_string($manifestEventId) || $manifestEventId === '') {
+                continue;
+            }
+
+            if ($provider === 'outlook') {
+                $patches[$eventId] = [
+                    'singleValueExtendedProperties' => OutlookEventMetadataSchema::toSingleValueExtendedProperties($legacy),
+                ];
+                continue;
+            }
+
+            try {
+                $private = GoogleEventMetadataSchema::privateProperties($legacy);
+            } catch (\RuntimeException) {
+                continue;
+            }
+            foreach (array_keys(PackedMetadata::legacyEntries($legacy)) as $key) {
+                $private[$key] = null;
+            }
+            $patches[$eventId] = ['extendedProperties' => ['private' => $private]];
+        }
+
+        return $patches;
+    }
+
+    /**
+     * @param array<int,mixed> $rows
+     * @param array<string,array<string,array<string,mixed>>> $applied patches by calendar id
+     * @return array<int,mixed>
+     */
+    private static function clearMigratedRows(array $rows, array $applied): array
+    {
+        foreach ($rows as $i => $row) {
+            if (!is_array($row) || !is_array($row['provenance'] ?? null)) {
+                continue;
+            }
+            $eventId = is_string($row['uid'] ?? null) ? trim((string)$row['uid']) : '';
+            foreach ($applied as $calendarId => $patches) {
+                if (isset($patches[$eventId]) && self::rowInCalendar($row, (string)$calendarId)) {
+                    $rows[$i]['provenance']['legacyMetadata'] = null;
+                    break;
+                }
+            }
+        }
+
+        return $rows;
+    }
+
+    /**
+     * Rows without a calendar_id predate multi-calendar snapshots and belong
+     * to the single calendar the snapshot was taken from.
+     */
+    private static function rowInCalendar(mixed $row, string $calendarId): bool
+    {
+        return is_array($row)
+            && (!is_string($row['calendar_id'] ?? null) || $row['calendar_id'] === $calendarId);
+    }
+
+    /**
+     * @return array<string,mixed>|null
+     */
+    private function readSnapshot(): ?array
+    {
+        if (!is_file($this->calendarSnapshotPath)) {
+            return null;
+        }
+
+        $raw = @file_get_contents($this->calendarSnapshotPath);
+        if (!is_string($raw) || trim($raw) === '') {
+            return null;
+        }
+
+        $decoded = json_decode($raw, true);
+        return is_array($decoded) && is_array($decoded['events'] ?? null) ? $decoded : null;
+    }
+
+    /**
+     * Replace the snapshot with the migrated copy, unless a fetch has replaced
+     * it since it was read (its generated_at no longer matches); the newer
+     * snapshot is kept and the migrated rows are picked up on its next read.
+     *
+     * @param array<string,mixed> $snapshot
+     * @return bool false when the snapshot was left alone
+     */
+    private function writeSnapshot(array $snapshot, string $readGeneratedAt): bool
+    {
+        $json = json_encode(
+            $snapshot,
+            JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR
+        );
+
+        $tmp = $this->calendarSnapshotPath . '.' . getmypid() . '.tmp';
+        if (file_put_contents($tmp, $json . PHP_EOL) === false) {
+            throw new \RuntimeException("Failed to write temp calendar snapshot: {$tmp}");
+        }
+        if (($this->readSnapshot()['generated_at'] ?? null) !== $readGeneratedAt) {
+            @unlink($tmp);
+            return false;
+        }
+        if (!rename($tmp, $this->calendarSnapshotPath)) {
+            @unlink($tmp);
+            throw new \RuntimeException("Failed to replace calendar snapshot: {$this->calendarSnapshotPath}");
+        }
+
+        return true;
+    }
+}
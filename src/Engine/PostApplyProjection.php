@@ -0,0 +1,130 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Engine/PostApplyProjection.php
+ * Purpose: Derive the post-apply preview from the plan and what the apply
+ * executed, and spot-check only the provider events the apply touched.
+ */
+
+namespace CalendarScheduler\Engine;
+
+use CalendarScheduler\Adapter\Calendar\CalendarMutationLink;
+use CalendarScheduler\Adapter\Calendar\ProviderEventLookupRuntime;
+use CalendarScheduler\Apply\ApplyOutcome;
+use CalendarScheduler\Diff\ReconciliationAction;
+use CalendarScheduler\Diff\ReconciliationResult;
+
+/**
+ * PostApplyProjection
+ *
+ * A successful apply converges both sides on the plan's target manifest, so
+ * the preview that follows it is known without fetching and planning again:
+ * - the current manifest is the manifest the apply persisted (with the new
+ *   provider event ids)
+ * - every applied create/update becomes a noop on the target event; applied
+ *   deletes disappear, as the event is gone from the manifest
+ * - blocked, noop and unapplied actions carry over unchanged
+ *
+ * The projection trusts the apply. verifyTouched() re-reads only the provider
+ * events named by the mutation links; callers fall back to a full preview
+ * when it reports a mismatch. FPP writes are not re-read: the commit fails
+ * the apply when schedule.json cannot be written.
+ */
+final class PostApplyProjection
+{
+    private function __construct()
+    {
+    }
+
+    public static function project(SchedulerRunResult $planned, ApplyOutcome $outcome): SchedulerRunResult
+    {
+        $manifestEvents = is_array($outcome->manifest['events'] ?? null) ? $outcome->manifest['events'] : [];
+
+        $applied = [];
+        foreach ($outcome->appliedActions() as $action) {
+            $applied[spl_object_id($action)] = true;
+        }
+
+        $actions = [];
+        foreach ($planned->actions() as $action) {
+            if (!isset($applied[spl_object_id($action)])) {
+                $actions[] = $action;
+                continue;
+            }
+            if ($action->type === ReconciliationAction::TYPE_DELETE) {
+                continue;
+            }
+
+            $event = $manifestEvents[$action->identityHash] ?? $action->event;
+            $actions[] = new ReconciliationAction(
+                ReconciliationAction::TYPE_NOOP,
+                $action->target,
+                $action->authority,
+                $action->identityHash,
+                $action->reason . '; applied',
+                is_array($event) ? $event : null
+            );
+        }
+
+        return new SchedulerRunResult(
+            $outcome->manifest,
+            $planned->calendarManifest(),
+            $planned->fppManifest(),
+            $planned->diffResult(),
+            new ReconciliationResult($outcome->manifest, $actions),
+            $planned->calendarSnapshotEpoch(),
+            $planned->fppSnapshotEpoch()
+        );
+    }
+
+    /**
+     * Re-read the provider events the apply created, updated or deleted.
+     *
+     * Created/updated events must exist and carry the link's manifest event id
+     * and subevent hash; deleted events must be gone.
+     *
+     * @return array{checked:int,mismatches:array<int,string>,eventIds:array<int,string>}
+     */
+    public static function verifyTouched(ApplyOutcome $outcome, ProviderEventLookupRuntime $lookup): array
+    {
+        /** @var array<string,array<string,CalendarMutationLink>> $byCalendar calendar id => event id => last link */
+        $byCalendar = [];
+        foreach ($outcome->links as $link) {
+            if ($link instanceof CalendarMutationLink && $link->providerEventId !== '') {
+                $byCalendar[$link->calendarId][$link->providerEventId] = $link;
+            }
+        }
+
+        $summary = ['checked' => 0, 'mismatches' => [], 'eventIds' => []];
+        foreach ($byCalendar as $calendarId => $links) {
+            $found = $lookup->lookupEvents((string)$calendarId, array_map('strval', array_keys($links)));
+            foreach ($links as $eventId => $link) {
+                $eventId = (string)$eventId;
+                $summary['checked']++;
+                $summary['eventIds'][] = $eventId;
+
+                $event = $found[$eventId] ?? null;
+                if ($link->op === CalendarMutationLink::OP_DELETE) {
+                    if ($event !== null) {
+                        $summary['mismatches'][] = "{$eventId}: still present after delete";
+                    }
+                    continue;
+                }
+                if ($event === null) {
+                    $summary['mismatches'][] = "{$eventId}: missing after {$link->op}";
+                    continue;
+                }
+                if (($event['manifestEventId'] ?? null) !== $link->manifestEventId
+                    || ($event['subEventHash'] ?? null) !== $link->subEventHash
+                ) {
+                    $summary['mismatches'][] = "{$eventId}: metadata does not match {$link->op}";
+                }
+            }
+        }
+
+        return $summary;
+    }
+}
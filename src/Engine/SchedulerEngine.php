@@ -10,20 +10,29 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Engine;
 
+use CalendarScheduler\Intent\Intent;
 use CalendarScheduler\Intent\IntentNormalizer;
 use CalendarScheduler\Intent\NormalizationContext;
 use CalendarScheduler\Adapter\Calendar\CalendarSnapshot;
 use CalendarScheduler\Adapter\Calendar\MapperShared;
 use CalendarScheduler\Adapter\Calendar\ProviderRuntimeFactory;
+use CalendarScheduler\Adapter\Calendar\SyncHorizon;
 use CalendarScheduler\Planner\Dto\PlannerIntent;
 use CalendarScheduler\Resolution\ResolutionEngine;
+use CalendarScheduler\Resolution\Dto\CompactTiming;
+use CalendarScheduler\Resolution\Dto\PayloadPool;
+use CalendarScheduler\Resolution\Dto\ResolvedSchedule;
 use CalendarScheduler\Planner\ManifestPlanner;
 use CalendarScheduler\Diff\Diff;
+use CalendarScheduler\Diff\IndexedManifest;
 use CalendarScheduler\Diff\Reconciler;
 use CalendarScheduler\Platform\FppEventTimestampStore;
 use CalendarScheduler\Platform\FPPSemantics;
-use CalendarScheduler\Platform\HolidayResolver;
-use CalendarScheduler\Platform\SunTimeDisplayEstimator;
+use CalendarScheduler\Platform\HashScheme;
+use CalendarScheduler\Platform\HolidayTableCache;
+use CalendarScheduler\Platform\ProcessPool;
+use CalendarScheduler\Platform\SunTimeTable;
+use CalendarScheduler\Platform\Trace;
 
 /**
  * SchedulerEngine
@@ -46,16 +55,40 @@ final class SchedulerEngine
     public const SYNC_MODE_CALENDAR = Reconciler::MODE_CALENDAR;
     public const SYNC_MODE_FPP = Reconciler::MODE_FPP;
 
+    // Below this many items a stage stays in-process: forking and result
+    // serialization cost more than they save on small calendars.
+    private const SHARD_MIN_ITEMS = 256;
+
     /** @var array{calendar:array<string,int>,fpp:array<string,int>} */
     private array $lastTombstonesBySource = ['calendar' => [], 'fpp' => []];
     /** @var array{calendar:array<string,int>,fpp:array<string,int>} */
     private array $loadedTombstonesBySource = ['calendar' => [], 'fpp' => []];
+    /** @var array<string,string> calendar tombstone identity => calendar scope it was recorded under */
+    private array $calendarTombstoneScopes = [];
     private ?float $orderingLatitude = null;
     private ?float $orderingLongitude = null;
     private string $orderingTimezone = 'UTC';
     private bool $managedColorEnforced = false;
+    /**
+     * Worker processes for sharded resolution/normalization (1 = in-process).
+     * runFromCli() defaults it to the CPU count.
+     */
+    private int $workerCount = 1;
     /** @var array<string,int|null> */
     private array $symbolicDisplaySecondsCache = [];
+    /**
+     * Ordering footprints, filled lazily per execution ordering pass: weekday
+     * mask (FPPSemantics::DAY_MASK_BITS) + interned daily window key, per
+     * intent and per bundle (keyed by spl_object_id of the intent / of the
+     * bundle's first intent).
+     *
+     * @var array<int,array{days:int,window:string}>
+     */
+    private array $intentOrderingFootprints = [];
+    /** @var array<int,array{days:int,window:string}> */
+    private array $bundleOrderingFootprints = [];
+    /** @var array<string,array<int,array{0:int,1:int}>> interned daily window segment lists by key */
+    private array $dailyWindowSegmentLists = [];
     /**
      * Optional FPP validation catalog loaded from runtime snapshot.
      * When null, calendar target validation is skipped (dev/test fallback).
@@ -96,6 +129,7 @@ final class SchedulerEngine
         $runEpoch = time();
         $syncMode = $this->normalizeSyncMode($opts['sync-mode'] ?? $opts['sync_mode'] ?? null);
         $this->managedColorEnforced = MapperShared::isManagedColorEnforced();
+        $this->workerCount = max(1, (int)($opts['workers'] ?? ProcessPool::cpuCount()));
 
         // -----------------------------------------------------------------
         // Resolve paths
@@ -107,8 +141,7 @@ final class SchedulerEngine
         $manifestPath = $opts['manifest']
             ?? '/home/fpp/media/config/calendar-scheduler/manifest.json';
         $tombstonesPath = '/home/fpp/media/config/calendar-scheduler/runtime/tombstones.json';
-        $calendarScope = 'default';
-        $tombstonesBySource = $this->loadTombstones($tombstonesPath, $calendarScope);
+        $tombstonesBySource = $this->loadTombstones($tombstonesPath, ['default']);
 
         // -----------------------------------------------------------------
         // Build NormalizationContext from runtime snapshot
@@ -147,7 +180,7 @@ final class SchedulerEngine
         $context = new NormalizationContext(
             $contextTimezone,
             new FPPSemantics(),
-            new HolidayResolver($holidays)
+            (new HolidayTableCache())->resolver($holidays)
         );
 
         // -----------------------------------------------------------------
@@ -172,7 +205,9 @@ final class SchedulerEngine
         );
 
         if ($refreshCalendar || $applyRequested) {
+            Trace::begin('calendar snapshot refresh', 'provider', ['provider' => $calendarProvider]);
             $this->refreshCalendarSnapshotFromProvider($calendarSnapshotPath, $calendarProvider);
+            Trace::end();
         }
 
         $calendarSnapshotRaw = [];
@@ -188,16 +223,24 @@ final class SchedulerEngine
 
         $rawEvents = [];
         $calendarId = 'default';
+        $extraCalendarIds = [];
+        $archiveBeforeDate = null;
 
         if (is_array($calendarSnapshotRaw) && array_key_exists('events', $calendarSnapshotRaw)) {
             $rawEvents = is_array($calendarSnapshotRaw['events'] ?? null)
                 ? $calendarSnapshotRaw['events']
                 : [];
+            // Bounded snapshots only observe events inside the horizon; anything
+            // ending before its start is archived rather than read as deleted.
+            $archiveBeforeDate = SyncHorizon::archiveBeforeDateFromSnapshot($calendarSnapshotRaw);
             $calendarId = (string)(
                 $calendarSnapshotRaw['calendar_id']
                 ?? $calendarSnapshotRaw['calendarId']
                 ?? 'default'
             );
+            $extraCalendarIds = is_array($calendarSnapshotRaw['calendar_ids'] ?? null)
+                ? $calendarSnapshotRaw['calendar_ids']
+                : [];
         } elseif (is_array($calendarSnapshotRaw)) {
             $rawEvents = $calendarSnapshotRaw;
         }
@@ -207,11 +250,16 @@ final class SchedulerEngine
             $calendarId = trim($calendarId);
         }
 
+        // Fan-out snapshots list every fetched calendar; the primary comes first.
+        $calendarScopes = $this->normalizeCalendarScopes(array_merge([$calendarId], $extraCalendarIds));
+
         // Re-scope calendar tombstones after calendar_id is known from snapshot.
-        $tombstonesBySource = $this->loadTombstones($tombstonesPath, $calendarId);
+        $tombstonesBySource = $this->loadTombstones($tombstonesPath, $calendarScopes);
 
-        // CalendarSnapshot expects raw provider rows.
+        // CalendarSnapshot expects raw provider rows. run() drops them once
+        // resolved, so keep no other reference to them here.
         $calendarEvents = $rawEvents;
+        unset($calendarSnapshotRaw, $rawEvents);
 
         // Snapshot is treated as volatile per-run observational state
         // Always advance epoch to ensure no stale reconciliation decisions
@@ -219,12 +267,29 @@ final class SchedulerEngine
 
         $calendarUpdatedAtById = [];
 
+        // -----------------------------------------------------------------
+        // Load current manifest
+        // -----------------------------------------------------------------
+
+        $currentManifest = [];
+        if (file_exists($manifestPath)) {
+            $currentManifest = json_decode(
+                file_get_contents($manifestPath),
+                true
+            ) ?? [];
+        }
+
+        // Hashes computed from here on must match the scheme the manifest was written with.
+        HashScheme::activate(HashScheme::fromManifest($currentManifest));
+
         // -----------------------------------------------------------------
         // Ingest FPP schedule.json
         // -----------------------------------------------------------------
 
         $fppAdapter = new \CalendarScheduler\Adapter\FppScheduleAdapter();
+        Trace::begin('fpp schedule ingest', 'provider');
         $fppEvents = $fppAdapter->loadManifestEvents($context, $schedulePath);
+        Trace::end(['events' => count($fppEvents)]);
 
         $fppSnapshotEpoch = $runEpoch;
         $runtimeCatalogPath = '/home/fpp/media/config/calendar-scheduler/runtime/fpp-runtime.json';
@@ -236,25 +301,13 @@ final class SchedulerEngine
         $fppUpdatedAtById = $timestampStore->loadUpdatedAtByIdentity($fppEventTimestampPath);
         $fppUpdatedAtByStateHash = $timestampStore->loadUpdatedAtByStateHash($fppEventTimestampPath);
 
-        // -----------------------------------------------------------------
-        // Load current manifest
-        // -----------------------------------------------------------------
-
-        $currentManifest = [];
-        if (file_exists($manifestPath)) {
-            $currentManifest = json_decode(
-                file_get_contents($manifestPath),
-                true
-            ) ?? [];
-        }
-
         // -----------------------------------------------------------------
         // Delegate to core engine
         // -----------------------------------------------------------------
 
         $runResult = $this->run(
             $currentManifest,
-            $calendarEvents,
+            array_splice($calendarEvents, 0), // hands the rows over, leaving $calendarEvents empty
             $fppEvents,
             $calendarUpdatedAtById,
             $fppUpdatedAtById,
@@ -264,11 +317,12 @@ final class SchedulerEngine
             $calendarSnapshotEpoch,
             $fppSnapshotEpoch,
             $syncMode,
-            $calendarId,
-            $calendarProvider
+            $calendarScopes,
+            $calendarProvider,
+            $archiveBeforeDate
         );
 
-        $this->saveTombstones($tombstonesPath, $this->lastTombstonesBySource, $calendarId);
+        $this->saveTombstones($tombstonesPath, $this->lastTombstonesBySource, $calendarScopes);
 
         return $runResult;
     }
@@ -283,6 +337,8 @@ final class SchedulerEngine
      * @param array<string,int> $fppUpdatedAtById
      * @param array<string,int> $fppUpdatedAtByStateHash
      * @param array{calendar:array<string,int>,fpp:array<string,int>} $tombstonesBySource
+     * @param string|array<int,string> $calendarScope Calendar id, or every synced calendar id (primary first)
+     * @param string|null $archiveBeforeDate Sync horizon start (Y-m-d); null disables archiving
      */
     public function run(
         array $currentManifest,
@@ -296,12 +352,16 @@ final class SchedulerEngine
         int $calendarSnapshotEpoch,
         int $fppSnapshotEpoch,
         string $syncMode = self::SYNC_MODE_BOTH,
-        string $calendarScope = 'default',
-        string $calendarProvider = 'google'
+        string|array $calendarScope = 'default',
+        string $calendarProvider = 'google',
+        ?string $archiveBeforeDate = null
     ): SchedulerRunResult {
         $syncMode = $this->normalizeSyncMode($syncMode);
-        $calendarScope = trim($calendarScope) !== '' ? trim($calendarScope) : 'default';
+        $calendarScopes = $this->normalizeCalendarScopes((array)$calendarScope);
+        $calendarScope = $calendarScopes[0];
+        $multiCalendar = count($calendarScopes) > 1;
         $calendarProvider = $this->normalizeCalendarProvider($calendarProvider);
+        HashScheme::activate(HashScheme::fromManifest($currentManifest));
         $this->orderingTimezone = $context->timezone->getName();
         $computedCalendarUpdatedAtById = $calendarUpdatedAtById;
         $computedFppUpdatedAtById = $fppUpdatedAtById;
@@ -310,15 +370,37 @@ final class SchedulerEngine
         // Calendar events → Snapshot → Resolution → PlannerIntents → Intents
         // ------------------------------------------------------------
 
-        // CalendarSnapshot groups already-translated provider rows.
-        $snapshot = new CalendarSnapshot();
-        $snapshot->snapshot($calendarEvents);
+        // CalendarSnapshot groups already-translated provider rows. Each
+        // calendar is snapshotted and resolved on its own: provider UIDs (and
+        // the override -> parent links built from them) are per calendar.
+        $rowsByScope = $multiCalendar
+            ? $this->partitionRowsByCalendarScope($calendarEvents, $calendarScopes)
+            : [$calendarScope => $calendarEvents];
 
         $resolver = new ResolutionEngine();
-        $resolvedSchedule = $resolver->resolve($snapshot);
-
-        $plannerIntents = $resolvedSchedule->toPlannerIntents();
-
+        $plannerIntents = [];
+        /** @var array<int,string> $intentScopes spl_object_id(PlannerIntent) => calendar scope */
+        $intentScopes = [];
+        Trace::begin('resolution', 'resolution');
+        foreach ($rowsByScope as $scope => $scopeRows) {
+            $snapshot = new CalendarSnapshot();
+            $snapshot->snapshot($scopeRows);
+            // Each snapshot event resolves on its own; large calendars shard them.
+            $bundles = [];
+            foreach ($this->runSharded(
+                array_values($snapshot->getSnapshotEvents()),
+                static fn (array $events): array => $resolver->resolveEvents($events)
+            ) as $shardBundles) {
+                array_push($bundles, ...$shardBundles);
+            }
+            foreach ((new ResolvedSchedule($bundles))->toPlannerIntents() as $plannerIntent) {
+                $intentScopes[spl_object_id($plannerIntent)] = (string)$scope;
+                $plannerIntents[] = $plannerIntent;
+            }
+        }
+        Trace::end();
+
+        // Keyed by parent UID (scope-qualified when several calendars are synced).
         $calendarUpdatedAtByUid = [];
         foreach ($calendarEvents as $event) {
             if (!is_array($event)) {
@@ -329,6 +411,8 @@ final class SchedulerEngine
             if (!is_string($uid) || $uid === '') {
                 continue;
             }
+            $uidPrefix = $multiCalendar ? $this->rowCalendarScope($event, $calendarScopes) . '::' : '';
+            $uid = $uidPrefix . $uid;
 
             $provenance = is_array($event['provenance'] ?? null) ? $event['provenance'] : [];
             $ts = $event['updatedAtEpoch']
@@ -350,12 +434,20 @@ final class SchedulerEngine
             // most recent change across both master and override rows.
             $parentUid = $event['parentUid'] ?? null;
             if (is_string($parentUid) && $parentUid !== '') {
+                $parentUid = $uidPrefix . $parentUid;
                 if (!isset($calendarUpdatedAtByUid[$parentUid]) || $eventTs > $calendarUpdatedAtByUid[$parentUid]) {
                     $calendarUpdatedAtByUid[$parentUid] = $eventTs;
                 }
             }
         }
 
+        // Raw provider rows are not read past this point. Planner intents keep
+        // only row references and interned payloads, so release the rows (the
+        // largest structure on big calendars) before manifests are built.
+        unset($rowsByScope, $scopeRows, $snapshot);
+        $calendarEvents = [];
+        PayloadPool::clear();
+
         // Resolution already produces PlannerIntent objects with correct timing.
         // At this stage (resolution-smoke-pass baseline), no further normalization
         // of planner intents is required. We simply index them by identityHash
@@ -366,6 +458,9 @@ final class SchedulerEngine
         // Group PlannerIntents by parentUid (1 manifest event per calendar event)
         // ------------------------------------------------------------
         $groupedByParent = [];
+        // Multi-calendar runs key groups "<scope>::<parentUid>".
+        $groupScopes = [];
+        $groupParentUids = [];
 
         foreach ($plannerIntents as $plannerIntent) {
             $parentUid = $plannerIntent->parentUid ?? null;
@@ -396,15 +491,31 @@ final class SchedulerEngine
                 $parentUid = 'synthetic_' . spl_object_id($plannerIntent);
             }
 
-            if (!isset($groupedByParent[$parentUid])) {
-                $groupedByParent[$parentUid] = [];
+            $groupKey = $parentUid;
+            if ($multiCalendar) {
+                $scope = $intentScopes[spl_object_id($plannerIntent)] ?? $calendarScope;
+                $groupKey = $scope . '::' . $parentUid;
+                $groupScopes[$groupKey] = $scope;
+                $groupParentUids[$groupKey] = $parentUid;
             }
 
-            $groupedByParent[$parentUid][] = $plannerIntent;
+            if (!isset($groupedByParent[$groupKey])) {
+                $groupedByParent[$groupKey] = [];
+            }
+
+            $groupedByParent[$groupKey][] = $plannerIntent;
         }
+        Trace::begin('execution ordering', 'ordering', ['intents' => count($plannerIntents)]);
         $globalExecutionRanks = $this->computeExecutionOrderRanks($plannerIntents);
-
-        foreach ($groupedByParent as $parentUid => $intentsForParent) {
+        Trace::end();
+
+        Trace::begin('normalize calendar', 'normalization', ['parents' => count($groupedByParent)]);
+        $calendarManifestEvents = [];
+        /** @var array<int,array{0:string,1:array<string,mixed>}> $calendarManifestEventKeys group key + anchor payload, by manifest event */
+        $calendarManifestEventKeys = [];
+        foreach ($groupedByParent as $groupKey => $intentsForParent) {
+            $parentUid = $groupParentUids[$groupKey] ?? $groupKey;
+            $groupScope = $groupScopes[$groupKey] ?? $calendarScope;
             $anchorIntents = $intentsForParent;
             usort(
                 $anchorIntents,
@@ -414,14 +525,14 @@ final class SchedulerEngine
                  * to the base segment instead of an edited override occurrence.
                  */
                 static function (PlannerIntent $a, PlannerIntent $b): int {
-                    $aStart = $a->scope->getStart()->getTimestamp();
-                    $bStart = $b->scope->getStart()->getTimestamp();
+                    $aStart = $a->scope->getStartEpoch();
+                    $bStart = $b->scope->getStartEpoch();
                     if ($aStart !== $bStart) {
                         return $aStart <=> $bStart;
                     }
 
-                    $aEnd = $a->scope->getEnd()->getTimestamp();
-                    $bEnd = $b->scope->getEnd()->getTimestamp();
+                    $aEnd = $a->scope->getEndEpoch();
+                    $bEnd = $b->scope->getEndEpoch();
                     if ($aEnd !== $bEnd) {
                         return $aEnd <=> $bEnd;
                     }
@@ -483,13 +594,9 @@ final class SchedulerEngine
                 });
 
                 foreach ($orderedBucketIntents as $plannerIntent) {
-                    $scopeStart = $plannerIntent->scope->getStart();
-                    $scopeEndExclusive = $plannerIntent->scope->getEnd();
-                    $scopeEndInclusive = $scopeEndExclusive->modify('-1 day');
-
-                    if ($scopeEndInclusive < $scopeStart) {
-                        $scopeEndInclusive = $scopeStart;
-                    }
+                    // Scope end is exclusive; the inclusive end date never precedes the start date.
+                    $scopeStartDay = $plannerIntent->scope->getStartDay();
+                    $scopeEndInclusiveDay = max($scopeStartDay, $plannerIntent->scope->getEndDay() - 1);
 
                     $payload = is_array($plannerIntent->payload ?? null)
                         ? $plannerIntent->payload
@@ -559,11 +666,11 @@ final class SchedulerEngine
                         'timing' => [
                             'all_day'    => $plannerIntent->allDay,
                             'start_date' => [
-                                'hard'     => $scopeStart->format('Y-m-d'),
+                                'hard'     => CompactTiming::date($scopeStartDay),
                                 'symbolic' => null,
                             ],
                             'end_date'   => [
-                                'hard'     => $scopeEndInclusive->format('Y-m-d'),
+                                'hard'     => CompactTiming::date($scopeEndInclusiveDay),
                                 'symbolic' => null,
                             ],
                             // Symbolic time invalidates hard time.
@@ -583,7 +690,7 @@ final class SchedulerEngine
                                         'offset'   => 0,
                                     ]
                                 : [
-                                    'hard'     => $plannerIntent->start->format('H:i:s'),
+                                    'hard'     => CompactTiming::time($plannerIntent->startSecond),
                                     'symbolic' => null,
                                     'offset'   => 0,
                                 ]),
@@ -602,7 +709,7 @@ final class SchedulerEngine
                                         'offset'   => 0,
                                     ]
                                 : [
-                                    'hard'     => $plannerIntent->end->format('H:i:s'),
+                                    'hard'     => CompactTiming::time($plannerIntent->endSecond),
                                     'symbolic' => null,
                                     'offset'   => 0,
                                 ]),
@@ -668,36 +775,43 @@ final class SchedulerEngine
                         // Preserve provider-native UID even when sourceEventUid is replaced
                         // by manifestEventId linkage for stable identity grouping.
                         'sourceProviderUid' => $anchor->sourceEventUid,
-                        'sourceCalendarId' => $calendarScope,
+                        'sourceCalendarId' => $groupScope,
                     ],
 
                     'source' => 'calendar',
                 ];
 
-                $normalizedIntent = $this->normalizer->fromManifestEvent(
-                    $manifestEvent,
-                    $context
-                );
-                $metadataForIdentity = is_array($anchorPayload['metadata'] ?? null) ? $anchorPayload['metadata'] : [];
-                $manifestEventIdForIdentity = $metadataForIdentity['manifestEventId'] ?? null;
-                if (is_string($manifestEventIdForIdentity) && trim($manifestEventIdForIdentity) !== '') {
-                    // Provider-managed rows should round-trip back to their originating manifest identity.
-                    $normalizedIntent->identityHash = trim($manifestEventIdForIdentity);
-                }
+                $calendarManifestEvents[] = $manifestEvent;
+                $calendarManifestEventKeys[] = [$groupKey, $anchorPayload];
+            }
+        }
 
-                $calendarIntents[$normalizedIntent->identityHash] = $normalizedIntent;
-                $computedCalendarUpdatedAtById[$normalizedIntent->identityHash] =
-                    $calendarUpdatedAtByUid[$parentUid]
-                    ?? $calendarSnapshotEpoch;
+        // Normalization is independent per manifest event; large runs shard it.
+        $normalizedCalendarIntents = $this->normalizeManifestEvents($calendarManifestEvents, $context);
+        foreach ($normalizedCalendarIntents as $i => $normalizedIntent) {
+            [$groupKey, $anchorPayload] = $calendarManifestEventKeys[$i];
+            $metadataForIdentity = is_array($anchorPayload['metadata'] ?? null) ? $anchorPayload['metadata'] : [];
+            $manifestEventIdForIdentity = $metadataForIdentity['manifestEventId'] ?? null;
+            if (is_string($manifestEventIdForIdentity) && trim($manifestEventIdForIdentity) !== '') {
+                // Provider-managed rows should round-trip back to their originating manifest identity.
+                $normalizedIntent->identityHash = trim($manifestEventIdForIdentity);
             }
+
+            $calendarIntents[$normalizedIntent->identityHash] = $normalizedIntent;
+            $computedCalendarUpdatedAtById[$normalizedIntent->identityHash] =
+                $calendarUpdatedAtByUid[$groupKey]
+                ?? $calendarSnapshotEpoch;
         }
+        Trace::end(['intents' => count($calendarIntents)]);
 
         // ------------------------------------------------------------
         // Normalize FPP events → Intents
         // ------------------------------------------------------------
         $fppIntents = [];
-        foreach ($fppEvents as $event) {
-            $intent = $this->normalizer->fromManifestEvent($event, $context);
+        Trace::begin('normalize fpp', 'normalization', ['events' => count($fppEvents)]);
+        $fppEvents = array_values($fppEvents);
+        foreach ($this->normalizeManifestEvents($fppEvents, $context) as $i => $intent) {
+            $event = $fppEvents[$i];
             $hash = $intent->identityHash;
 
             $fppIntents[$hash] = $intent;
@@ -721,24 +835,55 @@ final class SchedulerEngine
             }
         }
 
+        Trace::end();
+
         // ------------------------------------------------------------
         // Build manifests
         // ------------------------------------------------------------
+        Trace::begin('build manifests', 'planner');
         $calendarManifest = $this->manifestPlanner
             ->buildManifestFromIntents($calendarIntents);
 
         $fppManifest = $this->manifestPlanner
             ->buildManifestFromIntents($fppIntents);
 
+        // Index each manifest once; Diff, Reconciler and UI shaping share these.
+        $calendarIndex = IndexedManifest::fromManifest($calendarManifest);
+
+        // ------------------------------------------------------------
+        // Archive events that ended before the sync horizon
+        // ------------------------------------------------------------
+        [$currentManifest, $archivedIds] = $this->archiveEventsBeforeHorizon(
+            $currentManifest,
+            $calendarIndex,
+            $archiveBeforeDate
+        );
+        // Archived events are frozen: FPP copies are not re-reconciled and
+        // the calendar side cannot observe them, so neither side may vote.
+        // One that FPP no longer holds was deleted (or re-dated) there; it is
+        // dropped instead of being written back by the next schedule rebuild.
+        if ($archivedIds !== []) {
+            $fppEventsById = is_array($fppManifest['events'] ?? null) ? $fppManifest['events'] : [];
+            $goneIds = array_diff_key($archivedIds, $fppEventsById);
+            if ($goneIds !== []) {
+                $currentManifest['events'] = array_diff_key($currentManifest['events'], $goneIds);
+                $archivedIds = array_diff_key($archivedIds, $goneIds);
+            }
+            $fppManifest['events'] = array_diff_key($fppEventsById, $archivedIds);
+        }
+        $currentIndex = IndexedManifest::fromManifest($currentManifest);
+        $fppIndex = IndexedManifest::fromManifest($fppManifest);
+        Trace::end();
+
         $effectiveTombstonesBySource = $tombstonesBySource;
         if ($syncMode === self::SYNC_MODE_BOTH) {
             $effectiveTombstonesBySource = $this->deriveEffectiveTombstones(
-                $currentManifest,
-                $calendarManifest,
-                $fppManifest,
+                $currentIndex,
+                $calendarIndex,
+                $fppIndex,
                 $tombstonesBySource,
                 $calendarSnapshotEpoch,
-                $calendarScope
+                $calendarScopes
             );
         }
         $this->lastTombstonesBySource = $effectiveTombstonesBySource;
@@ -746,26 +891,30 @@ final class SchedulerEngine
         // ------------------------------------------------------------
         // Diff (calendar desired vs current)
         // ------------------------------------------------------------
+        Trace::begin('diff', 'diff');
         $diffResult = $this->diff->diff(
-            $calendarManifest,
-            $currentManifest
+            $calendarIndex,
+            $currentIndex->without($archivedIds)
         );
+        Trace::end();
 
         // ------------------------------------------------------------
         // Reconcile (calendar vs fpp vs current)
         // ------------------------------------------------------------
+        Trace::begin('reconcile', 'reconcile');
         $reconciliationResult = $this->reconciler->reconcile(
-            $calendarManifest,
-            $fppManifest,
-            $currentManifest,
+            $calendarIndex,
+            $fppIndex,
+            $currentIndex,
             $computedCalendarUpdatedAtById,
             $computedFppUpdatedAtById,
             $effectiveTombstonesBySource,
             $calendarSnapshotEpoch,
             $fppSnapshotEpoch,
             $syncMode,
-            $calendarScope
+            $calendarScopes
         );
+        Trace::end();
         $this->emitCalendarValidationDiagnostics();
 
         // ------------------------------------------------------------
@@ -778,38 +927,30 @@ final class SchedulerEngine
             $diffResult,
             $reconciliationResult,
             $calendarSnapshotEpoch,
-            $fppSnapshotEpoch
+            $fppSnapshotEpoch,
+            null,
+            $currentIndex
         );
     }
 
     /**
-     * @param array<string,mixed> $currentManifest
-     * @param array<string,mixed> $calendarManifest
-     * @param array<string,mixed> $fppManifest
      * @param array{calendar:array<string,int>,fpp:array<string,int>} $tombstonesBySource
      * @param int $calendarEpoch
-     * @param string $calendarScope
+     * @param array<int,string> $calendarScopes
      * @return array{calendar:array<string,int>,fpp:array<string,int>}
      */
     private function deriveEffectiveTombstones(
-        array $currentManifest,
-        array $calendarManifest,
-        array $fppManifest,
+        IndexedManifest $current,
+        IndexedManifest $calendar,
+        IndexedManifest $fpp,
         array $tombstonesBySource,
         int $calendarEpoch,
-        string $calendarScope
+        array $calendarScopes
     ): array {
-        $calendarIds = $this->manifestIdentitySet($calendarManifest);
-        $fppIds = $this->manifestIdentitySet($fppManifest);
-        $currentEvents = is_array($currentManifest['events'] ?? null) ? $currentManifest['events'] : [];
-
         // Calendar tombstones: identities that existed in current manifest and are now
         // absent from the refreshed calendar manifest should be treated as deleted by
         // calendar, not recreated from FPP on the next reconcile pass.
-        foreach ($currentEvents as $id => $event) {
-            if (!is_array($event)) {
-                continue;
-            }
+        foreach ($current->events() as $identityId => $event) {
 
             // Only infer a calendar tombstone from events that were actually
             // calendar-originated in the current manifest. This prevents
@@ -819,38 +960,27 @@ final class SchedulerEngine
                 continue;
             }
 
-            // Only infer calendar deletes for events tied to the currently selected
+            // Only infer calendar deletes for events tied to a currently selected
             // calendar. This prevents cross-calendar leakage when users switch calendars.
             $correlation = is_array($event['correlation'] ?? null) ? $event['correlation'] : [];
             $sourceCalendarId = $correlation['sourceCalendarId'] ?? null;
             if (!is_string($sourceCalendarId) || trim($sourceCalendarId) === '') {
                 continue;
             }
-            if (trim($sourceCalendarId) !== $calendarScope) {
+            if (!in_array(trim($sourceCalendarId), $calendarScopes, true)) {
                 continue;
             }
 
-            $identityId = null;
-            if (is_string($id) && $id !== '') {
-                $identityId = $id;
-            } else {
-                $eventId = $event['identityHash'] ?? $event['id'] ?? null;
-                if (is_string($eventId) && $eventId !== '') {
-                    $identityId = $eventId;
-                }
-            }
-            if (!is_string($identityId) || $identityId === '') {
+            if ($calendar->has($identityId)) {
                 continue;
             }
-            if (isset($calendarIds[$identityId])) {
-                continue;
-            }
-            if (!isset($fppIds[$identityId])) {
+            if (!$fpp->has($identityId)) {
                 continue;
             }
 
             if (!isset($tombstonesBySource['calendar'][$identityId])) {
                 $tombstonesBySource['calendar'][$identityId] = $calendarEpoch;
+                $this->calendarTombstoneScopes[$identityId] = trim($sourceCalendarId);
             }
         }
 
@@ -860,7 +990,7 @@ final class SchedulerEngine
             array_keys($tombstonesBySource['fpp'])
         ));
         foreach ($allIds as $id) {
-            if (!isset($calendarIds[$id]) && !isset($fppIds[$id])) {
+            if (!$calendar->has((string)$id) && !$fpp->has((string)$id)) {
                 unset($tombstonesBySource['calendar'][$id], $tombstonesBySource['fpp'][$id]);
             }
         }
@@ -872,41 +1002,91 @@ final class SchedulerEngine
     }
 
     /**
-     * @param array<string,mixed> $manifest
-     * @return array<string,true>
+     * Mark managed current-manifest events that ended before the sync horizon
+     * as archived. The calendar snapshot no longer observes them, so they are
+     * frozen as-is instead of being read as calendar deletes. An archived event
+     * that reappears in the calendar manifest is released back to normal sync.
+     *
+     * @param array<string,mixed> $currentManifest
+     * @return array{0:array<string,mixed>,1:array<string,true>} [currentManifest, archivedIds]
      */
-    private function manifestIdentitySet(array $manifest): array
-    {
-        $out = [];
-        $events = $manifest['events'] ?? [];
-        if (!is_array($events)) {
-            return $out;
+    private function archiveEventsBeforeHorizon(
+        array $currentManifest,
+        IndexedManifest $calendar,
+        ?string $archiveBeforeDate
+    ): array {
+        $events = is_array($currentManifest['events'] ?? null) ? $currentManifest['events'] : [];
+        if ($events === []) {
+            return [$currentManifest, []];
         }
 
-        foreach ($events as $eventKey => $event) {
-            if (is_string($eventKey) && $eventKey !== '') {
-                $out[$eventKey] = true;
+        $archivedIds = [];
+
+        foreach ($events as $id => $event) {
+            if (!is_array($event) || !is_string($id) || $id === '') {
                 continue;
             }
-            if (!is_array($event)) {
+
+            $wasArchived = ($event['archived'] ?? false) === true;
+            if ($calendar->has($id)) {
+                if ($wasArchived) {
+                    unset($events[$id]['archived']);
+                }
+                continue;
+            }
+
+            $ownership = is_array($event['ownership'] ?? null) ? $event['ownership'] : [];
+            if (!(bool)($ownership['managed'] ?? false)) {
                 continue;
             }
-            $id = $event['identityHash'] ?? $event['id'] ?? null;
-            if (is_string($id) && $id !== '') {
-                $out[$id] = true;
+
+            if (!$wasArchived) {
+                $lastEndDate = $archiveBeforeDate !== null ? $this->manifestEventLastEndDate($event) : null;
+                if ($lastEndDate === null || $lastEndDate >= $archiveBeforeDate) {
+                    continue;
+                }
+                $events[$id]['archived'] = true;
             }
+
+            $archivedIds[$id] = true;
         }
 
-        return $out;
+        $currentManifest['events'] = $events;
+        return [$currentManifest, $archivedIds];
+    }
+
+    /**
+     * Latest hard end date (Y-m-d) across subEvents, or null when any subEvent
+     * is open-ended or symbolic (those can never be proven past the horizon).
+     *
+     * @param array<string,mixed> $event
+     */
+    private function manifestEventLastEndDate(array $event): ?string
+    {
+        $subEvents = is_array($event['subEvents'] ?? null) ? $event['subEvents'] : [];
+        $last = null;
+        foreach ($subEvents as $sub) {
+            $end = is_array($sub) ? ($sub['timing']['end_date']['hard'] ?? null) : null;
+            if (!is_string($end) || preg_match('/^\d{4}-\d{2}-\d{2}$/', $end) !== 1) {
+                return null;
+            }
+            if ($last === null || $end > $last) {
+                $last = $end;
+            }
+        }
+
+        return $last;
     }
 
     /**
      * @param array{calendar:array<string,int>,fpp:array<string,int>} $tombstonesBySource
+     * @param array<int,string> $calendarScopes active calendar scopes, primary first
      */
-    private function saveTombstones(string $path, array $tombstonesBySource, string $calendarScope): void
+    private function saveTombstones(string $path, array $tombstonesBySource, array $calendarScopes): void
     {
-        // Keep FPP tombstones global, but namespace calendar tombstones by selected calendar.
-        $calendarScope = trim($calendarScope) !== '' ? trim($calendarScope) : 'default';
+        // Keep FPP tombstones global, but namespace calendar tombstones by the
+        // calendar they were recorded for; inactive calendars' entries are kept.
+        $calendarScopes = $this->normalizeCalendarScopes($calendarScopes);
         $merged = $this->loadedTombstonesBySource;
         if (!isset($merged['calendar']) || !is_array($merged['calendar'])) {
             $merged['calendar'] = [];
@@ -915,10 +1095,12 @@ final class SchedulerEngine
             $merged['fpp'] = [];
         }
 
-        $prefix = $calendarScope . '::';
         foreach (array_keys($merged['calendar']) as $rawKey) {
-            if (is_string($rawKey) && strpos($rawKey, $prefix) === 0) {
-                unset($merged['calendar'][$rawKey]);
+            foreach ($calendarScopes as $scope) {
+                if (is_string($rawKey) && strpos($rawKey, $scope . '::') === 0) {
+                    unset($merged['calendar'][$rawKey]);
+                    break;
+                }
             }
         }
 
@@ -926,7 +1108,11 @@ final class SchedulerEngine
             if (!is_string($id) || $id === '' || !is_int($ts) || $ts <= 0) {
                 continue;
             }
-            $merged['calendar'][$prefix . $id] = $ts;
+            $scope = $this->calendarTombstoneScopes[$id] ?? $calendarScopes[0];
+            if (!in_array($scope, $calendarScopes, true)) {
+                $scope = $calendarScopes[0];
+            }
+            $merged['calendar'][$scope . '::' . $id] = $ts;
         }
 
         $merged['fpp'] = $tombstonesBySource['fpp'];
@@ -952,12 +1138,17 @@ final class SchedulerEngine
     }
 
     /**
+     * Calendar tombstones of every active scope, keyed by bare identity; the
+     * scope each came from is remembered for saveTombstones().
+     *
+     * @param array<int,string> $calendarScopes
      * @return array{calendar:array<string,int>,fpp:array<string,int>}
      */
-    private function loadTombstones(string $path, string $calendarScope): array
+    private function loadTombstones(string $path, array $calendarScopes): array
     {
         $empty = ['calendar' => [], 'fpp' => []];
-        $calendarScope = trim($calendarScope) !== '' ? trim($calendarScope) : 'default';
+        $calendarScopes = $this->normalizeCalendarScopes($calendarScopes);
+        $this->calendarTombstoneScopes = [];
         if (!is_file($path)) {
             $this->loadedTombstonesBySource = $empty;
             return $empty;
@@ -990,19 +1181,127 @@ final class SchedulerEngine
         $this->loadedTombstonesBySource = $rawOut;
 
         $out = ['calendar' => [], 'fpp' => $rawOut['fpp']];
-        $prefix = $calendarScope . '::';
-        foreach ($rawOut['calendar'] as $rawKey => $ts) {
-            if (!is_string($rawKey)) {
-                continue;
+        foreach ($calendarScopes as $scope) {
+            $prefix = $scope . '::';
+            foreach ($rawOut['calendar'] as $rawKey => $ts) {
+                if (!is_string($rawKey)) {
+                    continue;
+                }
+                if (strpos($rawKey, $prefix) !== 0) {
+                    continue;
+                }
+                $identity = substr($rawKey, strlen($prefix));
+                if (!is_string($identity) || $identity === '') {
+                    continue;
+                }
+                if (($out['calendar'][$identity] ?? 0) < $ts) {
+                    $out['calendar'][$identity] = $ts;
+                    $this->calendarTombstoneScopes[$identity] = $scope;
+                }
             }
-            if (strpos($rawKey, $prefix) !== 0) {
-                continue;
+        }
+
+        return $out;
+    }
+
+    /**
+     * @param array<int,array<string,mixed>> $events
+     * @return array<int,Intent> normalized intents, in $events order
+     */
+    private function normalizeManifestEvents(array $events, NormalizationContext $context): array
+    {
+        $intents = [];
+        foreach ($this->runSharded(
+            array_values($events),
+            fn (array $shard): array => array_map(
+                fn (array $event): Intent => $this->normalizer->fromManifestEvent($event, $context),
+                $shard
+            )
+        ) as $shardIntents) {
+            array_push($intents, ...$shardIntents);
+        }
+
+        return $intents;
+    }
+
+    /**
+     * Apply $work to contiguous shards of $items in forked workers and return
+     * the shard results in order, so merging them is deterministic. Runs
+     * in-process (one shard) for small inputs, one worker, or no pcntl.
+     *
+     * Results cross a process boundary serialized; Resolution/Planner DTOs
+     * re-intern their CompactTiming zones on the way back.
+     *
+     * @template T
+     * @param array<int,mixed> $items
+     * @param callable(array<int,mixed>):T $work
+     * @return array<int,T>
+     */
+    private function runSharded(array $items, callable $work): array
+    {
+        $workers = min($this->workerCount, intdiv(count($items), self::SHARD_MIN_ITEMS));
+        if ($workers < 2 || !ProcessPool::supported()) {
+            return [$work($items)];
+        }
+
+        $tasks = [];
+        foreach (array_chunk($items, (int)ceil(count($items) / $workers)) as $i => $shard) {
+            $tasks['shard-' . $i] = static fn () => $work($shard);
+        }
+        Trace::begin('sharded', 'engine', ['items' => count($items), 'shards' => count($tasks)]);
+        $results = array_values((new ProcessPool($workers))->run($tasks));
+        Trace::end();
+
+        return $results;
+    }
+
+    /**
+     * @param array<int,mixed> $calendarScopes
+     * @return array<int,string> non-empty, primary first
+     */
+    private function normalizeCalendarScopes(array $calendarScopes): array
+    {
+        $out = [];
+        foreach ($calendarScopes as $scope) {
+            $scope = is_string($scope) ? trim($scope) : '';
+            if ($scope !== '' && !in_array($scope, $out, true)) {
+                $out[] = $scope;
             }
-            $identity = substr($rawKey, strlen($prefix));
-            if (!is_string($identity) || $identity === '') {
-                continue;
+        }
+
+        return $out !== [] ? $out : ['default'];
+    }
+
+    /**
+     * Calendar a translated row was fetched from; unknown or missing ids
+     * belong to the primary calendar.
+     *
+     * @param array<string,mixed> $row
+     * @param array<int,string> $calendarScopes
+     */
+    private function rowCalendarScope(array $row, array $calendarScopes): string
+    {
+        $calendarId = $row['calendar_id'] ?? ($row['source']['calendar_id'] ?? null);
+        if (is_string($calendarId) && in_array(trim($calendarId), $calendarScopes, true)) {
+            return trim($calendarId);
+        }
+
+        return $calendarScopes[0];
+    }
+
+    /**
+     * @param array<int,mixed> $rows
+     * @param array<int,string> $calendarScopes
+     * @return array<string,array<int,array<string,mixed>>>
+     */
+    private function partitionRowsByCalendarScope(array $rows, array $calendarScopes): array
+    {
+        $out = array_fill_keys($calendarScopes, []);
+        foreach ($rows as $index => $row) {
+            if (is_array($row)) {
+                // Keep row indexes: snapshot source references point into $rows.
+                $out[$this->rowCalendarScope($row, $calendarScopes)][$index] = $row;
             }
-            $out['calendar'][$identity] = $ts;
         }
 
         return $out;
@@ -1025,6 +1324,9 @@ final class SchedulerEngine
         $ranks = [];
         $used = [];
         $missing = $intents;
+        $this->intentOrderingFootprints = [];
+        $this->bundleOrderingFootprints = [];
+        $this->dailyWindowSegmentLists = [];
 
         // Canonical ordering is always enforced. Explicit/manual order metadata is
         // intentionally ignored so scheduler execution stays deterministic.
@@ -1086,7 +1388,11 @@ final class SchedulerEngine
      */
     private function orderBundlesWithConstraints(array $bundleKeys, array $bundleGroups): array
     {
+        Trace::begin('edge build', 'ordering', ['bundles' => count($bundleKeys)]);
         $hardEdges = $this->buildHardBundlePrecedenceEdges($bundleKeys, $bundleGroups);
+        Trace::end(['edges' => count($hardEdges)]);
+
+        Trace::begin('topo sort', 'ordering');
         $adjacency = [];
         $inDegree = [];
 
@@ -1196,6 +1502,7 @@ final class SchedulerEngine
             }
             $available = $dedup;
         }
+        Trace::end();
 
         return $ordered;
     }
@@ -1263,14 +1570,14 @@ final class SchedulerEngine
         }
 
         // Default order: chronological by effective start date/time.
-        $aStart = $a->start->getTimestamp();
-        $bStart = $b->start->getTimestamp();
+        $aStart = $a->startEpoch;
+        $bStart = $b->startEpoch;
         if ($aStart !== $bStart) {
             return $aStart <=> $bStart;
         }
 
-        $aEnd = $a->end->getTimestamp();
-        $bEnd = $b->end->getTimestamp();
+        $aEnd = $a->endEpoch;
+        $bEnd = $b->endEpoch;
         if ($aEnd !== $bEnd) {
             return $aEnd <=> $bEnd;
         }
@@ -1476,14 +1783,7 @@ final class SchedulerEngine
      */
     private function bundleWeekdayCoverageCount(array $bundle): int
     {
-        $days = [];
-        foreach ($bundle as $intent) {
-            foreach (array_keys($this->plannerIntentWeekdaySet($intent)) as $day) {
-                $days[$day] = true;
-            }
-        }
-
-        return max(1, count($days));
+        return max(1, self::weekdayCount($this->bundleOrderingFootprint($bundle)['days']));
     }
 
     /**
@@ -1579,7 +1879,7 @@ final class SchedulerEngine
             }
         }
 
-        return $this->secondsSinceMidnight($intent->start);
+        return $intent->startSecond;
     }
 
     /**
@@ -1654,20 +1954,19 @@ final class SchedulerEngine
         $belowEnd = $this->bundleAnchorEnd($below);
         $dateContains = $aboveStart <= $belowStart && $aboveEnd >= $belowEnd;
 
-        $aboveDays = $this->bundleWeekdaySet($above);
-        $belowDays = $this->bundleWeekdaySet($below);
-        $daysContains = $this->weekdaySetContains($aboveDays, $belowDays);
+        $aboveFootprint = $this->bundleOrderingFootprint($above);
+        $belowFootprint = $this->bundleOrderingFootprint($below);
+        $daysContains = ($belowFootprint['days'] & ~$aboveFootprint['days']) === 0;
 
-        $aboveSegments = $this->bundleDailyWindowSegments($above);
-        $belowSegments = $this->bundleDailyWindowSegments($below);
-        if ($aboveSegments === null || $belowSegments === null) {
-            return false;
-        }
-        $timeContains = $this->segmentsContain($aboveSegments, $belowSegments);
+        $timeContains = $this->segmentsContain(
+            $this->dailyWindowSegmentLists[$aboveFootprint['window']],
+            $this->dailyWindowSegmentLists[$belowFootprint['window']]
+        );
 
         $strictDate = $aboveStart < $belowStart || $aboveEnd > $belowEnd;
-        $strictDays = count($aboveDays) > count($belowDays);
-        $strictTime = !$this->segmentsEqual($aboveSegments, $belowSegments);
+        $strictDays = self::weekdayCount($aboveFootprint['days']) > self::weekdayCount($belowFootprint['days']);
+        // Interned: equal segment lists share one key.
+        $strictTime = $aboveFootprint['window'] !== $belowFootprint['window'];
 
         return $dateContains
             && $daysContains
@@ -1676,39 +1975,21 @@ final class SchedulerEngine
     }
 
     /**
-     * @param array<int,array{0:int,1:int}> $segments
-     */
-    private function segmentsEqual(array $first, array $second): bool
-    {
-        if (count($first) !== count($second)) {
-            return false;
-        }
-        foreach ($first as $i => $segment) {
-            if (!isset($second[$i])) {
-                return false;
-            }
-            if ($segment[0] !== $second[$i][0] || $segment[1] !== $second[$i][1]) {
-                return false;
-            }
-        }
-        return true;
-    }
-
-    /**
+     * Linear merge over two sorted, merged (disjoint) segment lists.
+     *
      * @param array<int,array{0:int,1:int}> $container
      * @param array<int,array{0:int,1:int}> $containee
      */
     private function segmentsContain(array $container, array $containee): bool
     {
+        $i = 0;
+        $count = count($container);
         foreach ($containee as $need) {
-            $covered = false;
-            foreach ($container as $have) {
-                if ($have[0] <= $need[0] && $have[1] >= $need[1]) {
-                    $covered = true;
-                    break;
-                }
+            // Container segments ending before this one cannot cover it or any later one.
+            while ($i < $count && $container[$i][1] < $need[1]) {
+                $i++;
             }
-            if (!$covered) {
+            if ($i === $count || $container[$i][0] > $need[0]) {
                 return false;
             }
         }
@@ -1721,6 +2002,11 @@ final class SchedulerEngine
      */
     private function bundlesOverlapForOrdering(array $first, array $second): bool
     {
+        // Intent weekday masks are subsets of their bundle's mask.
+        if (($this->bundleOrderingFootprint($first)['days'] & $this->bundleOrderingFootprint($second)['days']) === 0) {
+            return false;
+        }
+
         foreach ($first as $firstIntent) {
             foreach ($second as $secondIntent) {
                 if ($this->plannerIntentsOverlapForOrdering($firstIntent, $secondIntent)) {
@@ -1733,25 +2019,24 @@ final class SchedulerEngine
 
     private function plannerIntentsOverlapForOrdering(PlannerIntent $first, PlannerIntent $second): bool
     {
-        $firstScopeStart = $first->scope->getStart()->getTimestamp();
-        $firstScopeEnd = $first->scope->getEnd()->getTimestamp();
-        $secondScopeStart = $second->scope->getStart()->getTimestamp();
-        $secondScopeEnd = $second->scope->getEnd()->getTimestamp();
+        $firstScopeStart = $first->scope->getStartEpoch();
+        $firstScopeEnd = $first->scope->getEndEpoch();
+        $secondScopeStart = $second->scope->getStartEpoch();
+        $secondScopeEnd = $second->scope->getEndEpoch();
 
         // Touching edges do not overlap.
         if (max($firstScopeStart, $secondScopeStart) >= min($firstScopeEnd, $secondScopeEnd)) {
             return false;
         }
 
-        if (!$this->weekdaySetsIntersect(
-            $this->plannerIntentWeekdaySet($first),
-            $this->plannerIntentWeekdaySet($second)
-        )) {
+        $firstFootprint = $this->plannerIntentOrderingFootprint($first);
+        $secondFootprint = $this->plannerIntentOrderingFootprint($second);
+        if (($firstFootprint['days'] & $secondFootprint['days']) === 0) {
             return false;
         }
 
-        $firstSegments = $this->intentDailyWindowSegments($first);
-        $secondSegments = $this->intentDailyWindowSegments($second);
+        $firstSegments = $this->dailyWindowSegmentLists[$firstFootprint['window']];
+        $secondSegments = $this->dailyWindowSegmentLists[$secondFootprint['window']];
 
         foreach ($firstSegments as $a) {
             foreach ($secondSegments as $b) {
@@ -1765,84 +2050,83 @@ final class SchedulerEngine
     }
 
     /**
-     * @param array<int,PlannerIntent> $bundle
-     * @return array<string,bool>
+     * @return array{days:int,window:string}
      */
-    private function bundleWeekdaySet(array $bundle): array
+    private function plannerIntentOrderingFootprint(PlannerIntent $intent): array
     {
-        $days = [];
-        foreach ($bundle as $intent) {
-            foreach (array_keys($this->plannerIntentWeekdaySet($intent)) as $day) {
-                $days[$day] = true;
-            }
-        }
-        return $days;
+        $id = spl_object_id($intent);
+        return $this->intentOrderingFootprints[$id] ??= [
+            'days' => $this->plannerIntentWeekdayMask($intent),
+            'window' => $this->internDailyWindowSegments($this->computeIntentDailyWindowSegments($intent)),
+        ];
     }
 
     /**
-     * @param array<string,bool> $first
-     * @param array<string,bool> $second
+     * Union of the bundle's weekday masks and its merged daily window.
+     *
+     * @param array<int,PlannerIntent> $bundle
+     * @return array{days:int,window:string}
      */
-    private function weekdaySetsIntersect(array $first, array $second): bool
+    private function bundleOrderingFootprint(array $bundle): array
     {
-        foreach ($first as $day => $_) {
-            if (isset($second[$day])) {
-                return true;
-            }
+        $first = $bundle[array_key_first($bundle)] ?? null;
+        $id = $first instanceof PlannerIntent ? spl_object_id($first) : null;
+        if ($id !== null && isset($this->bundleOrderingFootprints[$id])) {
+            return $this->bundleOrderingFootprints[$id];
         }
-        return false;
+
+        $days = 0;
+        foreach ($bundle as $intent) {
+            $days |= $this->plannerIntentOrderingFootprint($intent)['days'];
+        }
+        $footprint = [
+            'days' => $days,
+            'window' => $this->internDailyWindowSegments($this->bundleDailyWindowSegments($bundle)),
+        ];
+        if ($id !== null) {
+            $this->bundleOrderingFootprints[$id] = $footprint;
+        }
+
+        return $footprint;
     }
 
-    /**
-     * @param array<string,bool> $container
-     * @param array<string,bool> $containee
-     */
-    private function weekdaySetContains(array $container, array $containee): bool
+    private function plannerIntentWeekdayMask(PlannerIntent $intent): int
     {
-        foreach ($containee as $day => $_) {
-            if (!isset($container[$day])) {
-                return false;
-            }
+        // Ordering has always read weekday tokens trimmed and case-insensitively.
+        $mask = is_array($intent->weeklyDays)
+            ? FPPSemantics::weekdayMask(array_map(
+                static fn (mixed $day): mixed => is_string($day) ? strtoupper(trim($day)) : $day,
+                $intent->weeklyDays
+            ))
+            : 0;
+
+        // Unspecified (or unrecognized) day mask is conservatively treated as all days.
+        return $mask === 0 ? FPPSemantics::DAY_MASK_ALL : $mask;
+    }
+
+    private static function weekdayCount(int $mask): int
+    {
+        $count = 0;
+        for (; $mask !== 0; $mask &= $mask - 1) {
+            $count++;
         }
-        return true;
+        return $count;
     }
 
     /**
-     * @return array<string,bool>
+     * @param array<int,array{0:int,1:int}> $segments
+     * @return string key into dailyWindowSegmentLists
      */
-    private function plannerIntentWeekdaySet(PlannerIntent $intent): array
+    private function internDailyWindowSegments(array $segments): string
     {
-        $days = is_array($intent->weeklyDays) ? $intent->weeklyDays : [];
-        if ($days === []) {
-            // Unspecified day mask is conservatively treated as all days.
-            $days = ['SU', 'MO', 'TU', 'WE', 'TH', 'FR', 'SA'];
-        }
-
-        $set = [];
-        foreach ($days as $day) {
-            if (!is_string($day)) {
-                continue;
-            }
-            $token = strtoupper(trim($day));
-            if ($token === '') {
-                continue;
-            }
-            $set[$token] = true;
-        }
-
-        if ($set === []) {
-            return [
-                'SU' => true,
-                'MO' => true,
-                'TU' => true,
-                'WE' => true,
-                'TH' => true,
-                'FR' => true,
-                'SA' => true,
-            ];
+        $parts = [];
+        foreach ($segments as $segment) {
+            $parts[] = $segment[0] . '-' . $segment[1];
         }
+        $key = implode(',', $parts);
+        $this->dailyWindowSegmentLists[$key] ??= $segments;
 
-        return $set;
+        return $key;
     }
 
     private function intentUsesSymbolicDailyTime(PlannerIntent $intent): bool
@@ -1864,9 +2148,9 @@ final class SchedulerEngine
 
     /**
      * @param array<int,PlannerIntent> $bundle
-     * @return array<int,array{0:int,1:int}>|null
+     * @return array<int,array{0:int,1:int}> sorted and merged
      */
-    private function bundleDailyWindowSegments(array $bundle): ?array
+    private function bundleDailyWindowSegments(array $bundle): array
     {
         $segments = [];
         foreach ($bundle as $intent) {
@@ -1885,6 +2169,14 @@ final class SchedulerEngine
      * @return array<int,array{0:int,1:int}>
      */
     private function intentDailyWindowSegments(PlannerIntent $intent): array
+    {
+        return $this->dailyWindowSegmentLists[$this->plannerIntentOrderingFootprint($intent)['window']];
+    }
+
+    /**
+     * @return array<int,array{0:int,1:int}>
+     */
+    private function computeIntentDailyWindowSegments(PlannerIntent $intent): array
     {
         if ($intent->allDay) {
             return [[0, 86400]];
@@ -1901,18 +2193,18 @@ final class SchedulerEngine
         if ($startSetting !== '' || $endSetting !== '') {
             $start = $startSetting !== ''
                 ? $this->resolveDailyTimeSeconds($intent, $startSetting, 'start')
-                : $this->secondsSinceMidnight($intent->start);
+                : $intent->startSecond;
             $end = $endSetting !== ''
                 ? $this->resolveDailyTimeSeconds($intent, $endSetting, 'end')
-                : $this->secondsSinceMidnight($intent->end);
+                : $intent->endSecond;
 
             if ($start === null || $end === null) {
                 // Unknown symbolic tokens must remain conservative for overlap logic.
                 return [[0, 86400]];
             }
         } else {
-            $start = $this->secondsSinceMidnight($intent->start);
-            $end = $this->secondsSinceMidnight($intent->end);
+            $start = $intent->startSecond;
+            $end = $intent->endSecond;
         }
 
         if ($start === $end) {
@@ -1931,13 +2223,6 @@ final class SchedulerEngine
         ];
     }
 
-    private function secondsSinceMidnight(\DateTimeImmutable $value): int
-    {
-        return ((int)$value->format('H')) * 3600
-            + ((int)$value->format('i')) * 60
-            + (int)$value->format('s');
-    }
-
     /**
      * Resolve a scheduler time setting into seconds since local midnight.
      */
@@ -1977,9 +2262,7 @@ final class SchedulerEngine
             $tz = new \DateTimeZone('UTC');
         }
 
-        $anchorDate = $intent->scope->getStart()
-            ->setTimezone($tz)
-            ->format('Y-m-d');
+        $anchorDate = $intent->scope->startDateIn($tz);
 
         $cacheKey = implode('|', [
             $anchorDate,
@@ -1995,15 +2278,8 @@ final class SchedulerEngine
 
         $seconds = null;
         if ($this->orderingLatitude !== null && $this->orderingLongitude !== null) {
-            $estimated = SunTimeDisplayEstimator::estimate(
-                $anchorDate,
-                $symbolic,
-                $this->orderingLatitude,
-                $this->orderingLongitude,
-                $tzName,
-                $offsetMinutes,
-                30
-            );
+            $estimated = SunTimeTable::for($this->orderingLatitude, $this->orderingLongitude, $tzName)
+                ->displayTime($anchorDate, $symbolic, $offsetMinutes, 30);
             if (is_string($estimated) && $estimated !== '') {
                 $seconds = $this->parseHardTimeSeconds($estimated);
             }
@@ -2161,7 +2437,7 @@ final class SchedulerEngine
     {
         $min = PHP_INT_MAX;
         foreach ($bundleIntents as $intent) {
-            $ts = $intent->start->getTimestamp();
+            $ts = $intent->startEpoch;
             if ($ts < $min) {
                 $min = $ts;
             }
@@ -2176,7 +2452,7 @@ final class SchedulerEngine
     {
         $max = PHP_INT_MIN;
         foreach ($bundleIntents as $intent) {
-            $ts = $intent->end->getTimestamp();
+            $ts = $intent->endEpoch;
             if ($ts > $max) {
                 $max = $ts;
             }
@@ -2518,34 +2794,26 @@ final class SchedulerEngine
      * Refresh the calendar snapshot by pulling directly from the configured provider runtime.
      *
      * Writes a deterministic JSON wrapper to $calendarSnapshotPath:
-     *   { "calendar_id": "...", "events": [ ...provider-agnostic rows... ] }
+     *   { "calendar_id": "...", "horizon": {...}, "events": [ ...provider-agnostic rows... ] }
+     *
+     * "horizon" records the fetch window; its start is the archive cutoff for the run.
+     *
+     * When the provider config lists several calendars (calendar_ids), each one
+     * is fetched and translated by its own worker process and the results are
+     * merged in configuration order; the wrapper then also carries
+     * "calendar_ids" and every row keeps its own "calendar_id".
+     *
+     * Each calendar's translated rows are cached next to the snapshot and
+     * reused for events whose etag/changeKey is unchanged.
      *
      * @throws \RuntimeException on any failure.
      */
-    private function refreshCalendarSnapshotFromProvider(
+    public function refreshCalendarSnapshotFromProvider(
         string $calendarSnapshotPath,
         string $provider
     ): void {
         $provider = $this->normalizeCalendarProvider($provider);
 
-        $runtime = ProviderRuntimeFactory::createSnapshot($provider);
-        $translatedEvents = $runtime->translatedEvents();
-
-        $payload = [
-            'provider'     => $runtime->providerName(),
-            'calendar_id'  => $runtime->calendarId(),
-            'events'       => $translatedEvents,
-            'generated_at' => (new \DateTimeImmutable(
-                'now',
-                new \DateTimeZone('UTC')
-            ))->format(DATE_ATOM),
-        ];
-
-        $json = json_encode(
-            $payload,
-            JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR
-        );
-
         $dir = dirname($calendarSnapshotPath);
         if (!is_dir($dir)) {
             if (!mkdir($dir, 0775, true) && !is_dir($dir)) {
@@ -2553,8 +2821,146 @@ final class SchedulerEngine
             }
         }
 
+        $calendarIds = ProviderRuntimeFactory::calendarIds($provider);
+        if (count($calendarIds) > 1) {
+            $this->refreshMultiCalendarSnapshot($calendarSnapshotPath, $provider, $calendarIds);
+            return;
+        }
+
+        $runtime = ProviderRuntimeFactory::createSnapshot($provider, null, $dir);
+
+        $flags = JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR;
+        $this->writeCalendarSnapshot(
+            $calendarSnapshotPath,
+            '    "provider": ' . json_encode($runtime->providerName(), $flags) . ",\n"
+                . '    "calendar_id": ' . json_encode($runtime->calendarId(), $flags) . ",\n"
+                . '    "horizon": ' . json_encode($runtime->syncHorizon()->toArray(), $flags) . ",\n",
+            (static function (array $rows) use ($flags): \Generator {
+                foreach ($rows as $row) {
+                    yield json_encode($row, $flags);
+                }
+            })($runtime->translatedEvents())
+        );
+    }
+
+    /**
+     * Fetch every calendar concurrently (one worker per calendar), each into
+     * its own part file of encoded rows, then merge the parts into one snapshot.
+     *
+     * @param array<int,string> $calendarIds primary first
+     */
+    private function refreshMultiCalendarSnapshot(string $calendarSnapshotPath, string $provider, array $calendarIds): void
+    {
+        // One token refresh up front instead of one per worker.
+        ProviderRuntimeFactory::authenticate($provider);
+
+        $flags = JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR;
+        $cacheDir = dirname($calendarSnapshotPath);
+        $tasks = [];
+        foreach ($calendarIds as $i => $calendarId) {
+            $partPath = $calendarSnapshotPath . '.part' . $i;
+            $tasks[$calendarId] = static function () use ($provider, $calendarId, $partPath, $flags, $cacheDir): array {
+                $runtime = ProviderRuntimeFactory::createSnapshot($provider, $calendarId, $cacheDir);
+                // Rows go to the part file as they are translated, so a
+                // calendar's rows are never held as one string.
+                $fh = @fopen($partPath, 'wb');
+                if ($fh === false) {
+                    throw new \RuntimeException("Failed to write calendar snapshot part: {$partPath}");
+                }
+                try {
+                    foreach ($runtime->translatedEvents() as $row) {
+                        if (fwrite($fh, json_encode($row, $flags) . "\n") === false) {
+                            throw new \RuntimeException("Failed to write calendar snapshot part: {$partPath}");
+                        }
+                    }
+                } finally {
+                    fclose($fh);
+                }
+
+                return [
+                    'provider' => $runtime->providerName(),
+                    'horizon' => $runtime->syncHorizon()->toArray(),
+                    'part' => $partPath,
+                ];
+            };
+        }
+
+        $parts = [];
+        try {
+            $parts = (new ProcessPool(count($calendarIds)))->run($tasks);
+            $primary = $parts[$calendarIds[0]];
+
+            $this->writeCalendarSnapshot(
+                $calendarSnapshotPath,
+                '    "provider": ' . json_encode($primary['provider'], $flags) . ",\n"
+                    . '    "calendar_id": ' . json_encode($calendarIds[0], $flags) . ",\n"
+                    . '    "calendar_ids": ' . json_encode(array_values($calendarIds), $flags) . ",\n"
+                    . '    "horizon": ' . json_encode($primary['horizon'], $flags) . ",\n",
+                (static function () use ($parts): \Generator {
+                    foreach ($parts as $part) {
+                        $fh = @fopen($part['part'], 'rb');
+                        if ($fh === false) {
+                            throw new \RuntimeException("Failed to read calendar snapshot part: {$part['part']}");
+                        }
+                        try {
+                            while (($line = fgets($fh)) !== false) {
+                                $line = rtrim($line, "\n");
+                                if ($line !== '') {
+                                    yield $line;
+                                }
+                            }
+                        } finally {
+                            fclose($fh);
+                        }
+                    }
+                })()
+            );
+        } finally {
+            foreach (array_keys($calendarIds) as $i) {
+                @unlink($calendarSnapshotPath . '.part' . $i);
+            }
+        }
+    }
+
+    /**
+     * Atomically write a snapshot wrapper around already-encoded rows.
+     *
+     * Rows are written one at a time so the whole snapshot never exists as
+     * a second in-memory JSON string alongside the translated rows.
+     *
+     * @param string $header wrapper fields before "events", one per line with trailing commas
+     * @param iterable<string> $encodedRows
+     */
+    private function writeCalendarSnapshot(string $calendarSnapshotPath, string $header, iterable $encodedRows): void
+    {
         $tmp = $calendarSnapshotPath . '.tmp';
-        if (file_put_contents($tmp, $json . PHP_EOL) === false) {
+        $fh = fopen($tmp, 'wb');
+        if ($fh === false) {
+            throw new \RuntimeException("Failed to write temp calendar snapshot: {$tmp}");
+        }
+
+        $flags = JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR;
+        try {
+            $ok = fwrite($fh, "{\n" . $header . '    "events": [') !== false;
+
+            $first = true;
+            foreach ($encodedRows as $encoded) {
+                $ok = $ok && fwrite($fh, ($first ? "\n        " : ",\n        ") . $encoded) !== false;
+                $first = false;
+            }
+
+            $generatedAt = (new \DateTimeImmutable('now', new \DateTimeZone('UTC')))->format(DATE_ATOM);
+            $ok = $ok && fwrite($fh, ($first ? '' : "\n    ") . "],\n"
+                . '    "generated_at": ' . json_encode($generatedAt, $flags) . "\n}\n") !== false;
+        } catch (\Throwable $e) {
+            fclose($fh);
+            @unlink($tmp);
+            throw $e;
+        }
+        fclose($fh);
+
+        if (!$ok) {
+            @unlink($tmp);
             throw new \RuntimeException("Failed to write temp calendar snapshot: {$tmp}");
         }
 
@@ -11,6 +11,7 @@ declare(strict_types=1);
 namespace CalendarScheduler\Engine;
 
 use CalendarScheduler\Diff\DiffResult;
+use CalendarScheduler\Diff\IndexedManifest;
 use CalendarScheduler\Diff\ReconciliationResult;
 use CalendarScheduler\Diff\ReconciliationAction;
 
@@ -56,6 +57,8 @@ final class SchedulerRunResult
 
     private \DateTimeImmutable $generatedAt;
 
+    private ?IndexedManifest $currentIndex;
+
     /**
      * @param array<string,mixed> $currentManifest
      * @param array<string,mixed> $calendarManifest
@@ -69,7 +72,8 @@ final class SchedulerRunResult
         ReconciliationResult $reconciliationResult,
         int $calendarSnapshotEpoch,
         int $fppSnapshotEpoch,
-        ?\DateTimeImmutable $generatedAt = null
+        ?\DateTimeImmutable $generatedAt = null,
+        ?IndexedManifest $currentIndex = null
     ) {
         $this->currentManifest       = $currentManifest;
         $this->calendarManifest      = $calendarManifest;
@@ -80,6 +84,7 @@ final class SchedulerRunResult
         $this->fppSnapshotEpoch      = $fppSnapshotEpoch;
         $this->generatedAt           = $generatedAt
             ?? new \DateTimeImmutable('now', new \DateTimeZone('UTC'));
+        $this->currentIndex          = $currentIndex;
     }
 
     // ---------------------------------------------------------------------
@@ -92,6 +97,14 @@ final class SchedulerRunResult
         return $this->currentManifest;
     }
 
+    /**
+     * Identity index of the current manifest (the engine's own when supplied).
+     */
+    public function currentIndex(): IndexedManifest
+    {
+        return $this->currentIndex ??= IndexedManifest::fromManifest($this->currentManifest);
+    }
+
     /** @return array<string,mixed> */
     public function calendarManifest(): array
     {
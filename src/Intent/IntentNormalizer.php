@@ -11,6 +11,7 @@ declare(strict_types=1);
 namespace CalendarScheduler\Intent;
 
 use CalendarScheduler\Intent\NormalizationContext;
+use CalendarScheduler\Platform\HashScheme;
 use CalendarScheduler\Platform\HolidayResolver;
 
 /**
@@ -158,8 +159,7 @@ final class IntentNormalizer
             ];
 
             $stateHashInput = $this->canonicalizeForStateHash($subEvent);
-            $stateHashJson  = json_encode($stateHashInput, JSON_THROW_ON_ERROR);
-            $subEvent['stateHash'] = hash('sha256', $stateHashJson);
+            $subEvent['stateHash'] = HashScheme::digest($stateHashInput);
 
             $normalizedSubEvents[] = $subEvent;
         }
@@ -196,8 +196,7 @@ final class IntentNormalizer
             ]
         );
 
-        $identityHashJson  = json_encode($identityHashInput, JSON_THROW_ON_ERROR);
-        $identityHash      = hash('sha256', $identityHashJson);
+        $identityHash      = HashScheme::digest($identityHashInput);
 
         // Event-level state hash from all normalized subevents in deterministic order.
         $subEventStateHashes = array_map(
@@ -207,10 +206,7 @@ final class IntentNormalizer
         // Event state equality should not depend on subEvent array ordering.
         // Calendar and FPP ingestion can produce equivalent subevents in different orders.
         sort($subEventStateHashes, SORT_STRING);
-        $eventStateHash = hash(
-            'sha256',
-            json_encode($subEventStateHashes, JSON_THROW_ON_ERROR)
-        );
+        $eventStateHash = HashScheme::digest($subEventStateHashes);
 
         return new Intent(
             $identityHash,
@@ -747,13 +743,10 @@ final class IntentNormalizer
             $hard = $timing[$k]['hard'] ?? null;
             $sym  = $timing[$k]['symbolic'] ?? null;
 
-            if (is_string($hard) && $hard !== '' && ($sym === null || $sym === '')) {
-                $dt = \DateTimeImmutable::createFromFormat('Y-m-d', $hard);
-                if ($dt instanceof \DateTimeImmutable) {
-                    $resolved = $resolver->holidayFromDate($dt);
-                    if (is_string($resolved) && $resolved !== '') {
-                        $timing[$k]['symbolic'] = $resolved;
-                    }
+            if (is_string($hard) && ($sym === null || $sym === '') && preg_match('/^\d{4}-\d{2}-\d{2}$/', $hard) === 1) {
+                $resolved = $resolver->holidayFromYmd($hard);
+                if (is_string($resolved) && $resolved !== '') {
+                    $timing[$k]['symbolic'] = $resolved;
                 }
             }
         }
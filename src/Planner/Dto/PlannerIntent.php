@@ -10,7 +10,10 @@ declare(strict_types=1);
 
 namespace CalendarScheduler\Planner\Dto;
 
+use CalendarScheduler\Resolution\Dto\CompactTiming;
+use CalendarScheduler\Resolution\Dto\PayloadPool;
 use CalendarScheduler\Resolution\Dto\ResolutionScope;
+use CalendarScheduler\Resolution\Dto\ResolvedSubevent;
 use DateTimeImmutable;
 
 /**
@@ -21,11 +24,13 @@ use DateTimeImmutable;
  *
  * Order matters: intents are evaluated top-down by the planner.
  *
+ * Start/end are kept as CompactTiming integers (epoch, local second of day,
+ * timezone id); start()/end() materialize DateTimes where one is needed.
+ * They may represent symbolic display time and are not execution-resolved here.
+ *
  * @param string $role One of ResolutionRole::BASE | ResolutionRole::OVERRIDE
  * @param array<string,mixed> $payload
  * @param array $sourceTrace
- * @param DateTimeImmutable $start Start time, may represent symbolic display time and is not execution-resolved here.
- * @param DateTimeImmutable $end End time, may represent symbolic display time and is not execution-resolved here.
  */
 final class PlannerIntent
 {
@@ -34,8 +39,17 @@ final class PlannerIntent
     public string $sourceEventUid;
     public string $provider;
 
-    public DateTimeImmutable $start;
-    public DateTimeImmutable $end;
+    public int $startEpoch;
+    public int $endEpoch;
+
+    /** Local seconds since midnight of start/end. */
+    public int $startSecond;
+    public int $endSecond;
+
+    /** CompactTiming timezone ids of start/end. */
+    public int $startZone;
+    public int $endZone;
+
     public bool $allDay;
     public ?string $timezone;
 
@@ -84,8 +98,12 @@ final class PlannerIntent
         $this->parentUid = $parentUid;
         $this->sourceEventUid = $sourceEventUid;
         $this->provider = $provider;
-        $this->start = $start;
-        $this->end = $end;
+        $this->startEpoch = $start->getTimestamp();
+        $this->endEpoch = $end->getTimestamp();
+        $this->startSecond = CompactTiming::secondOfDay($start);
+        $this->endSecond = CompactTiming::secondOfDay($end);
+        $this->startZone = CompactTiming::zoneId($start->getTimezone());
+        $this->endZone = CompactTiming::zoneId($end->getTimezone());
         $this->allDay = $allDay;
         $this->timezone = $timezone;
         $this->role = $role;
@@ -95,4 +113,67 @@ final class PlannerIntent
         $this->sourceTrace = $sourceTrace;
         $this->weeklyDays = $weeklyDays;
     }
+
+    /**
+     * Intent for a resolved subevent, copying its timing integers as-is
+     * (no DateTime round trip).
+     */
+    public static function fromSubevent(ResolvedSubevent $subevent): self
+    {
+        static $class = null;
+        $class ??= new \ReflectionClass(self::class);
+
+        /** @var self $intent */
+        $intent = $class->newInstanceWithoutConstructor();
+        $intent->bundleUid = $subevent->getBundleUid();
+        $intent->parentUid = $subevent->getParentUid();
+        $intent->sourceEventUid = $subevent->getSourceEventUid();
+        $intent->provider = $subevent->getProvider();
+        $intent->startEpoch = $subevent->getStartEpoch();
+        $intent->endEpoch = $subevent->getEndEpoch();
+        $intent->startSecond = $subevent->getStartSecond();
+        $intent->endSecond = $subevent->getEndSecond();
+        $intent->startZone = $subevent->getStartZoneId();
+        $intent->endZone = $subevent->getEndZoneId();
+        $intent->allDay = $subevent->isAllDay();
+        $intent->timezone = $subevent->getTimezone();
+        $intent->role = $subevent->getRole();
+        $intent->scope = $subevent->getScope();
+        $intent->priority = $subevent->getPriority();
+        $intent->payload = $subevent->getPayload();
+        $intent->sourceTrace = $subevent->getSourceTrace();
+        $intent->weeklyDays = $subevent->getWeeklyDays();
+
+        return $intent;
+    }
+
+    public function start(): DateTimeImmutable
+    {
+        return CompactTiming::materialize($this->startEpoch, $this->startZone);
+    }
+
+    public function end(): DateTimeImmutable
+    {
+        return CompactTiming::materialize($this->endEpoch, $this->endZone);
+    }
+
+    /**
+     * @return array<string,mixed>
+     */
+    public function __serialize(): array
+    {
+        return CompactTiming::exportZones(get_object_vars($this), 'startZone', 'endZone');
+    }
+
+    /**
+     * @param array<string,mixed> $data
+     */
+    public function __unserialize(array $data): void
+    {
+        // Payloads come back as separate copies; share them again.
+        $data['payload'] = PayloadPool::intern($data['payload']);
+        foreach (CompactTiming::importZones($data, 'startZone', 'endZone') as $name => $value) {
+            $this->$name = $value;
+        }
+    }
 }
@@ -11,6 +11,7 @@ declare(strict_types=1);
 namespace CalendarScheduler\Planner;
 
 use CalendarScheduler\Intent\Intent;
+use CalendarScheduler\Platform\HashScheme;
 
 /**
  * ManifestPlanner
@@ -184,10 +185,7 @@ final class ManifestPlanner
             $subEvents
         );
         sort($subStateHashes, SORT_STRING);
-        $eventStateHash = hash(
-            'sha256',
-            implode('|', $subStateHashes)
-        );
+        $eventStateHash = HashScheme::digestString(implode('|', $subStateHashes));
 
         // Invariants
         if (($intent->ownership['managed'] ?? false) && $subEvents === []) {
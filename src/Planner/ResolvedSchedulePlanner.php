@@ -56,21 +56,7 @@ final class ResolvedSchedulePlanner
 
         foreach ($schedule->getBundles() as $bundle) {
             foreach ($bundle->getSubevents() as $subevent) {
-                $intents[] = new \CalendarScheduler\Planner\Dto\PlannerIntent(
-                    bundleUid:      $subevent->getBundleUid(),
-                    parentUid:      $subevent->getParentUid(),
-                    sourceEventUid: $subevent->getSourceEventUid(),
-                    provider:       $subevent->getProvider(),
-                    start:          $subevent->getStart(),
-                    end:            $subevent->getEnd(),
-                    allDay:         $subevent->isAllDay(),
-                    timezone:       $subevent->getTimezone(),
-                    role:           $subevent->getRole(),
-                    scope:          $subevent->getScope(),
-                    priority:       $subevent->getPriority(),
-                    payload:        $subevent->getPayload(),
-                    sourceTrace:    $subevent->getSourceTrace()
-                );
+                $intents[] = \CalendarScheduler\Planner\Dto\PlannerIntent::fromSubevent($subevent);
             }
         }
 
@@ -135,10 +121,7 @@ final class ResolvedSchedulePlanner
 
         // IMPORTANT:
         // Use scope start for ordering, not display start.
-        $startEpochSeconds = $subevent
-            ->getScope()
-            ->getStart()
-            ->getTimestamp();
+        $startEpochSeconds = $subevent->getScope()->getStartEpoch();
 
         return new OrderingKey(
             $managedPriority,
@@ -56,7 +56,7 @@ final class FppEventTimestampStore
             }
         }
 
-        $context = $this->buildNormalizationContext();
+        $context = self::runtimeNormalizationContext();
         $adapter = new FppScheduleAdapter();
         $normalizer = new IntentNormalizer();
 
@@ -197,7 +197,10 @@ final class FppEventTimestampStore
         return $out;
     }
 
-    private function buildNormalizationContext(): NormalizationContext
+    /**
+     * Context used outside a full engine run (UTC, holidays from the runtime export).
+     */
+    public static function runtimeNormalizationContext(): NormalizationContext
     {
         $runtimePath = '/home/fpp/media/config/calendar-scheduler/runtime/fpp-runtime.json';
         $holidays = [];
@@ -222,7 +225,7 @@ final class FppEventTimestampStore
         return new NormalizationContext(
             new \DateTimeZone('UTC'),
             new FPPSemantics(),
-            new HolidayResolver($holidays)
+            (new HolidayTableCache())->resolver($holidays)
         );
     }
 
@@ -308,6 +308,9 @@ final class FPPSemantics
         0x00100 => 'SA',
     ];
 
+    // All weekday bits of DAY_MASK_BITS (without DAY_MASK_FLAG).
+    public const DAY_MASK_ALL = 0x07F00;
+
     /**
      * Normalize FPP day encoding into a canonical list of weekday tokens.
      *
@@ -370,13 +373,7 @@ final class FPPSemantics
 
         // Day mask mode
         if ($value & self::DAY_MASK_FLAG) {
-            $days = [];
-
-            foreach (self::DAY_MASK_BITS as $bit => $code) {
-                if ($value & $bit) {
-                    $days[] = $code;
-                }
-            }
+            $days = self::weekdaysFromMask($value);
 
             if ($days === []) {
                 return null;
@@ -438,16 +435,47 @@ final class FPPSemantics
         }
 
         // Fall back to bitmask encoding
-        $mask = self::DAY_MASK_FLAG;
-        foreach (self::DAY_MASK_BITS as $bit => $code) {
-            if (in_array($code, $days, true)) {
-                $mask |= $bit;
+        return self::DAY_MASK_FLAG | self::weekdayMask($days);
+    }
+
+    /**
+     * Weekday bits (DAY_MASK_BITS, without DAY_MASK_FLAG) of a list of weekday
+     * tokens. Only exact canonical tokens (SU..SA) count, as in
+     * denormalizeDays(); anything else is ignored. Callers that accept looser
+     * input normalize it first.
+     */
+    public static function weekdayMask(array $days): int
+    {
+        static $bitsByCode = null;
+        $bitsByCode ??= array_flip(self::DAY_MASK_BITS);
+
+        $mask = 0;
+        foreach ($days as $day) {
+            if (is_string($day)) {
+                $mask |= $bitsByCode[$day] ?? 0;
             }
         }
 
         return $mask;
     }
 
+    /**
+     * Weekday tokens (SU..SA order) of the weekday bits in $mask.
+     *
+     * @return array<int,string>
+     */
+    public static function weekdaysFromMask(int $mask): array
+    {
+        $days = [];
+        foreach (self::DAY_MASK_BITS as $bit => $code) {
+            if ($mask & $bit) {
+                $days[] = $code;
+            }
+        }
+
+        return $days;
+    }
+
     /* =====================================================================
      * Sentinel values
      * ===================================================================== */
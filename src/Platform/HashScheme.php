@@ -0,0 +1,168 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Platform/HashScheme.php
+ * Purpose: Versioned hash scheme for identity/state hashes persisted in the
+ * manifest, with an opt-in fast scheme.
+ */
+
+namespace CalendarScheduler\Platform;
+
+/**
+ * HashScheme
+ *
+ * Every persisted hash (identityHash, subEvent/event stateHash, correlation
+ * map keys, tombstone and timestamp keys) is produced by the scheme recorded
+ * in the manifest's "hashScheme" field:
+ *
+ * - sha256-json: sha256 over json_encode output (default; the historical form)
+ * - xxh128-bin:  xxh128 over a compact, type-tagged binary serialization
+ *
+ * A run activates the scheme of the manifest it reads, so hashes it computes
+ * stay comparable with the stored ones. Switching schemes is a one-time
+ * migration (HashSchemeMigrator) that rewrites all stored hashes.
+ */
+final class HashScheme
+{
+    public const SHA256_JSON = 'sha256-json';
+    public const XXH128_BIN = 'xxh128-bin';
+    public const DEFAULT = self::SHA256_JSON;
+
+    private static string $active = self::DEFAULT;
+
+    /**
+     * @return array<int,string>
+     */
+    public static function known(): array
+    {
+        return [self::SHA256_JSON, self::XXH128_BIN];
+    }
+
+    public static function active(): string
+    {
+        return self::$active;
+    }
+
+    public static function activate(string $scheme): void
+    {
+        self::assertSupported($scheme);
+        self::$active = $scheme;
+    }
+
+    public static function assertSupported(string $scheme): void
+    {
+        if (!in_array($scheme, self::known(), true)) {
+            throw new \RuntimeException("Unknown hash scheme '{$scheme}'");
+        }
+        if ($scheme === self::XXH128_BIN && !in_array('xxh128', hash_algos(), true)) {
+            throw new \RuntimeException('Hash scheme xxh128-bin requires PHP hash support for xxh128');
+        }
+    }
+
+    /**
+     * Scheme a manifest document was written with (absent => default).
+     *
+     * @param array<string,mixed> $manifest
+     */
+    public static function fromManifest(array $manifest): string
+    {
+        $scheme = $manifest['hashScheme'] ?? null;
+        return is_string($scheme) && $scheme !== '' ? $scheme : self::DEFAULT;
+    }
+
+    public static function fromManifestFile(string $manifestPath): string
+    {
+        $raw = is_file($manifestPath) ? @file_get_contents($manifestPath) : false;
+        $manifest = is_string($raw) ? json_decode($raw, true) : null;
+        return self::fromManifest(is_array($manifest) ? $manifest : []);
+    }
+
+    /**
+     * Hash a structured value under the active scheme.
+     *
+     * $jsonFlags only affect the sha256-json scheme and must match the flags
+     * the call site historically hashed with.
+     */
+    public static function digest(mixed $value, int $jsonFlags = 0): string
+    {
+        return self::digestWith(self::$active, $value, $jsonFlags);
+    }
+
+    public static function digestWith(string $scheme, mixed $value, int $jsonFlags = 0): string
+    {
+        if ($scheme === self::XXH128_BIN) {
+            return hash('xxh128', self::encode($value));
+        }
+
+        return hash('sha256', json_encode($value, $jsonFlags | JSON_THROW_ON_ERROR));
+    }
+
+    /**
+     * Hash an already-serialized string (e.g. a joined list of hashes).
+     */
+    public static function digestString(string $value): string
+    {
+        return self::digestStringWith(self::$active, $value);
+    }
+
+    public static function digestStringWith(string $scheme, string $value): string
+    {
+        return hash($scheme === self::XXH128_BIN ? 'xxh128' : 'sha256', $value);
+    }
+
+    /**
+     * True when $value has the shape of a digest produced by any known scheme
+     * (64 hex for sha256, 32 hex for xxh128). Manifest hashes can surface
+     * where provider ids are expected, and must never be taken for one.
+     */
+    public static function isDigest(string $value): bool
+    {
+        $length = strlen($value);
+        return ($length === 64 || $length === 32) && ctype_xdigit($value);
+    }
+
+    /**
+     * Compact canonical binary form: one type tag per value, big-endian
+     * length/count prefixes, map keys as strings in insertion order (the same
+     * order sensitivity as the JSON form).
+     */
+    public static function encode(mixed $value): string
+    {
+        if ($value === null) {
+            return 'n';
+        }
+        if (is_bool($value)) {
+            return $value ? 't' : 'f';
+        }
+        if (is_int($value)) {
+            return 'i' . pack('J', $value);
+        }
+        if (is_float($value)) {
+            return 'd' . pack('E', $value);
+        }
+        if (is_string($value)) {
+            return 's' . pack('N', strlen($value)) . $value;
+        }
+        if (!is_array($value)) {
+            throw new \InvalidArgumentException('HashScheme: unsupported value type ' . get_debug_type($value));
+        }
+
+        if (array_is_list($value)) {
+            $out = 'l' . pack('N', count($value));
+            foreach ($value as $item) {
+                $out .= self::encode($item);
+            }
+            return $out;
+        }
+
+        $out = 'm' . pack('N', count($value));
+        foreach ($value as $key => $item) {
+            $key = (string)$key;
+            $out .= pack('N', strlen($key)) . $key . self::encode($item);
+        }
+        return $out;
+    }
+}
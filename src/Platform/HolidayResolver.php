@@ -32,9 +32,18 @@ use DateTimeImmutable;
  * - shortName is the ONLY canonical identifier
  * - Holiday definitions are provided externally (FPP environment)
  * - Resolution is best-effort and non-destructive
+ * - Years are built with integer day-number arithmetic into direct
+ *   [shortName][year] and [Y-m-d] indexes; lookups are O(1)
+ * - The built table can be exported/imported (see HolidayTableCache) and is
+ *   keyed by definitionHash()
  */
 final class HolidayResolver
 {
+    /**
+     * Bumped whenever resolution rules change so exported tables are rebuilt.
+     */
+    public const TABLE_VERSION = 2;
+
     /**
      * Indexed holiday definitions by shortName.
      *
@@ -49,6 +58,13 @@ final class HolidayResolver
      */
     private array $dateMap = [];
 
+    /**
+     * Resolved dates by shortName and definition year (null when unresolvable).
+     *
+     * @var array<string,array<int,string|null>>
+     */
+    private array $byNameYear = [];
+
     /**
      * Tracks which years have been built to avoid recomputation
      *
@@ -56,6 +72,8 @@ final class HolidayResolver
      */
     private array $builtYears = [];
 
+    private ?string $definitionHash = null;
+
     /**
      * @param array<int,array<string,mixed>> $holidays Raw FPP holiday definitions
      */
@@ -74,19 +92,6 @@ final class HolidayResolver
         }
     }
 
-    /**
-     * Ensure the given date is covered by the internal holiday map.
-     */
-    private function ensureDateCovered(DateTimeImmutable $date): void
-    {
-        $year = (int)$date->format('Y');
-
-        if (!isset($this->builtYears[$year])) {
-            $this->buildYear($year);
-            $this->builtYears[$year] = true;
-        }
-    }
-
     /**
      * Resolve a concrete date to a symbolic holiday name using exact match only.
      *
@@ -94,16 +99,24 @@ final class HolidayResolver
      * - Exact Y-m-d match only
      * - No heuristics or proximity logic
      *
-     * Does NOT auto-build ranges; caller must call ensureRange() first.
-     *
      * @param DateTimeImmutable $date
      * @return string|null Holiday shortName if exactly matched
      */
     public function holidayFromDate(DateTimeImmutable $date): ?string
     {
-        $this->ensureDateCovered($date);
+        return $this->holidayFromYmd($date->format('Y-m-d'));
+    }
+
+    /**
+     * String form of holidayFromDate() for callers that already hold Y-m-d.
+     */
+    public function holidayFromYmd(string $ymd): ?string
+    {
+        $year = (int)substr($ymd, 0, 4);
+        if (!isset($this->builtYears[$year])) {
+            $this->buildYear($year);
+        }
 
-        $ymd = $date->format('Y-m-d');
         return $this->dateMap[$ymd] ?? null;
     }
 
@@ -115,25 +128,25 @@ final class HolidayResolver
      * @return DateTimeImmutable|null Concrete date if resolvable
      */
     public function dateFromHoliday(string $symbolic, int $year): ?DateTimeImmutable
+    {
+        $ymd = $this->ymdFromHoliday($symbolic, $year);
+        return $ymd !== null ? new DateTimeImmutable($ymd) : null;
+    }
+
+    /**
+     * String form of dateFromHoliday() (Y-m-d).
+     */
+    public function ymdFromHoliday(string $symbolic, int $year): ?string
     {
         if (!isset($this->holidayIndex[$symbolic])) {
             return null;
         }
 
-        // Ensure the year is built so dateMap is populated
         if (!isset($this->builtYears[$year])) {
             $this->buildYear($year);
-            $this->builtYears[$year] = true;
-        }
-
-        // Walk dateMap to find matching holiday in this year
-        foreach ($this->dateMap as $ymd => $shortName) {
-            if ($shortName === $symbolic && str_starts_with($ymd, (string)$year)) {
-                return new DateTimeImmutable($ymd);
-            }
         }
 
-        return null;
+        return $this->byNameYear[$symbolic][$year] ?? null;
     }
 
     /**
@@ -147,6 +160,95 @@ final class HolidayResolver
         return isset($this->holidayIndex[$symbolic]);
     }
 
+    /**
+     * Build every year in [$fromYear, $toYear] up front.
+     */
+    public function precomputeYears(int $fromYear, int $toYear): void
+    {
+        for ($year = $fromYear; $year <= $toYear; $year++) {
+            if (!isset($this->builtYears[$year])) {
+                $this->buildYear($year);
+            }
+        }
+    }
+
+    /**
+     * Stable hash of the holiday definitions and resolution rules.
+     */
+    public function definitionHash(): string
+    {
+        return $this->definitionHash ??= sha1(
+            self::TABLE_VERSION . '|' . json_encode($this->holidayIndex, JSON_UNESCAPED_SLASHES)
+        );
+    }
+
+    /**
+     * Serializable form of every year built so far.
+     *
+     * @return array{version:int,hash:string,years:array<int,int>,byName:array<string,array<int,string|null>>,byDate:array<string,string>}
+     */
+    public function exportTable(): array
+    {
+        $years = array_keys($this->builtYears);
+        sort($years);
+
+        return [
+            'version' => self::TABLE_VERSION,
+            'hash' => $this->definitionHash(),
+            'years' => $years,
+            'byName' => $this->byNameYear,
+            'byDate' => $this->dateMap,
+        ];
+    }
+
+    /**
+     * Adopt a previously exported table. Returns false (and changes nothing)
+     * when it was built from different definitions or rules.
+     *
+     * @param array<string,mixed> $table
+     */
+    public function importTable(array $table): bool
+    {
+        if (
+            ($table['version'] ?? null) !== self::TABLE_VERSION
+            || ($table['hash'] ?? null) !== $this->definitionHash()
+            || !is_array($table['years'] ?? null)
+            || !is_array($table['byName'] ?? null)
+            || !is_array($table['byDate'] ?? null)
+        ) {
+            return false;
+        }
+
+        foreach ($table['years'] as $year) {
+            $this->builtYears[(int)$year] = true;
+        }
+        foreach ($table['byName'] as $shortName => $years) {
+            if (!is_array($years)) {
+                continue;
+            }
+            foreach ($years as $year => $ymd) {
+                $this->byNameYear[(string)$shortName][(int)$year] = is_string($ymd) ? $ymd : null;
+            }
+        }
+        foreach ($table['byDate'] as $ymd => $shortName) {
+            if (is_string($shortName)) {
+                $this->dateMap[(string)$ymd] = $shortName;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @return array<int,int>
+     */
+    public function builtYears(): array
+    {
+        $years = array_keys($this->builtYears);
+        sort($years);
+        return $years;
+    }
+
     /* ============================================================
      * Internal helpers
      * ============================================================ */
@@ -154,25 +256,38 @@ final class HolidayResolver
     private function buildYear(int $year): void
     {
         foreach ($this->holidayIndex as $shortName => $def) {
-            $resolved = $this->resolveDefinition($def, $year);
-            if ($resolved !== null) {
-                $ymd = $resolved->format('Y-m-d');
-                $this->dateMap[$ymd] = $shortName;
+            $dayNumber = $this->resolveDefinition($def, $year);
+            if ($dayNumber === null) {
+                $this->byNameYear[$shortName][$year] = null;
+                continue;
             }
+
+            [$y, $m, $d] = self::civilFromDays($dayNumber);
+            $ymd = sprintf('%04d-%02d-%02d', $y, $m, $d);
+            $this->byNameYear[$shortName][$year] = $ymd;
+            $this->dateMap[$ymd] = $shortName;
         }
+
+        $this->builtYears[$year] = true;
     }
 
-    private function resolveDefinition(array $def, int $year): ?DateTimeImmutable
+    /**
+     * Resolve one definition for a year to a day number (days since 1970-01-01).
+     */
+    private function resolveDefinition(array $def, int $year): ?int
     {
-        // Fixed-date holiday
+        // Fixed-date holiday (out-of-range days roll over, e.g. Feb 29 -> Mar 1)
         if (
             isset($def['month'], $def['day'])
             && (int)$def['month'] > 0
             && (int)$def['day'] > 0
         ) {
-            return new DateTimeImmutable(
-                sprintf('%04d-%02d-%02d', $year, (int)$def['month'], (int)$def['day'])
-            );
+            $month = (int)$def['month'];
+            $day = (int)$def['day'];
+            if ($month > 12 || $day > 31) {
+                return null;
+            }
+            return self::daysFromCivil($year, $month, $day);
         }
 
         // Calculated holiday
@@ -181,10 +296,7 @@ final class HolidayResolver
 
             // Easter-based holiday
             if (($calc['type'] ?? '') === 'easter') {
-                $base = $this->easterSunday($year);
-
-                $offset = (int)($calc['offset'] ?? 0);
-                return $base->modify(($offset >= 0 ? '+' : '') . $offset . ' days');
+                return $this->easterSunday($year) + (int)($calc['offset'] ?? 0);
             }
 
             // Weekday-based holiday (e.g. Thanksgiving)
@@ -194,65 +306,48 @@ final class HolidayResolver
                 return null;
             }
 
-            $month     = (int)$calc['month'];
-            $fppDow    = (int)$calc['dow'];   // 0=Sunday .. 6=Saturday
-            $week      = (int)$calc['week'];
-            $origMonth = $month;
-            $offset    = (int)($calc['offset'] ?? 0);
+            $month  = (int)$calc['month'];
+            $dow    = ((int)$calc['dow']) % 7;   // 0=Sunday .. 6=Saturday
+            $week   = (int)$calc['week'];
+            $offset = (int)($calc['offset'] ?? 0);
 
-            // Convert FPP weekday to ISO-8601 (1=Mon .. 7=Sun)
-            $isoDow = ($fppDow === 0) ? 7 : $fppDow;
+            if ($month < 1 || $month > 12 || $dow < 0) {
+                return null;
+            }
+            $daysInMonth = self::daysInMonth($year, $month);
 
             // Tail-based (e.g. last Thursday)
             if ($calc['type'] === 'tail') {
-                $d = new DateTimeImmutable(sprintf('%04d-%02d-01', $year, $month));
-                $d = $d->modify('last day of this month');
-
-                while ((int)$d->format('N') !== $isoDow) {
-                    $d = $d->modify('-1 day');
-                }
-
-                $d = $d->modify('-' . (($week - 1) * 7) . ' days');
-
-                $d = $d->modify(($offset >= 0 ? '+' : '') . $offset . ' days');
-
-                if ((int)$d->format('n') !== $origMonth) {
-                    return null;
-                }
+                $last = self::daysFromCivil($year, $month, $daysInMonth);
+                $back = (self::weekday($last) - $dow + 7) % 7;
+                $dayNumber = $last - $back - (($week - 1) * 7) + $offset;
 
-                return $d;
+                return self::civilFromDays($dayNumber)[1] === $month ? $dayNumber : null;
             }
 
             // Head-based (e.g. 4th Thursday)
             if ($calc['type'] === 'head') {
-                $first = new DateTimeImmutable(sprintf('%04d-%02d-01', $year, $month));
-                $firstDow = (int)$first->format('N');
-
-                $delta = ($isoDow - $firstDow + 7) % 7;
+                $first = self::daysFromCivil($year, $month, 1);
+                $delta = ($dow - self::weekday($first) + 7) % 7;
                 $day   = 1 + $delta + (($week - 1) * 7);
 
-                if ($day < 1 || $day > (int)$first->format('t')) {
+                if ($day < 1 || $day > $daysInMonth) {
                     return null;
                 }
 
-                $d = new DateTimeImmutable(
-                    sprintf('%04d-%02d-%02d', $year, $month, $day)
-                );
-
-                $d = $d->modify(($offset >= 0 ? '+' : '') . $offset . ' days');
-
-                if ((int)$d->format('n') !== $origMonth) {
-                    return null;
-                }
+                $dayNumber = $first + $day - 1 + $offset;
 
-                return $d;
+                return self::civilFromDays($dayNumber)[1] === $month ? $dayNumber : null;
             }
         }
 
         return null;
     }
 
-    private function easterSunday(int $year): DateTimeImmutable
+    /**
+     * Easter Sunday as a day number.
+     */
+    private function easterSunday(int $year): int
     {
         // Meeus/Jones/Butcher Gregorian algorithm
         $a = $year % 19;
@@ -270,6 +365,58 @@ final class HolidayResolver
         $month = intdiv($h + $l - 7 * $m + 114, 31);
         $day = (($h + $l - 7 * $m + 114) % 31) + 1;
 
-        return new DateTimeImmutable(sprintf('%04d-%02d-%02d 00:00:00', $year, $month, $day));
+        return self::daysFromCivil($year, $month, $day);
+    }
+
+    /**
+     * Proleptic Gregorian date -> days since 1970-01-01 (Hinnant's algorithm).
+     * Linear in $day, so out-of-range days roll into the next month.
+     */
+    private static function daysFromCivil(int $year, int $month, int $day): int
+    {
+        $year -= $month <= 2 ? 1 : 0;
+        $era = intdiv($year >= 0 ? $year : $year - 399, 400);
+        $yoe = $year - $era * 400;
+        $doy = intdiv(153 * ($month + ($month > 2 ? -3 : 9)) + 2, 5) + $day - 1;
+        $doe = $yoe * 365 + intdiv($yoe, 4) - intdiv($yoe, 100) + $doy;
+
+        return $era * 146097 + $doe - 719468;
+    }
+
+    /**
+     * Days since 1970-01-01 -> [year, month, day].
+     *
+     * @return array{0:int,1:int,2:int}
+     */
+    private static function civilFromDays(int $days): array
+    {
+        $days += 719468;
+        $era = intdiv($days >= 0 ? $days : $days - 146096, 146097);
+        $doe = $days - $era * 146097;
+        $yoe = intdiv($doe - intdiv($doe, 1460) + intdiv($doe, 36524) - intdiv($doe, 146096), 365);
+        $doy = $doe - (365 * $yoe + intdiv($yoe, 4) - intdiv($yoe, 100));
+        $mp = intdiv(5 * $doy + 2, 153);
+        $day = $doy - intdiv(153 * $mp + 2, 5) + 1;
+        $month = $mp < 10 ? $mp + 3 : $mp - 9;
+
+        return [$yoe + $era * 400 + ($month <= 2 ? 1 : 0), $month, $day];
+    }
+
+    /**
+     * 0=Sunday .. 6=Saturday (1970-01-01 was a Thursday).
+     */
+    private static function weekday(int $days): int
+    {
+        return (($days % 7) + 11) % 7;
+    }
+
+    private static function daysInMonth(int $year, int $month): int
+    {
+        if ($month === 2) {
+            $leap = ($year % 4 === 0 && $year % 100 !== 0) || $year % 400 === 0;
+            return $leap ? 29 : 28;
+        }
+
+        return in_array($month, [4, 6, 9, 11], true) ? 30 : 31;
     }
 }
@@ -0,0 +1,108 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Platform/HolidayTableCache.php
+ * Purpose: Disk-backed cache of precomputed HolidayResolver tables keyed by
+ * the FPP locale holiday definition hash.
+ */
+
+namespace CalendarScheduler\Platform;
+
+/**
+ * HolidayTableCache
+ *
+ * Owns the I/O that HolidayResolver deliberately avoids:
+ * - Builds a resolver precomputed over the sync horizon years
+ * - Reuses runtime/holiday-table.json when its definition hash matches
+ * - Rewrites the file only when definitions change or coverage grows
+ * - Shares one resolver per definition hash within a process
+ *
+ * Cache failures are non-fatal; the resolver is still fully usable.
+ */
+final class HolidayTableCache
+{
+    public const DEFAULT_PATH = '/home/fpp/media/config/calendar-scheduler/runtime/holiday-table.json';
+
+    // Default horizon is 30 days back / 2 years forward; one extra year each
+    // side covers cross-year symbolic range adjustments in the mappers.
+    public const YEARS_BACK = 1;
+    public const YEARS_FORWARD = 3;
+
+    /** @var array<string,HolidayResolver> */
+    private static array $resolvers = [];
+
+    public function __construct(
+        private readonly string $path = self::DEFAULT_PATH
+    ) {}
+
+    /**
+     * @param array<int,array<string,mixed>> $holidays Raw FPP holiday definitions
+     */
+    public function resolver(array $holidays, ?int $fromYear = null, ?int $toYear = null): HolidayResolver
+    {
+        $currentYear = (int)gmdate('Y');
+        $fromYear ??= $currentYear - self::YEARS_BACK;
+        $toYear ??= $currentYear + self::YEARS_FORWARD;
+
+        $resolver = new HolidayResolver($holidays);
+        $memoKey = $this->path . '|' . $resolver->definitionHash();
+        if (isset(self::$resolvers[$memoKey])) {
+            $resolver = self::$resolvers[$memoKey];
+            $resolver->precomputeYears($fromYear, $toYear);
+            return $resolver;
+        }
+
+        $table = $this->read();
+        $imported = is_array($table) && $resolver->importTable($table);
+        $coveredBefore = $resolver->builtYears();
+
+        $resolver->precomputeYears($fromYear, $toYear);
+        if (!$imported || $resolver->builtYears() !== $coveredBefore) {
+            $this->write($resolver->exportTable());
+        }
+
+        return self::$resolvers[$memoKey] = $resolver;
+    }
+
+    /**
+     * @return array<string,mixed>|null
+     */
+    private function read(): ?array
+    {
+        if (!is_file($this->path)) {
+            return null;
+        }
+
+        $raw = @file_get_contents($this->path);
+        if (!is_string($raw) || $raw === '') {
+            return null;
+        }
+
+        $decoded = json_decode($raw, true);
+        return is_array($decoded) ? $decoded : null;
+    }
+
+    /**
+     * @param array<string,mixed> $table
+     */
+    private function write(array $table): void
+    {
+        $json = json_encode($table, JSON_UNESCAPED_SLASHES);
+        if (!is_string($json)) {
+            return;
+        }
+
+        $dir = dirname($this->path);
+        if (!is_dir($dir) && !@mkdir($dir, 0775, true) && !is_dir($dir)) {
+            return;
+        }
+
+        $tmp = $this->path . '.' . getmypid() . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $this->path)) {
+            @unlink($tmp);
+        }
+    }
+}
@@ -0,0 +1,267 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Platform/ProcessPool.php
+ * Purpose: Run independent tasks in forked worker processes (CLI with pcntl)
+ * and collect their results, falling back to in-process execution.
+ */
+
+namespace CalendarScheduler\Platform;
+
+/**
+ * ProcessPool
+ *
+ * Each task runs in its own forked child; its return value (or error) comes
+ * back to the parent serialized through a temp file, so tasks must return
+ * serializable values. At most $maxWorkers children run at once.
+ *
+ * Failure semantics:
+ * - forked: every task runs to completion (tasks are independent), then the
+ *   first failure in task order is rethrown
+ * - in-process fallback (no pcntl, a web SAPI, or a single task): tasks run
+ *   in order and the first failure is thrown immediately
+ * - settle() never throws for a task: every task runs and each one reports
+ *   its result or error, including a worker that died (fatal error, signal)
+ *
+ * $onTick runs in the parent while children are working (and after each
+ * in-process task), e.g. to pump other non-blocking work or report progress.
+ *
+ * A child ends without running shutdown code once its result is written, so
+ * it never closes connections or files inherited from the parent.
+ *
+ * With Trace enabled, a child's spans travel back with its result and are
+ * merged into the parent's trace (see Trace::adopt()).
+ */
+final class ProcessPool
+{
+    private const POLL_MICROSECONDS = 20000;
+
+    public function __construct(
+        private readonly int $maxWorkers = 4
+    ) {}
+
+    public static function supported(): bool
+    {
+        return PHP_SAPI === 'cli'
+            && function_exists('pcntl_fork')
+            && function_exists('pcntl_waitpid');
+    }
+
+    /**
+     * Online CPU count (Linux /proc/cpuinfo); 1 when it cannot be read.
+     */
+    public static function cpuCount(): int
+    {
+        static $count = null;
+        if ($count === null) {
+            $info = is_readable('/proc/cpuinfo') ? @file_get_contents('/proc/cpuinfo') : false;
+            $count = is_string($info) ? max(1, preg_match_all('/^processor\s*:/m', $info)) : 1;
+        }
+
+        return $count;
+    }
+
+    /**
+     * @template T
+     * @param array<string,callable():T> $tasks
+     * @param (callable(array<string,T>):void)|null $onTick receives the results finished so far
+     * @return array<string,T> results keyed like $tasks
+     */
+    public function run(array $tasks, ?callable $onTick = null): array
+    {
+        if ($tasks === []) {
+            return [];
+        }
+        if (!$this->forks($tasks)) {
+            return $this->runInProcess($tasks, $onTick);
+        }
+
+        $results = [];
+        foreach ($this->runForked($tasks, $onTick) as $key => $outcome) {
+            if (!$outcome['ok']) {
+                throw new \RuntimeException($outcome['error']);
+            }
+            $results[$key] = $outcome['result'];
+        }
+
+        return $results;
+    }
+
+    /**
+     * Run every task and report each one's outcome instead of throwing.
+     *
+     * @template T
+     * @param array<string,callable():T> $tasks
+     * @param (callable(array<string,T>):void)|null $onTick receives the results finished so far
+     * @return array<string,array{ok:bool,result?:T,error?:string}> outcomes keyed like $tasks
+     */
+    public function settle(array $tasks, ?callable $onTick = null): array
+    {
+        if ($tasks === []) {
+            return [];
+        }
+        if ($this->forks($tasks)) {
+            return $this->runForked($tasks, $onTick);
+        }
+
+        $outcomes = [];
+        $results = [];
+        foreach ($tasks as $key => $task) {
+            try {
+                $results[$key] = $task();
+                $outcomes[$key] = ['ok' => true, 'result' => $results[$key]];
+            } catch (\Throwable $e) {
+                $outcomes[$key] = ['ok' => false, 'error' => $e->getMessage()];
+            }
+            if ($onTick !== null) {
+                $onTick($results);
+            }
+        }
+
+        return $outcomes;
+    }
+
+    /**
+     * @param array<string,callable> $tasks
+     */
+    private function forks(array $tasks): bool
+    {
+        return count($tasks) > 1 && $this->maxWorkers >= 2 && self::supported();
+    }
+
+    /**
+     * @param array<string,callable> $tasks
+     * @return array<string,mixed>
+     */
+    private function runInProcess(array $tasks, ?callable $onTick): array
+    {
+        $results = [];
+        foreach ($tasks as $key => $task) {
+            $results[$key] = $task();
+            if ($onTick !== null) {
+                $onTick($results);
+            }
+        }
+
+        return $results;
+    }
+
+    /**
+     * @param array<string,callable> $tasks
+     * @return array<string,array{ok:bool,result?:mixed,error?:string}> outcomes in task order
+     */
+    private function runForked(array $tasks, ?callable $onTick): array
+    {
+        $queue = $tasks;
+        /** @var array<int,array{key:string,path:string}> $running pid => task */
+        $running = [];
+        $outcomes = [];
+        $results = [];
+
+        try {
+            while ($queue !== [] || $running !== []) {
+                while ($queue !== [] && count($running) < $this->maxWorkers) {
+                    $key = (string)array_key_first($queue);
+                    $task = $queue[$key];
+                    unset($queue[$key]);
+                    $path = tempnam(sys_get_temp_dir(), 'cs-pool-');
+                    if ($path === false) {
+                        throw new \RuntimeException('ProcessPool: unable to create a result file');
+                    }
+                    $pid = pcntl_fork();
+                    if ($pid === -1) {
+                        @unlink($path);
+                        throw new \RuntimeException('ProcessPool: fork failed');
+                    }
+                    if ($pid === 0) {
+                        self::runChild($task, $path);
+                    }
+                    $running[$pid] = ['key' => $key, 'path' => $path];
+                }
+
+                $reaped = false;
+                foreach ($running as $pid => $slot) {
+                    if (pcntl_waitpid($pid, $status, WNOHANG) === 0) {
+                        continue;
+                    }
+                    unset($running[$pid]);
+                    $reaped = true;
+                    $outcome = self::readOutcome($slot['path'], $status);
+                    $outcomes[$slot['key']] = $outcome;
+                    if ($outcome['ok']) {
+                        $results[$slot['key']] = $outcome['result'];
+                    }
+                }
+
+                if ($onTick !== null) {
+                    $onTick($results);
+                }
+                if (!$reaped && $running !== []) {
+                    usleep(self::POLL_MICROSECONDS);
+                }
+            }
+        } finally {
+            // Only reached with children left when the parent itself failed.
+            foreach ($running as $pid => $slot) {
+                pcntl_waitpid($pid, $status);
+                @unlink($slot['path']);
+            }
+        }
+
+        $ordered = [];
+        foreach (array_keys($tasks) as $key) {
+            $ordered[$key] = $outcomes[$key];
+        }
+
+        return $ordered;
+    }
+
+    /**
+     * Child side: never returns.
+     */
+    private static function runChild(callable $task, string $path): never
+    {
+        // The parent owns the trace; a child only returns its own spans.
+        Trace::startChild();
+        try {
+            $outcome = ['ok' => true, 'result' => $task()];
+        } catch (\Throwable $e) {
+            $outcome = ['ok' => false, 'error' => $e->getMessage()];
+        }
+        $outcome['trace'] = Trace::takeChildEvents();
+
+        try {
+            $payload = serialize($outcome);
+        } catch (\Throwable $e) {
+            $payload = serialize(['ok' => false, 'error' => 'ProcessPool: task result is not serializable: ' . $e->getMessage()]);
+        }
+        $written = @file_put_contents($path, $payload);
+        if ($written !== false && function_exists('posix_kill')) {
+            // Skip shutdown: destructors and curl cleanup here would act on
+            // connections and files the parent still owns (in-flight requests).
+            posix_kill(getmypid(), SIGKILL);
+        }
+        exit($written === false ? 1 : 0);
+    }
+
+    /**
+     * @return array{ok:bool,result?:mixed,error?:string}
+     */
+    private static function readOutcome(string $path, int $status): array
+    {
+        $raw = @file_get_contents($path);
+        @unlink($path);
+        $outcome = is_string($raw) && $raw !== '' ? @unserialize($raw) : false;
+        if (is_array($outcome) && is_bool($outcome['ok'] ?? null)) {
+            Trace::adopt(is_array($outcome['trace'] ?? null) ? $outcome['trace'] : []);
+            unset($outcome['trace']);
+            return $outcome;
+        }
+
+        $exit = pcntl_wifexited($status) ? 'exit ' . pcntl_wexitstatus($status) : 'signal ' . pcntl_wtermsig($status);
+        return ['ok' => false, 'error' => "ProcessPool: worker ended without a result ({$exit})"];
+    }
+}
@@ -75,6 +75,42 @@ final class SunTimeDisplayEstimator
             return null;
         }
 
+        $day = self::computeDay($ymd, $latitude, $longitude, $timezone);
+        if ($day === null) {
+            return null;
+        }
+
+        $baseSeconds = match ($symbolicTime) {
+            'Dawn'    => $day[0],
+            'SunRise' => $day[1],
+            'SunSet'  => $day[2],
+            'Dusk'    => $day[3],
+            default   => null,
+        };
+
+        if ($baseSeconds === null) {
+            return null;
+        }
+
+        return self::formatDisplayTime($baseSeconds, $offsetMinutes, $roundMinutes);
+    }
+
+    /**
+     * Unrounded local sun times for one day, used to build SunTimeTable rows.
+     *
+     * @return array{0:int,1:int,2:int,3:int}|null
+     *   dawn, sunrise, sunset, dusk (seconds since local midnight)
+     */
+    public static function computeDay(
+        string $ymd,
+        float $latitude,
+        float $longitude,
+        string $timezone = 'UTC'
+    ): ?array {
+        if (!preg_match('/^\d{4}-\d{2}-\d{2}$/', $ymd)) {
+            return null;
+        }
+
         try {
             $tz = new \DateTimeZone($timezone);
         } catch (\Throwable) {
@@ -93,21 +129,17 @@ final class SunTimeDisplayEstimator
         [$sunrise, $sunset, $dawn, $dusk] =
             self::calculateSunTimes($dayOfYear, $latitude, $longitude, $tzOffsetSeconds);
 
-        $baseSeconds = match ($symbolicTime) {
-            'SunRise' => $sunrise,
-            'SunSet'  => $sunset,
-            'Dawn'    => $dawn,
-            'Dusk'    => $dusk,
-            default   => null,
-        };
-
-        if ($baseSeconds === null) {
-            return null;
-        }
-
-        $seconds = $baseSeconds + ($offsetMinutes * 60);
+        return [$dawn, $sunrise, $sunset, $dusk];
+    }
 
-        return self::roundSeconds($seconds, $roundMinutes);
+    /**
+     * Apply an FPP-style offset to a base time and round it for display.
+     *
+     * @return string HH:MM:SS
+     */
+    public static function formatDisplayTime(int $baseSeconds, int $offsetMinutes = 0, int $roundMinutes = 30): string
+    {
+        return self::roundSeconds($baseSeconds + ($offsetMinutes * 60), $roundMinutes);
     }
 
     /* ======================================================================
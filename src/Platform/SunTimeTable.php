@@ -0,0 +1,209 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Platform/SunTimeTable.php
+ * Purpose: Per-location, per-timezone table of display sun times for the
+ * sync horizon, persisted so symbolic-time display becomes a lookup.
+ */
+
+namespace CalendarScheduler\Platform;
+
+/**
+ * SunTimeTable
+ *
+ * Rows hold unrounded dawn/sunrise/sunset/dusk seconds since local midnight
+ * from SunTimeDisplayEstimator::computeDay(). Offsets and rounding are
+ * applied per lookup, so one table serves every offset/granularity.
+ *
+ * - Built once per (latitude, longitude, timezone) and shared in-process by
+ *   scheduler ordering and the provider mappers
+ * - Persisted to runtime/sun-time-table.json, one entry per location and
+ *   timezone (at most MAX_ENTRIES, most recently built first)
+ * - A stored entry that no longer covers the horizon is extended by the
+ *   missing days only, EXTEND_DAYS at a time, and trimmed of days that fell
+ *   out of it; a new day costs a lookup, not a rebuild
+ * - Days outside the stored range are computed on demand (memory only)
+ *
+ * Display-only, like the estimator: never used for execution or identity.
+ */
+final class SunTimeTable
+{
+    public const DEFAULT_PATH = '/home/fpp/media/config/calendar-scheduler/runtime/sun-time-table.json';
+
+    // Default sync horizon (30 days back / 2 years forward) plus a day of slack.
+    public const DAYS_BACK = 31;
+    public const DAYS_FORWARD = 731;
+
+    // Days computed past the horizon when an entry is extended, so the file
+    // is rewritten about once a month rather than every day.
+    public const EXTEND_DAYS = 30;
+    public const MAX_ENTRIES = 4;
+
+    private const VERSION = 2;
+    private const SYMBOLIC_INDEX = [
+        'Dawn' => 0,
+        'SunRise' => 1,
+        'SunSet' => 2,
+        'Dusk' => 3,
+    ];
+
+    /** @var array<string,self> */
+    private static array $tables = [];
+
+    /**
+     * @param array<string,array{0:int,1:int,2:int,3:int}|null> $days Y-m-d => row
+     */
+    private function __construct(
+        private readonly float $latitude,
+        private readonly float $longitude,
+        private readonly string $timezone,
+        private array $days
+    ) {}
+
+    /**
+     * Shared table for a location and timezone; loads or builds the horizon rows.
+     */
+    public static function for(
+        float $latitude,
+        float $longitude,
+        string $timezone,
+        string $path = self::DEFAULT_PATH
+    ): self {
+        try {
+            $tz = new \DateTimeZone($timezone);
+        } catch (\Throwable) {
+            $tz = new \DateTimeZone('UTC');
+        }
+        $timezone = $tz->getName();
+
+        $key = sprintf('%.6F|%.6F|%s', $latitude, $longitude, $timezone);
+        if (isset(self::$tables[$path . '|' . $key])) {
+            return self::$tables[$path . '|' . $key];
+        }
+
+        $today = new \DateTimeImmutable('today', $tz);
+        $from = $today->modify('-' . self::DAYS_BACK . ' days')->format('Y-m-d');
+        $to = $today->modify('+' . self::DAYS_FORWARD . ' days')->format('Y-m-d');
+
+        $stored = self::read($path);
+        $entries = is_array($stored) && ($stored['version'] ?? null) === self::VERSION && is_array($stored['entries'] ?? null)
+            ? $stored['entries']
+            : [];
+        $entry = $entries[$key] ?? null;
+        $days = is_array($entry)
+            && is_string($entry['from'] ?? null) && is_string($entry['to'] ?? null)
+            && is_array($entry['days'] ?? null)
+            && $entry['to'] >= $entry['from']
+            ? $entry['days']
+            : [];
+
+        $table = new self($latitude, $longitude, $timezone, $days);
+        if ($days !== [] && $entry['from'] <= $from && $entry['to'] >= $to) {
+            return self::$tables[$path . '|' . $key] = $table;
+        }
+
+        // Keep what is still inside the horizon and compute only the rest.
+        $storedFrom = $days !== [] ? (string)$entry['from'] : null;
+        $storedTo = $days !== [] ? (string)$entry['to'] : null;
+        $to = $today->modify('+' . (self::DAYS_FORWARD + self::EXTEND_DAYS) . ' days')->format('Y-m-d');
+        $table->days = [];
+        for ($day = new \DateTimeImmutable($from); $day->format('Y-m-d') <= $to; $day = $day->modify('+1 day')) {
+            $ymd = $day->format('Y-m-d');
+            $table->days[$ymd] = $storedFrom !== null && $ymd >= $storedFrom && $ymd <= $storedTo && array_key_exists($ymd, $days)
+                ? $days[$ymd]
+                : SunTimeDisplayEstimator::computeDay($ymd, $latitude, $longitude, $timezone);
+        }
+
+        unset($entries[$key]);
+        $entries = [$key => ['from' => $from, 'to' => $to, 'days' => $table->days]]
+            + array_slice($entries, 0, self::MAX_ENTRIES - 1, true);
+        self::write($path, [
+            'version' => self::VERSION,
+            'entries' => $entries,
+        ]);
+
+        return self::$tables[$path . '|' . $key] = $table;
+    }
+
+    /**
+     * Unrounded base seconds since local midnight, or null when not computable.
+     */
+    public function baseSeconds(string $ymd, string $symbolic): ?int
+    {
+        $index = self::SYMBOLIC_INDEX[$symbolic] ?? null;
+        if ($index === null) {
+            return null;
+        }
+
+        if (!array_key_exists($ymd, $this->days)) {
+            $this->days[$ymd] = SunTimeDisplayEstimator::computeDay(
+                $ymd,
+                $this->latitude,
+                $this->longitude,
+                $this->timezone
+            );
+        }
+
+        $row = $this->days[$ymd];
+        return is_array($row) && isset($row[$index]) ? (int)$row[$index] : null;
+    }
+
+    /**
+     * Table-backed equivalent of SunTimeDisplayEstimator::estimate().
+     *
+     * @return string|null HH:MM:SS
+     */
+    public function displayTime(string $ymd, string $symbolic, int $offsetMinutes = 0, int $roundMinutes = 30): ?string
+    {
+        $base = $this->baseSeconds($ymd, $symbolic);
+        if ($base === null) {
+            return null;
+        }
+
+        return SunTimeDisplayEstimator::formatDisplayTime($base, $offsetMinutes, $roundMinutes);
+    }
+
+    /**
+     * @return array<string,mixed>|null
+     */
+    private static function read(string $path): ?array
+    {
+        if (!is_file($path)) {
+            return null;
+        }
+
+        $raw = @file_get_contents($path);
+        if (!is_string($raw) || $raw === '') {
+            return null;
+        }
+
+        $decoded = json_decode($raw, true);
+        return is_array($decoded) ? $decoded : null;
+    }
+
+    /**
+     * Best-effort atomic write; a failed write only costs a rebuild next run.
+     *
+     * @param array<string,mixed> $doc
+     */
+    private static function write(string $path, array $doc): void
+    {
+        $json = json_encode($doc, JSON_UNESCAPED_SLASHES);
+        if (!is_string($json)) {
+            return;
+        }
+
+        $dir = dirname($path);
+        if (!is_dir($dir) && !@mkdir($dir, 0775, true) && !is_dir($dir)) {
+            return;
+        }
+
+        $tmp = $path . '.' . getmypid() . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $path)) {
+            @unlink($tmp);
+        }
+    }
+}
@@ -0,0 +1,314 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Platform/Trace.php
+ * Purpose: Opt-in span recorder for a full scheduler run, written as Chrome
+ * Trace Event JSON (loads in chrome://tracing, Perfetto and speedscope).
+ */
+
+namespace CalendarScheduler\Platform;
+
+/**
+ * Trace
+ *
+ * Process-wide and disabled by default; every call is a no-op until
+ * enable(). Spans nest by call order (begin/end pairs become "B"/"E"
+ * events on the main lane), so a span opened inside another shows as its
+ * child. HTTP calls are recorded from curl_getinfo after the transfer
+ * as one "X" span with dns/connect/tls/wait/transfer children.
+ *
+ * Work that overlaps the main lane without nesting in it (the curl_multi
+ * FPP commit) is recorded on the background lane.
+ *
+ * Timestamps are microseconds since enable(), from the monotonic clock.
+ *
+ * A forked worker (ProcessPool) records its own spans from startChild() and
+ * hands them back with its result; the parent adopt()s them under the
+ * worker's pid, so viewers show each worker as its own process.
+ */
+final class Trace
+{
+    public const MAIN_LANE = 1;
+    public const BACKGROUND_LANE = 2;
+
+    private static bool $enabled = false;
+    private static int $originNs = 0;
+
+    /** @var array<int,array<string,mixed>> */
+    private static array $events = [];
+
+    /** @var array<int,array{name:string,cat:string}> */
+    private static array $open = [];
+
+    public static function enable(): void
+    {
+        self::$enabled = true;
+        self::$originNs = hrtime(true);
+        self::$events = [];
+        self::$open = [];
+    }
+
+    public static function disable(): void
+    {
+        self::$enabled = false;
+        self::$events = [];
+        self::$open = [];
+    }
+
+    public static function enabled(): bool
+    {
+        return self::$enabled;
+    }
+
+    /**
+     * Microseconds since enable() (0 when disabled).
+     */
+    public static function now(): int
+    {
+        return self::$enabled ? intdiv(hrtime(true) - self::$originNs, 1000) : 0;
+    }
+
+    /**
+     * @param array<string,mixed> $args
+     */
+    public static function begin(string $name, string $cat, array $args = []): void
+    {
+        if (!self::$enabled) {
+            return;
+        }
+        self::$open[] = ['name' => $name, 'cat' => $cat];
+        self::record(['name' => $name, 'cat' => $cat, 'ph' => 'B', 'ts' => self::now()], $args);
+    }
+
+    /**
+     * Close the innermost open span; $args are merged into it by viewers.
+     *
+     * @param array<string,mixed> $args
+     */
+    public static function end(array $args = []): void
+    {
+        if (!self::$enabled || self::$open === []) {
+            return;
+        }
+        $span = array_pop(self::$open);
+        self::record(['name' => $span['name'], 'cat' => $span['cat'], 'ph' => 'E', 'ts' => self::now()], $args);
+    }
+
+    /**
+     * Record an already-measured span.
+     *
+     * @param array<string,mixed> $args
+     */
+    public static function complete(
+        string $name,
+        string $cat,
+        int $startUs,
+        int $durationUs,
+        array $args = [],
+        int $lane = self::MAIN_LANE
+    ): void {
+        if (!self::$enabled) {
+            return;
+        }
+        self::record([
+            'name' => $name,
+            'cat' => $cat,
+            'ph' => 'X',
+            'ts' => $startUs,
+            'dur' => max(0, $durationUs),
+        ], $args, $lane);
+    }
+
+    /**
+     * Record a finished curl transfer that started at $startUs (Trace::now()),
+     * broken down by the curl_getinfo phase timers.
+     *
+     * @param \CurlHandle $ch
+     * @param array<string,mixed> $args
+     */
+    public static function http(
+        \CurlHandle $ch,
+        string $label,
+        int $startUs,
+        array $args = [],
+        int $lane = self::MAIN_LANE
+    ): void {
+        if (!self::$enabled) {
+            return;
+        }
+
+        $info = curl_getinfo($ch);
+        $totalUs = self::infoUs($info, 'total_time');
+        $endUs = self::now();
+        // curl's clock starts when the handle is performed, which may be later
+        // than $startUs for multi handles; anchor the breakdown at the end.
+        $baseUs = max($startUs, $endUs - $totalUs);
+
+        self::complete($label, 'http', $startUs, $endUs - $startUs, $args + [
+            'method' => self::methodOf($info, $args),
+            'url' => self::redactUrl((string)($info['url'] ?? '')),
+            'status' => (int)($info['http_code'] ?? 0),
+            'bytesDown' => (int)($info['size_download'] ?? 0),
+            'bytesUp' => (int)($info['size_upload'] ?? 0),
+            'reusedConnection' => ((int)($info['num_connects'] ?? 0)) === 0,
+        ], $lane);
+
+        // Cumulative curl timers => consecutive phases.
+        $marks = [
+            'dns' => self::infoUs($info, 'namelookup_time'),
+            'connect' => self::infoUs($info, 'connect_time'),
+            'tls' => self::infoUs($info, 'appconnect_time'),
+            'wait' => self::infoUs($info, 'starttransfer_time'),
+            'transfer' => $totalUs,
+        ];
+        if ($marks['tls'] === 0) {
+            $marks['tls'] = $marks['connect'];
+        }
+        $previous = self::infoUs($info, 'redirect_time');
+        foreach ($marks as $phase => $at) {
+            if ($at > $previous) {
+                self::complete($phase, 'http', $baseUs + $previous, $at - $previous, [], $lane);
+                $previous = $at;
+            }
+        }
+    }
+
+    /**
+     * Write the trace, closing any span still open.
+     */
+    public static function write(string $path): void
+    {
+        if (!self::$enabled) {
+            return;
+        }
+        while (self::$open !== []) {
+            self::end(['unclosed' => true]);
+        }
+
+        $dir = dirname($path);
+        if (!is_dir($dir) && !@mkdir($dir, 0775, true) && !is_dir($dir)) {
+            throw new \RuntimeException("Trace: unable to create {$dir}");
+        }
+
+        $pid = getmypid();
+        $doc = [
+            'traceEvents' => array_merge([
+                ['name' => 'process_name', 'ph' => 'M', 'pid' => $pid, 'tid' => self::MAIN_LANE, 'args' => ['name' => 'calendar-scheduler']],
+                ['name' => 'thread_name', 'ph' => 'M', 'pid' => $pid, 'tid' => self::MAIN_LANE, 'args' => ['name' => 'run']],
+                ['name' => 'thread_name', 'ph' => 'M', 'pid' => $pid, 'tid' => self::BACKGROUND_LANE, 'args' => ['name' => 'fpp commit']],
+            ], self::$events),
+            'displayTimeUnit' => 'ms',
+            'otherData' => ['startedAt' => gmdate(DATE_ATOM, time() - intdiv(self::now(), 1000000))],
+        ];
+        $json = json_encode($doc, JSON_UNESCAPED_SLASHES | JSON_INVALID_UTF8_SUBSTITUTE | JSON_THROW_ON_ERROR);
+        $tmp = $path . '.tmp';
+        if (@file_put_contents($tmp, $json . PHP_EOL) === false || !@rename($tmp, $path)) {
+            @unlink($tmp);
+            throw new \RuntimeException("Trace: unable to write {$path}");
+        }
+    }
+
+    /**
+     * In a forked worker: keep recording against the parent's origin, but
+     * only the worker's own spans.
+     */
+    public static function startChild(): void
+    {
+        if (!self::$enabled) {
+            return;
+        }
+        self::$events = [];
+        self::$open = [];
+    }
+
+    /**
+     * In a forked worker: the spans recorded since startChild(), any still
+     * open closed; recording stops, so the worker never writes the trace.
+     *
+     * @return array<int,array<string,mixed>>
+     */
+    public static function takeChildEvents(): array
+    {
+        if (!self::$enabled) {
+            return [];
+        }
+        while (self::$open !== []) {
+            self::end(['unclosed' => true]);
+        }
+        $events = self::$events;
+        self::disable();
+
+        return $events;
+    }
+
+    /**
+     * Merge spans a forked worker returned from takeChildEvents().
+     *
+     * @param array<int,array<string,mixed>> $events
+     */
+    public static function adopt(array $events): void
+    {
+        if (!self::$enabled || $events === []) {
+            return;
+        }
+        $pid = $events[0]['pid'] ?? null;
+        if (is_int($pid)) {
+            self::$events[] = ['name' => 'process_name', 'ph' => 'M', 'pid' => $pid, 'tid' => self::MAIN_LANE, 'args' => ['name' => 'worker']];
+        }
+        array_push(self::$events, ...$events);
+    }
+
+    /**
+     * @return array<int,array<string,mixed>>
+     */
+    public static function events(): array
+    {
+        return self::$events;
+    }
+
+    /**
+     * @param array<string,mixed> $event
+     * @param array<string,mixed> $args
+     */
+    private static function record(array $event, array $args, int $lane = self::MAIN_LANE): void
+    {
+        $event['pid'] = getmypid();
+        $event['tid'] = $lane;
+        if ($args !== []) {
+            $event['args'] = $args;
+        }
+        self::$events[] = $event;
+    }
+
+    /**
+     * @param array<string,mixed> $info
+     */
+    private static function infoUs(array $info, string $key): int
+    {
+        return (int)round(((float)($info[$key] ?? 0)) * 1000000);
+    }
+
+    /**
+     * @param array<string,mixed> $info
+     * @param array<string,mixed> $args
+     */
+    private static function methodOf(array $info, array $args): string
+    {
+        if (isset($args['method']) && is_string($args['method'])) {
+            return $args['method'];
+        }
+        return ((int)($info['size_upload'] ?? 0)) > 0 ? 'POST' : 'GET';
+    }
+
+    /**
+     * Drop query strings (tokens, page tokens) from recorded URLs.
+     */
+    private static function redactUrl(string $url): string
+    {
+        $q = strpos($url, '?');
+        return $q === false ? $url : substr($url, 0, $q);
+    }
+}
@@ -0,0 +1,151 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Resolution/Dto/CompactTiming.php
+ * Purpose: Integer timing representation shared by the Resolution and Planner
+ * DTOs (epoch seconds, local day numbers, seconds since midnight, interned
+ * timezone ids), with DateTime materialization on demand.
+ */
+
+namespace CalendarScheduler\Resolution\Dto;
+
+use DateTimeImmutable;
+use DateTimeZone;
+
+/**
+ * CompactTiming
+ *
+ * Resolution and Planner DTOs keep every instant as plain integers:
+ * - epoch: Unix timestamp (ordering, overlap checks)
+ * - day: local calendar day number, days since 1970-01-01 in the instant's
+ *   own timezone (scope date rendering)
+ * - second: local seconds since midnight (daily windows)
+ * - zone: process-local id of the instant's timezone, interned here
+ *
+ * DateTimeImmutable objects are only built again (materialize()) where a
+ * caller needs one, e.g. manifest rendering or calendar arithmetic.
+ *
+ * Zone ids are only meaningful inside the process that interned them, so DTOs
+ * that cross a process boundary serialize zone names instead (exportZones()/
+ * importZones()).
+ */
+final class CompactTiming
+{
+    private const SECONDS_PER_DAY = 86400;
+
+    /** @var array<string,int> timezone name => id */
+    private static array $zoneIds = [];
+
+    /** @var array<int,DateTimeZone> */
+    private static array $zones = [];
+
+    private function __construct()
+    {
+    }
+
+    public static function zoneId(DateTimeZone $zone): int
+    {
+        $name = $zone->getName();
+        $id = self::$zoneIds[$name] ?? null;
+        if ($id === null) {
+            $id = count(self::$zones);
+            self::$zoneIds[$name] = $id;
+            self::$zones[$id] = $zone;
+        }
+
+        return $id;
+    }
+
+    public static function zone(int $zoneId): DateTimeZone
+    {
+        $zone = self::$zones[$zoneId] ?? null;
+        if ($zone === null) {
+            throw new \InvalidArgumentException("Unknown timezone id: {$zoneId}");
+        }
+
+        return $zone;
+    }
+
+    /**
+     * Replace the zone ids under $keys with timezone names (for __serialize).
+     *
+     * @param array<string,mixed> $fields
+     * @return array<string,mixed>
+     */
+    public static function exportZones(array $fields, string ...$keys): array
+    {
+        foreach ($keys as $key) {
+            $fields[$key] = self::zone($fields[$key])->getName();
+        }
+
+        return $fields;
+    }
+
+    /**
+     * Replace the timezone names under $keys with this process's zone ids
+     * (for __unserialize).
+     *
+     * @param array<string,mixed> $fields
+     * @return array<string,mixed>
+     */
+    public static function importZones(array $fields, string ...$keys): array
+    {
+        foreach ($keys as $key) {
+            $fields[$key] = self::zoneId(new DateTimeZone((string)$fields[$key]));
+        }
+
+        return $fields;
+    }
+
+    /**
+     * Local calendar day number of $value (days since 1970-01-01).
+     */
+    public static function dayNumber(DateTimeImmutable $value): int
+    {
+        return intdiv(self::localSeconds($value) - self::secondOfDay($value), self::SECONDS_PER_DAY);
+    }
+
+    /**
+     * Local seconds since midnight of $value.
+     */
+    public static function secondOfDay(DateTimeImmutable $value): int
+    {
+        $local = self::localSeconds($value) % self::SECONDS_PER_DAY;
+
+        return $local < 0 ? $local + self::SECONDS_PER_DAY : $local;
+    }
+
+    public static function materialize(int $epoch, int $zoneId): DateTimeImmutable
+    {
+        return (new DateTimeImmutable('@' . $epoch))->setTimezone(self::zone($zoneId));
+    }
+
+    /**
+     * Y-m-d of a local day number.
+     */
+    public static function date(int $dayNumber): string
+    {
+        return gmdate('Y-m-d', $dayNumber * self::SECONDS_PER_DAY);
+    }
+
+    /**
+     * H:i:s of a local second of day.
+     */
+    public static function time(int $secondOfDay): string
+    {
+        return sprintf(
+            '%02d:%02d:%02d',
+            intdiv($secondOfDay, 3600),
+            intdiv($secondOfDay % 3600, 60),
+            $secondOfDay % 60
+        );
+    }
+
+    private static function localSeconds(DateTimeImmutable $value): int
+    {
+        return $value->getTimestamp() + $value->getOffset();
+    }
+}
@@ -0,0 +1,82 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Source Component
+ *
+ * File: Resolution/Dto/PayloadPool.php
+ * Purpose: Process-wide interning of subevent payload arrays, so equal
+ * payloads held by many Resolution/Planner DTOs share one copy.
+ */
+
+namespace CalendarScheduler\Resolution\Dto;
+
+/**
+ * PayloadPool
+ *
+ * Decoded provider rows hold their own copy of every payload, even when many
+ * rows carry the same one (overrides of a series, repeated descriptions).
+ * intern() returns one shared array per distinct payload; on a miss, the
+ * payload's own array/string members (description, metadata, ...) are shared
+ * the same way, so payloads that differ in one field still share the rest.
+ *
+ * Sharing is invisible to callers: PHP arrays are copy-on-write, and equal
+ * payloads compare with a pointer check. Entries are keyed by a hash and
+ * verified on hit, so a collision only costs sharing, never correctness.
+ */
+final class PayloadPool
+{
+    /** @var array<string,array<string,mixed>> */
+    private static array $payloads = [];
+
+    /** @var array<string,mixed> */
+    private static array $members = [];
+
+    private function __construct()
+    {
+    }
+
+    /**
+     * @param array<string,mixed> $payload
+     * @return array<string,mixed>
+     */
+    public static function intern(array $payload): array
+    {
+        if ($payload === []) {
+            return $payload;
+        }
+
+        $key = hash('xxh128', serialize($payload));
+        $shared = self::$payloads[$key] ?? null;
+        if ($shared !== null) {
+            return $shared === $payload ? $shared : $payload;
+        }
+
+        foreach ($payload as $field => $value) {
+            if (is_array($value) || (is_string($value) && $value !== '')) {
+                $payload[$field] = self::member($value);
+            }
+        }
+
+        return self::$payloads[$key] = $payload;
+    }
+
+    /**
+     * Drop the pool; interned payloads stay valid wherever they are held.
+     */
+    public static function clear(): void
+    {
+        self::$payloads = [];
+        self::$members = [];
+    }
+
+    private static function member(mixed $value): mixed
+    {
+        $key = hash('xxh128', serialize($value));
+        if (!array_key_exists($key, self::$members)) {
+            return self::$members[$key] = $value;
+        }
+
+        return self::$members[$key] === $value ? self::$members[$key] : $value;
+    }
+}
@@ -21,9 +21,14 @@ use DateTimeImmutable;
  */
 final class ResolutionScope
 {
-    // Inclusive start and exclusive end boundaries for scope evaluation.
-    private DateTimeImmutable $start;
-    private DateTimeImmutable $end;
+    // Inclusive start and exclusive end boundaries for scope evaluation, kept
+    // as CompactTiming integers (see getStart()/getEnd() for DateTimes).
+    private int $startEpoch;
+    private int $endEpoch;
+    private int $startDay;
+    private int $endDay;
+    private int $startZone;
+    private int $endZone;
 
     public function __construct(DateTimeImmutable $start, DateTimeImmutable $end)
     {
@@ -31,17 +36,101 @@ final class ResolutionScope
         if ($end <= $start) {
             throw new \InvalidArgumentException('ResolutionScope end must be after start.');
         }
-        $this->start = $start;
-        $this->end = $end;
+        $this->startEpoch = $start->getTimestamp();
+        $this->endEpoch = $end->getTimestamp();
+        $this->startDay = CompactTiming::dayNumber($start);
+        $this->endDay = CompactTiming::dayNumber($end);
+        $this->startZone = CompactTiming::zoneId($start->getTimezone());
+        $this->endZone = CompactTiming::zoneId($end->getTimezone());
     }
 
     public function getStart(): DateTimeImmutable
     {
-        return $this->start;
+        return CompactTiming::materialize($this->startEpoch, $this->startZone);
     }
 
     public function getEnd(): DateTimeImmutable
     {
-        return $this->end;
+        return CompactTiming::materialize($this->endEpoch, $this->endZone);
+    }
+
+    public function getStartEpoch(): int
+    {
+        return $this->startEpoch;
+    }
+
+    public function getEndEpoch(): int
+    {
+        return $this->endEpoch;
+    }
+
+    /**
+     * Local day number of the start, in the start's own timezone.
+     */
+    public function getStartDay(): int
+    {
+        return $this->startDay;
+    }
+
+    /**
+     * Local day number of the (exclusive) end, in the end's own timezone.
+     */
+    public function getEndDay(): int
+    {
+        return $this->endDay;
+    }
+
+    /**
+     * Timezone of the start, without materializing a DateTime.
+     */
+    public function getStartZone(): \DateTimeZone
+    {
+        return CompactTiming::zone($this->startZone);
+    }
+
+    /**
+     * Local day number of the start as seen in $zone.
+     */
+    public function startDayIn(\DateTimeZone $zone): int
+    {
+        return CompactTiming::zoneId($zone) === $this->startZone
+            ? $this->startDay
+            : CompactTiming::dayNumber($this->getStart()->setTimezone($zone));
+    }
+
+    /**
+     * Local day number of the (exclusive) end as seen in $zone.
+     */
+    public function endDayIn(\DateTimeZone $zone): int
+    {
+        return CompactTiming::zoneId($zone) === $this->endZone
+            ? $this->endDay
+            : CompactTiming::dayNumber($this->getEnd()->setTimezone($zone));
+    }
+
+    /**
+     * Y-m-d of the start as seen in $zone.
+     */
+    public function startDateIn(\DateTimeZone $zone): string
+    {
+        return CompactTiming::date($this->startDayIn($zone));
+    }
+
+    /**
+     * @return array<string,mixed>
+     */
+    public function __serialize(): array
+    {
+        return CompactTiming::exportZones(get_object_vars($this), 'startZone', 'endZone');
+    }
+
+    /**
+     * @param array<string,mixed> $data
+     */
+    public function __unserialize(array $data): void
+    {
+        foreach (CompactTiming::importZones($data, 'startZone', 'endZone') as $name => $value) {
+            $this->$name = $value;
+        }
     }
 }
@@ -54,22 +54,7 @@ final class ResolvedSchedule
 
         foreach ($this->bundles as $bundle) {
             foreach ($bundle->getSubevents() as $subevent) {
-                $intents[] = new PlannerIntent(
-                    bundleUid: $subevent->getBundleUid(),
-                    parentUid: $subevent->getParentUid(),
-                    sourceEventUid: $subevent->getSourceEventUid(),
-                    provider: $subevent->getProvider(),
-                    start: $subevent->getStart(),
-                    end: $subevent->getEnd(),
-                    allDay: $subevent->isAllDay(),
-                    timezone: $subevent->getTimezone(),
-                    role: $subevent->getRole(),
-                    scope: $subevent->getScope(),
-                    priority: $subevent->getPriority(),
-                    payload: $subevent->getPayload(),
-                    sourceTrace: $subevent->getSourceTrace(),
-                    weeklyDays: $subevent->getWeeklyDays()
-                );
+                $intents[] = PlannerIntent::fromSubevent($subevent);
             }
         }
 
@@ -87,14 +72,14 @@ final class ResolvedSchedule
         usort(
             $bundles,
             function (ResolvedBundle $a, ResolvedBundle $b): int {
-                $aStart = $a->getSegmentScope()->getStart()->getTimestamp();
-                $bStart = $b->getSegmentScope()->getStart()->getTimestamp();
+                $aStart = $a->getSegmentScope()->getStartEpoch();
+                $bStart = $b->getSegmentScope()->getStartEpoch();
                 if ($aStart !== $bStart) {
                     return $aStart <=> $bStart;
                 }
 
-                $aEnd = $a->getSegmentScope()->getEnd()->getTimestamp();
-                $bEnd = $b->getSegmentScope()->getEnd()->getTimestamp();
+                $aEnd = $a->getSegmentScope()->getEndEpoch();
+                $bEnd = $b->getSegmentScope()->getEndEpoch();
                 if ($aEnd !== $bEnd) {
                     return $aEnd <=> $bEnd;
                 }
@@ -23,8 +23,15 @@ final class ResolvedSubevent
     private string $sourceEventUid;
     private string $parentUid;
     private string $provider;
-    private \DateTimeImmutable $start;
-    private \DateTimeImmutable $end;
+
+    // Execution window as CompactTiming integers (see getStart()/getEnd()).
+    private int $startEpoch;
+    private int $endEpoch;
+    private int $startSecond;
+    private int $endSecond;
+    private int $startZone;
+    private int $endZone;
+
     private bool $allDay;
     private ?string $timezone;
     private string $role;
@@ -38,7 +45,12 @@ final class ResolvedSubevent
     /** @var array<string,mixed> */
     private array $payload;
 
-    /** @var array */
+    /**
+     * Origin of the subevent: kind (base|override), provider event id (uid)
+     * and snapshot row index (row); segment bounds as well in debug mode.
+     *
+     * @var array<string,mixed>
+     */
     private array $sourceTrace;
 
     /**
@@ -73,8 +85,12 @@ final class ResolvedSubevent
         $this->sourceEventUid = $sourceEventUid;
         $this->parentUid = $parentUid;
         $this->provider = $provider;
-        $this->start = $start;
-        $this->end = $end;
+        $this->startEpoch = $start->getTimestamp();
+        $this->endEpoch = $end->getTimestamp();
+        $this->startSecond = CompactTiming::secondOfDay($start);
+        $this->endSecond = CompactTiming::secondOfDay($end);
+        $this->startZone = CompactTiming::zoneId($start->getTimezone());
+        $this->endZone = CompactTiming::zoneId($end->getTimezone());
         $this->allDay = $allDay;
         $this->timezone = $timezone;
         $this->role = $role;
@@ -107,12 +123,48 @@ final class ResolvedSubevent
 
     public function getStart(): \DateTimeImmutable
     {
-        return $this->start;
+        return CompactTiming::materialize($this->startEpoch, $this->startZone);
     }
 
     public function getEnd(): \DateTimeImmutable
     {
-        return $this->end;
+        return CompactTiming::materialize($this->endEpoch, $this->endZone);
+    }
+
+    public function getStartEpoch(): int
+    {
+        return $this->startEpoch;
+    }
+
+    public function getEndEpoch(): int
+    {
+        return $this->endEpoch;
+    }
+
+    /**
+     * Local seconds since midnight of the start.
+     */
+    public function getStartSecond(): int
+    {
+        return $this->startSecond;
+    }
+
+    /**
+     * Local seconds since midnight of the end.
+     */
+    public function getEndSecond(): int
+    {
+        return $this->endSecond;
+    }
+
+    public function getStartZoneId(): int
+    {
+        return $this->startZone;
+    }
+
+    public function getEndZoneId(): int
+    {
+        return $this->endZone;
     }
 
     public function isAllDay(): bool
@@ -172,4 +224,24 @@ final class ResolvedSubevent
     {
         return $this->weeklyDays;
     }
+
+    /**
+     * @return array<string,mixed>
+     */
+    public function __serialize(): array
+    {
+        return CompactTiming::exportZones(get_object_vars($this), 'startZone', 'endZone');
+    }
+
+    /**
+     * @param array<string,mixed> $data
+     */
+    public function __unserialize(array $data): void
+    {
+        // Payloads come back as separate copies; share them again.
+        $data['payload'] = PayloadPool::intern($data['payload']);
+        foreach (CompactTiming::importZones($data, 'startZone', 'endZone') as $name => $value) {
+            $this->$name = $value;
+        }
+    }
 }
@@ -13,11 +13,14 @@ namespace CalendarScheduler\Resolution;
 use CalendarScheduler\Adapter\Calendar\CalendarSnapshot;
 use CalendarScheduler\Adapter\Calendar\SnapshotEvent;
 use CalendarScheduler\Adapter\Calendar\OverrideIntent;
+use CalendarScheduler\Resolution\Dto\CompactTiming;
+use CalendarScheduler\Resolution\Dto\PayloadPool;
 use CalendarScheduler\Resolution\Dto\ResolvedBundle;
 use CalendarScheduler\Resolution\Dto\ResolvedSchedule;
 use CalendarScheduler\Resolution\Dto\ResolvedSubevent;
 use CalendarScheduler\Resolution\Dto\ResolutionRole;
 use CalendarScheduler\Resolution\Dto\ResolutionScope;
+use CalendarScheduler\Platform\Trace;
 
 /**
  * Stage 3 implementation:
@@ -31,12 +34,39 @@ use CalendarScheduler\Resolution\Dto\ResolutionScope;
  */
 final class ResolutionEngine implements ResolutionEngineInterface
 {
+    private readonly bool $fullTrace;
+
+    /**
+     * Subevent source traces reference the provider row (provider event id +
+     * snapshot row index) they came from; segment bounds are added only with
+     * $fullTrace (default: debug mode, CS_DEBUG_CALENDAR=1).
+     */
+    public function __construct(?bool $fullTrace = null)
+    {
+        $this->fullTrace = $fullTrace ?? getenv('CS_DEBUG_CALENDAR') === '1';
+    }
+
     public function resolve(CalendarSnapshot $snapshot): ResolvedSchedule
+    {
+        return new ResolvedSchedule($this->resolveEvents($snapshot->getSnapshotEvents()));
+    }
+
+    /**
+     * Resolve snapshot events into coalesced bundles (unsorted).
+     *
+     * Events resolve independently (coalescing never crosses events), so a
+     * list may be split and resolved in parts; concatenating the parts in
+     * order gives the same bundles as resolving the whole list.
+     *
+     * @param array<int|string,SnapshotEvent> $snapshotEvents
+     * @return ResolvedBundle[]
+     */
+    public function resolveEvents(array $snapshotEvents): array
     {
         $bundles = [];
 
-        $snapshotEvents = $snapshot->getSnapshotEvents();
         foreach ($snapshotEvents as $snapshotEvent) {
+            Trace::begin('resolve event', 'resolution', ['sourceEventUid' => $snapshotEvent->sourceEventUid]);
             $segments = $this->buildDateSegments($snapshotEvent);
             foreach ($segments as $segmentScope) {
                 $bundleUid = $this->buildBundleUid($snapshotEvent, $segmentScope);
@@ -57,6 +87,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
                     subevents: $subevents
                 );
             }
+            Trace::end(['segments' => count($segments)]);
         }
 
         // Coalesce adjacent bundles where possible
@@ -71,7 +102,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
                 && $current->getParentUid() === $bundles[$i + 1]->getParentUid()
                 && $current->getSourceEventUid() === $bundles[$i + 1]->getSourceEventUid()
                 && $current->getOverrideSignature() === $bundles[$i + 1]->getOverrideSignature()
-                && $current->getSegmentScope()->getEnd() == $bundles[$i + 1]->getSegmentScope()->getStart()
+                && $current->getSegmentScope()->getEndEpoch() === $bundles[$i + 1]->getSegmentScope()->getStartEpoch()
             ) {
                 // Merge current and next
                 $mergedScope = new \CalendarScheduler\Resolution\Dto\ResolutionScope(
@@ -98,7 +129,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
             $coalescedBundles[] = $current;
             $i++;
         }
-        return new ResolvedSchedule($coalescedBundles);
+        return $coalescedBundles;
     }
 
     /**
@@ -340,10 +371,10 @@ final class ResolutionEngine implements ResolutionEngineInterface
         }
 
         $result = [];
-        $segStart = $segment->getStart();
-        $segEnd = $segment->getEnd(); // exclusive
+        $segStart = $segment->getStartEpoch();
+        $segEnd = $segment->getEndEpoch(); // exclusive
 
-        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $segStart->getTimezone();
+        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $segment->getStartZone();
 
         foreach ($event->overrides as $override) {
             // Use originalStartTime as the anchor for date membership (calendar exception semantics)
@@ -359,7 +390,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
             }
 
             // Date-level membership: compare by day boundary
-            $anchorDay = (new \DateTimeImmutable($anchor->format('Y-m-d'), $tz))->setTime(0, 0, 0);
+            $anchorDay = (new \DateTimeImmutable($anchor->format('Y-m-d'), $tz))->setTime(0, 0, 0)->getTimestamp();
             if ($anchorDay >= $segStart && $anchorDay < $segEnd) {
                 $result[] = $override;
             }
@@ -386,7 +417,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
             return [];
         }
 
-        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $segmentScope->getStart()->getTimezone();
+        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $segmentScope->getStartZone();
 
         // Build normalized override records keyed by day
         $rows = [];
@@ -412,7 +443,8 @@ final class ResolutionEngine implements ResolutionEngineInterface
                 'day' => $day,
                 'startTod' => $this->extractTimeOfDayFromDateTimeArray($overrideStart, $baseStartTod, $tz),
                 'endTod' => $this->extractTimeOfDayFromDateTimeArray($overrideEnd, $baseEndTod, $tz),
-                'payload' => $override->payload,
+                // Interned: equal payloads then compare by pointer below.
+                'payload' => PayloadPool::intern($override->payload),
                 'enabled' => $override->enabled ?? true,
                 'stopType' => $override->stopType ?? null,
                 'source' => $override,
@@ -514,7 +546,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
         SnapshotEvent $event,
         ResolutionScope $scope
     ): array {
-        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $scope->getStart()->getTimezone();
+        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $scope->getStartZone();
         [$st, $et] = $this->extractEventTimeOfDay($event);
         return $this->executionWindowFromScopeWithTimeOfDay($scope, $tz, $st, $et);
     }
@@ -532,21 +564,24 @@ final class ResolutionEngine implements ResolutionEngineInterface
         array $st,
         array $et
     ): array {
-        $scopeStart = $scope->getStart()->setTimezone($tz);
-        $scopeEnd   = $scope->getEnd()->setTimezone($tz); // exclusive
+        // Day numbers in $tz; only the two results are built as DateTimes.
+        $scopeStartDay = $scope->startDayIn($tz);
+        $scopeEndDay = $scope->endDayIn($tz); // exclusive
 
-        $execStart = $scopeStart->setTime($st['h'], $st['m'], $st['s']);
+        $execStart = (new \DateTimeImmutable(CompactTiming::date($scopeStartDay), $tz))
+            ->setTime($st['h'], $st['m'], $st['s']);
 
         // Default: end time applies to the last included day (endExclusive - 1 day)
-        $lastDay = $scopeEnd->modify('-1 day');
-        $execEnd = $lastDay->setTime($et['h'], $et['m'], $et['s']);
+        $endDay = $scopeEndDay - 1;
 
         // Cross-midnight: end time is on the next day relative to the last start day
         $startSecs = ($st['h'] * 3600) + ($st['m'] * 60) + $st['s'];
         $endSecs   = ($et['h'] * 3600) + ($et['m'] * 60) + $et['s'];
         if ($endSecs <= $startSecs) {
-            $execEnd = $scopeEnd->setTime($et['h'], $et['m'], $et['s']);
+            $endDay = $scopeEndDay;
         }
+        $execEnd = (new \DateTimeImmutable(CompactTiming::date($endDay), $tz))
+            ->setTime($et['h'], $et['m'], $et['s']);
 
         return [$execStart, $execEnd];
     }
@@ -594,17 +629,20 @@ final class ResolutionEngine implements ResolutionEngineInterface
         \DateTimeImmutable $end,
         ResolutionScope $segmentScope
     ): ?array {
-        $segStart = $segmentScope->getStart();
-        $segEnd = $segmentScope->getEnd();
-
-        $clippedStart = ($start < $segStart) ? $segStart : $start;
-        $clippedEnd = ($end > $segEnd) ? $segEnd : $end;
+        $startEpoch = $start->getTimestamp();
+        $endEpoch = $end->getTimestamp();
+        $clippedStartEpoch = max($startEpoch, $segmentScope->getStartEpoch());
+        $clippedEndEpoch = min($endEpoch, $segmentScope->getEndEpoch());
 
-        if ($clippedEnd <= $clippedStart) {
+        if ($clippedEndEpoch <= $clippedStartEpoch) {
             return null;
         }
 
-        return [$clippedStart, $clippedEnd];
+        // Segment bounds are only materialized when they actually clip.
+        return [
+            $clippedStartEpoch === $startEpoch ? $start : $segmentScope->getStart(),
+            $clippedEndEpoch === $endEpoch ? $end : $segmentScope->getEnd(),
+        ];
     }
 
     /**
@@ -617,7 +655,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
         $roleBase = ($role === ResolutionRole::OVERRIDE) ? 100000 : 0;
 
         // Narrower scope => higher boost. Work in whole days because Stage 3/4.1 uses date-level scopes.
-        $seconds = $scope->getEnd()->getTimestamp() - $scope->getStart()->getTimestamp();
+        $seconds = $scope->getEndEpoch() - $scope->getStartEpoch();
         $days = (int) max(1, (int) ceil($seconds / 86400));
 
         // 1-day => 9999, 2-day => 9998, ... floor at 0
@@ -637,12 +675,12 @@ final class ResolutionEngine implements ResolutionEngineInterface
         }
 
         // Earlier scope first for stability.
-        $s = $a->getScope()->getStart() <=> $b->getScope()->getStart();
+        $s = $a->getScope()->getStartEpoch() <=> $b->getScope()->getStartEpoch();
         if ($s !== 0) {
             return $s;
         }
 
-        $e = $a->getScope()->getEnd() <=> $b->getScope()->getEnd();
+        $e = $a->getScope()->getEndEpoch() <=> $b->getScope()->getEndEpoch();
         if ($e !== 0) {
             return $e;
         }
@@ -675,7 +713,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
 
         // Execution start/end MUST preserve time-of-day when available.
         // Scope stays date-based; use override-specific geometry when provided.
-        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $scope->getStart()->getTimezone();
+        $tz = $event->timezone ? new \DateTimeZone($event->timezone) : $scope->getStartZone();
         [$baseStartTod, $baseEndTod] = $this->extractEventTimeOfDay($event);
         $startTod = (is_array($row['startTod'] ?? null) && isset($row['startTod']['h'], $row['startTod']['m'], $row['startTod']['s']))
             ? $row['startTod']
@@ -699,11 +737,7 @@ final class ResolutionEngine implements ResolutionEngineInterface
             priority: $this->computePriority(ResolutionRole::OVERRIDE, $scope),
             weeklyDays: $this->extractWeeklyDays($event),
             payload: $row['payload'] ?? [],
-            sourceTrace: [
-                'kind' => 'override',
-                'segmentStart' => $segmentScope->getStart()->format(\DateTimeInterface::ATOM),
-                'segmentEnd' => $segmentScope->getEnd()->format(\DateTimeInterface::ATOM),
-            ]
+            sourceTrace: $this->sourceTrace('override', $row['source']->sourceRef ?? null, $segmentScope)
         );
     }
 
@@ -727,15 +761,26 @@ final class ResolutionEngine implements ResolutionEngineInterface
             scope: $segmentScope,
             priority: $this->computePriority(ResolutionRole::BASE, $segmentScope),
             weeklyDays: $this->extractWeeklyDays($event),
-            payload: $event->payload ?? [],
-            sourceTrace: [
-                'kind' => 'base',
-                'segmentStart' => $segmentScope->getStart()->format(\DateTimeInterface::ATOM),
-                'segmentEnd' => $segmentScope->getEnd()->format(\DateTimeInterface::ATOM),
-            ]
+            payload: PayloadPool::intern($event->payload ?? []),
+            sourceTrace: $this->sourceTrace('base', $event->sourceRefs[0] ?? null, $segmentScope)
         );
     }
 
+    /**
+     * @param array{uid:string,row:int}|null $sourceRef
+     * @return array<string,mixed>
+     */
+    private function sourceTrace(string $kind, ?array $sourceRef, ResolutionScope $segmentScope): array
+    {
+        $trace = ['kind' => $kind] + ($sourceRef ?? []);
+        if ($this->fullTrace) {
+            $trace['segmentStart'] = $segmentScope->getStart()->format(\DateTimeInterface::ATOM);
+            $trace['segmentEnd'] = $segmentScope->getEnd()->format(\DateTimeInterface::ATOM);
+        }
+
+        return $trace;
+    }
+
     /**
      * Deterministic bundle identity.
      * One bundle per (parentUid + segment scope).
@@ -758,8 +803,8 @@ final class ResolutionEngine implements ResolutionEngineInterface
             'sha256',
             implode('|', [
                 $parentUid,
-                $segmentScope->getStart()->format('Y-m-d'),
-                $segmentScope->getEnd()->format('Y-m-d'),
+                CompactTiming::date($segmentScope->getStartDay()),
+                CompactTiming::date($segmentScope->getEndDay()),
             ])
         );
     }
@@ -0,0 +1,99 @@
+<?php
+declare(strict_types=1);
+
+/**
+ * Calendar Scheduler — Generated Classmap
+ *
+ * File: src/autoload_classmap.php
+ * Purpose: Class => file map (relative to src/) consumed by the bootstrap.php
+ * autoloader. Generated by bin/cs-classmap; do not edit by hand.
+ */
+
+return [
+    'CalendarScheduler\\Adapter\\Calendar\\CalendarApplyRuntime' => '/Adapter/Calendar/CalendarContracts.php',
+    'CalendarScheduler\\Adapter\\Calendar\\CalendarMutationJournal' => '/Adapter/Calendar/CalendarContracts.php',
+    'CalendarScheduler\\Adapter\\Calendar\\CalendarMutationLink' => '/Adapter/Calendar/CalendarContracts.php',
+    'CalendarScheduler\\Adapter\\Calendar\\CalendarSnapshot' => '/Adapter/Calendar/CalendarSnapshot.php',
+    'CalendarScheduler\\Adapter\\Calendar\\ExecutorApplyRuntime' => '/Adapter/Calendar/ExecutorApplyRuntime.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleApiClient' => '/Adapter/Calendar/Google/GoogleApiClient.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleApplyExecutor' => '/Adapter/Calendar/Google/GoogleApply.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleCalendarTranslator' => '/Adapter/Calendar/Google/GoogleCalendarTranslator.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleConfig' => '/Adapter/Calendar/Google/GoogleConfig.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleEventMapper' => '/Adapter/Calendar/Google/GoogleEventMapper.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleEventMetadataSchema' => '/Adapter/Calendar/Google/GoogleEventMetadataSchema.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleMutation' => '/Adapter/Calendar/Google/GoogleApply.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Google\\GoogleMutationResult' => '/Adapter/Calendar/Google/GoogleApply.php',
+    'CalendarScheduler\\Adapter\\Calendar\\MapperShared' => '/Adapter/Calendar/MapperShared.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookApiClient' => '/Adapter/Calendar/Outlook/OutlookApiClient.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookApplyExecutor' => '/Adapter/Calendar/Outlook/OutlookApply.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookCalendarTranslator' => '/Adapter/Calendar/Outlook/OutlookCalendarTranslator.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookConfig' => '/Adapter/Calendar/Outlook/OutlookConfig.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookEventMapper' => '/Adapter/Calendar/Outlook/OutlookEventMapper.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookEventMetadataSchema' => '/Adapter/Calendar/Outlook/OutlookEventMetadataSchema.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookMutation' => '/Adapter/Calendar/Outlook/OutlookApply.php',
+    'CalendarScheduler\\Adapter\\Calendar\\Outlook\\OutlookMutationResult' => '/Adapter/Calendar/Outlook/OutlookApply.php',
+    'CalendarScheduler\\Adapter\\Calendar\\OverrideIntent' => '/Adapter/Calendar/OverrideIntent.php',
+    'CalendarScheduler\\Adapter\\Calendar\\PackedMetadata' => '/Adapter/Calendar/PackedMetadata.php',
+    'CalendarScheduler\\Adapter\\Calendar\\ProviderEventLookupRuntime' => '/Adapter/Calendar/CalendarContracts.php',
+    'CalendarScheduler\\Adapter\\Calendar\\ProviderRuntimeFactory' => '/Adapter/Calendar/ProviderRuntimeFactory.php',
+    'CalendarScheduler\\Adapter\\Calendar\\ProviderSnapshotRuntime' => '/Adapter/Calendar/CalendarContracts.php',
+    'CalendarScheduler\\Adapter\\Calendar\\ProviderStylePatchRuntime' => '/Adapter/Calendar/CalendarContracts.php',
+    'CalendarScheduler\\Adapter\\Calendar\\SnapshotEvent' => '/Adapter/Calendar/SnapshotEvent.php',
+    'CalendarScheduler\\Adapter\\Calendar\\SyncHorizon' => '/Adapter/Calendar/SyncHorizon.php',
+    'CalendarScheduler\\Adapter\\Calendar\\TranslationCache' => '/Adapter/Calendar/TranslationCache.php',
+    'CalendarScheduler\\Adapter\\Calendar\\TranslatorShared' => '/Adapter/Calendar/TranslatorShared.php',
+    'CalendarScheduler\\Adapter\\FppScheduleAdapter' => '/Adapter/FppScheduleAdapter.php',
+    'CalendarScheduler\\Adapter\\FppScheduleTranslator' => '/Adapter/FppScheduleTranslator.php',
+    'CalendarScheduler\\Apply\\ApplyEvaluation' => '/Apply/ApplyEvaluation.php',
+    'CalendarScheduler\\Apply\\ApplyJob' => '/Apply/ApplyJob.php',
+    'CalendarScheduler\\Apply\\ApplyJournal' => '/Apply/ApplyJournal.php',
+    'CalendarScheduler\\Apply\\ApplyOptions' => '/Apply/ApplyOptions.php',
+    'CalendarScheduler\\Apply\\ApplyOutcome' => '/Apply/ApplyOutcome.php',
+    'CalendarScheduler\\Apply\\ApplyRunner' => '/Apply/ApplyRunner.php',
+    'CalendarScheduler\\Apply\\ApplyTargets' => '/Apply/ApplyTargets.php',
+    'CalendarScheduler\\Apply\\FppScheduleCommit' => '/Apply/FppScheduleCommit.php',
+    'CalendarScheduler\\Apply\\FppScheduleWriter' => '/Apply/FppScheduleWriter.php',
+    'CalendarScheduler\\Apply\\ManifestWriter' => '/Apply/ManifestWriter.php',
+    'CalendarScheduler\\Diff\\Diff' => '/Diff/Diff.php',
+    'CalendarScheduler\\Diff\\DiffResult' => '/Diff/DiffResult.php',
+    'CalendarScheduler\\Diff\\IndexedManifest' => '/Diff/IndexedManifest.php',
+    'CalendarScheduler\\Diff\\Reconciler' => '/Diff/Reconciler.php',
+    'CalendarScheduler\\Diff\\ReconciliationAction' => '/Diff/ReconciliationAction.php',
+    'CalendarScheduler\\Diff\\ReconciliationResult' => '/Diff/ReconciliationResult.php',
+    'CalendarScheduler\\Engine\\HashSchemeMigrator' => '/Engine/HashSchemeMigrator.php',
+    'CalendarScheduler\\Engine\\ManagedColorReset' => '/Engine/ManagedColorReset.php',
+    'CalendarScheduler\\Engine\\ManagedMetadataMigration' => '/Engine/ManagedMetadataMigration.php',
+    'CalendarScheduler\\Engine\\PostApplyProjection' => '/Engine/PostApplyProjection.php',
+    'CalendarScheduler\\Engine\\SchedulerEngine' => '/Engine/SchedulerEngine.php',
+    'CalendarScheduler\\Engine\\SchedulerRunResult' => '/Engine/SchedulerRunResult.php',
+    'CalendarScheduler\\Intent\\Intent' => '/Intent/Intent.php',
+    'CalendarScheduler\\Intent\\IntentNormalizer' => '/Intent/IntentNormalizer.php',
+    'CalendarScheduler\\Intent\\NormalizationContext' => '/Intent/NormalizationContext.php',
+    'CalendarScheduler\\Planner\\Dto\\PlannerIntent' => '/Planner/Dto/PlannerIntent.php',
+    'CalendarScheduler\\Planner\\ManifestPlanner' => '/Planner/ManifestPlanner.php',
+    'CalendarScheduler\\Planner\\OrderingKey' => '/Planner/OrderingKey.php',
+    'CalendarScheduler\\Planner\\PlannedEntry' => '/Planner/PlannedEntry.php',
+    'CalendarScheduler\\Planner\\Planner' => '/Planner/Planner.php',
+    'CalendarScheduler\\Planner\\PlannerResult' => '/Planner/PlannerResult.php',
+    'CalendarScheduler\\Planner\\ResolvedSchedulePlanner' => '/Planner/ResolvedSchedulePlanner.php',
+    'CalendarScheduler\\Planner\\ResolvedScheduleToIntentAdapter' => '/Planner/ResolvedScheduleToIntentAdapter.php',
+    'CalendarScheduler\\Platform\\FPPSemantics' => '/Platform/FppSemantics.php',
+    'CalendarScheduler\\Platform\\FppEventTimestampStore' => '/Platform/FppEventTimestampStore.php',
+    'CalendarScheduler\\Platform\\HashScheme' => '/Platform/HashScheme.php',
+    'CalendarScheduler\\Platform\\HolidayResolver' => '/Platform/HolidayResolver.php',
+    'CalendarScheduler\\Platform\\HolidayTableCache' => '/Platform/HolidayTableCache.php',
+    'CalendarScheduler\\Platform\\IniMetadata' => '/Platform/IniMetadata.php',
+    'CalendarScheduler\\Platform\\ProcessPool' => '/Platform/ProcessPool.php',
+    'CalendarScheduler\\Platform\\SunTimeDisplayEstimator' => '/Platform/SunTimeDisplayEstimator.php',
+    'CalendarScheduler\\Platform\\SunTimeTable' => '/Platform/SunTimeTable.php',
+    'CalendarScheduler\\Platform\\Trace' => '/Platform/Trace.php',
+    'CalendarScheduler\\Resolution\\Dto\\CompactTiming' => '/Resolution/Dto/CompactTiming.php',
+    'CalendarScheduler\\Resolution\\Dto\\PayloadPool' => '/Resolution/Dto/PayloadPool.php',
+    'CalendarScheduler\\Resolution\\Dto\\ResolutionRole' => '/Resolution/Dto/ResolutionRole.php',
+    'CalendarScheduler\\Resolution\\Dto\\ResolutionScope' => '/Resolution/Dto/ResolutionScope.php',
+    'CalendarScheduler\\Resolution\\Dto\\ResolvedBundle' => '/Resolution/Dto/ResolvedBundle.php',
+    'CalendarScheduler\\Resolution\\Dto\\ResolvedSchedule' => '/Resolution/Dto/ResolvedSchedule.php',
+    'CalendarScheduler\\Resolution\\Dto\\ResolvedSubevent' => '/Resolution/Dto/ResolvedSubevent.php',
+    'CalendarScheduler\\Resolution\\ResolutionEngine' => '/Resolution/ResolutionEngine.php',
+    'CalendarScheduler\\Resolution\\ResolutionEngineInterface' => '/Resolution/ResolutionEngineInterface.php',
+];
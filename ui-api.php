@@ -7,9 +7,20 @@ declare(strict_types=1);
  * File: ui-api.php
  * Purpose: Expose JSON APIs used by the Calendar Scheduler UI for connection,
  * status, preview, and apply operations.
+ *
+ * Apply runs as a job: the `apply` action starts a detached CLI worker
+ * (`php ui-api.php --apply-job=<id>`) and returns the job id immediately;
+ * `apply_progress` streams the job's stage events as Server-Sent Events.
+ *
+ * With the `trace_runs` UI preference on, previews and apply jobs record a
+ * span trace (Chrome Trace Event JSON) under runtime/traces; diagnostics
+ * lists the recent ones and `trace_download` returns one.
  */
 
+use CalendarScheduler\Apply\ApplyJob;
+use CalendarScheduler\Apply\ApplyJournal;
 use CalendarScheduler\Apply\ApplyOptions;
+use CalendarScheduler\Apply\ApplyOutcome;
 use CalendarScheduler\Apply\ApplyRunner;
 use CalendarScheduler\Apply\ApplyTargets;
 use CalendarScheduler\Apply\FppScheduleWriter;
@@ -18,14 +29,16 @@ use CalendarScheduler\Adapter\Calendar\ProviderRuntimeFactory;
 use CalendarScheduler\Adapter\Calendar\MapperShared;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleApiClient;
 use CalendarScheduler\Adapter\Calendar\Google\GoogleConfig;
-use CalendarScheduler\Adapter\Calendar\Google\GoogleEventMetadataSchema;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookApiClient;
 use CalendarScheduler\Adapter\Calendar\Outlook\OutlookConfig;
-use CalendarScheduler\Adapter\Calendar\Outlook\OutlookEventMetadataSchema;
 use CalendarScheduler\Adapter\FppScheduleAdapter;
+use CalendarScheduler\Engine\ManagedColorReset;
+use CalendarScheduler\Engine\ManagedMetadataMigration;
+use CalendarScheduler\Engine\PostApplyProjection;
 use CalendarScheduler\Engine\SchedulerEngine;
 use CalendarScheduler\Engine\SchedulerRunResult;
 use CalendarScheduler\Platform;
+use CalendarScheduler\Platform\Trace;
 
 header('Content-Type: application/json');
 
@@ -39,6 +52,13 @@ const CS_GOOGLE_CONFIG_DIR = '/home/fpp/media/config/calendar-scheduler/calendar
 const CS_OUTLOOK_CONFIG_DIR = '/home/fpp/media/config/calendar-scheduler/calendar/outlook';
 const CS_UI_PREFS_PATH = '/home/fpp/media/config/calendar-scheduler/runtime/ui-prefs.json';
 const CS_FPP_RUNTIME_PATH = '/home/fpp/media/config/calendar-scheduler/runtime/fpp-runtime.json';
+const CS_CALENDAR_SNAPSHOT_PATH = '/home/fpp/media/config/calendar-scheduler/calendar/calendar-snapshot.json';
+const CS_COLOR_RESET_PROGRESS_PATH = '/home/fpp/media/config/calendar-scheduler/runtime/color-reset-progress.json';
+const CS_APPLY_JOURNAL_DIR = '/home/fpp/media/config/calendar-scheduler/runtime';
+const CS_APPLY_JOBS_DIR = ApplyJob::DEFAULT_DIR;
+const CS_APPLY_PROGRESS_WINDOW_SECONDS = 25;
+const CS_TRACE_DIR = '/home/fpp/media/config/calendar-scheduler/runtime/traces';
+const CS_TRACE_KEEP = 10;
 const CS_GOOGLE_DEVICE_CLIENT_FILENAME = 'client_secret_device.json';
 const CS_GOOGLE_DEFAULT_REDIRECT_URI = 'http://127.0.0.1:8765/oauth2callback';
 const CS_GOOGLE_DEFAULT_SCOPE = 'https://www.googleapis.com/auth/calendar';
@@ -244,9 +264,78 @@ function cs_diagnostics_payload(?string $requestedSyncMode = null): array
         'pendingSummary' => $pendingSummary,
         'lastError' => $lastError,
         'previewGeneratedAtUtc' => $previewGeneratedAtUtc,
+        'trace' => [
+            'enabled' => cs_get_ui_pref_bool('trace_runs', false),
+            'recent' => cs_recent_traces(),
+        ],
+        'applyFullVerify' => cs_get_ui_pref_bool('apply_full_verify', false),
     ];
 }
 
+/**
+ * Start recording a trace for a preview/apply when the trace_runs preference
+ * is on. Returns the file to write, or null when not tracing (or when an
+ * enclosing run already owns the trace).
+ */
+function cs_trace_start(string $kind): ?string
+{
+    if (Trace::enabled()) {
+        return null;
+    }
+    try {
+        if (!cs_get_ui_pref_bool('trace_runs', false)) {
+            return null;
+        }
+    } catch (\Throwable) {
+        return null;
+    }
+
+    Trace::enable();
+    return CS_TRACE_DIR . '/' . $kind . '-' . gmdate('Ymd\THis\Z') . '-' . bin2hex(random_bytes(3)) . '.json';
+}
+
+/**
+ * Write the trace started by cs_trace_start() and keep only the newest files.
+ * Tracing never fails the traced run.
+ */
+function cs_trace_finish(?string $path): void
+{
+    if ($path === null) {
+        return;
+    }
+    try {
+        Trace::write($path);
+    } catch (\Throwable $e) {
+        error_log('[CalendarScheduler] trace not written: ' . $e->getMessage());
+    } finally {
+        Trace::disable();
+    }
+
+    $paths = glob(CS_TRACE_DIR . '/*.json') ?: [];
+    usort($paths, static fn (string $a, string $b): int => (int)@filemtime($b) <=> (int)@filemtime($a));
+    foreach (array_slice($paths, CS_TRACE_KEEP) as $old) {
+        @unlink($old);
+    }
+}
+
+/**
+ * @return array<int,array{name:string,bytes:int,modifiedAtUtc:string}>
+ */
+function cs_recent_traces(): array
+{
+    $out = [];
+    foreach (glob(CS_TRACE_DIR . '/*.json') ?: [] as $path) {
+        $mtime = (int)@filemtime($path);
+        $out[] = [
+            'name' => basename($path),
+            'bytes' => (int)@filesize($path),
+            'modifiedAtUtc' => gmdate(DATE_ATOM, $mtime),
+        ];
+    }
+    usort($out, static fn (array $a, array $b): int => strcmp($b['modifiedAtUtc'], $a['modifiedAtUtc']));
+    return $out;
+}
+
 function cs_export_fpp_runtime(): void
 {
     // Promote warnings to exceptions so export failures are explicit to callers.
@@ -271,39 +360,22 @@ function cs_run_preview_engine(?string $syncMode = null): SchedulerRunResult
     $syncMode = cs_normalize_sync_mode($syncMode ?? CS_SYNC_MODE_BOTH);
     $provider = cs_get_calendar_provider();
     $engine = new SchedulerEngine();
-    return $engine->runFromCli(
-        $_SERVER['argv'] ?? [],
-        [
-            'refresh-calendar' => true,
-            'sync-mode' => $syncMode,
-            'calendar-provider' => $provider,
-        ]
-    );
-}
-
-/**
- * @param array<string,mixed> $manifest
- * @return array<string,array<string,mixed>>
- */
-function cs_index_manifest_events(array $manifest): array
-{
-    $indexed = [];
-    $events = is_array($manifest['events'] ?? null) ? $manifest['events'] : [];
-    foreach ($events as $key => $event) {
-        if (is_array($event) && is_string($key) && $key !== '') {
-            $indexed[$key] = $event;
-            continue;
-        }
-        if (!is_array($event)) {
-            continue;
-        }
-        $id = $event['identityHash'] ?? $event['id'] ?? null;
-        if (is_string($id) && $id !== '') {
-            $indexed[$id] = $event;
-        }
+    $tracePath = cs_trace_start('preview');
+    try {
+        Trace::begin('scheduler run', 'engine', ['syncMode' => $syncMode, 'provider' => $provider]);
+        $result = $engine->runFromCli(
+            $_SERVER['argv'] ?? [],
+            [
+                'refresh-calendar' => true,
+                'sync-mode' => $syncMode,
+                'calendar-provider' => $provider,
+            ]
+        );
+        Trace::end();
+        return $result;
+    } finally {
+        cs_trace_finish($tracePath);
     }
-
-    return $indexed;
 }
 
 /**
@@ -312,9 +384,9 @@ function cs_index_manifest_events(array $manifest): array
 function cs_actions_for_ui(SchedulerRunResult $result): array
 {
     $out = [];
-    $currentManifestEvents = cs_index_manifest_events($result->currentManifest());
+    $currentIndex = $result->currentIndex();
     foreach ($result->actions() as $action) {
-        $manifestEvent = $currentManifestEvents[$action->identityHash] ?? null;
+        $manifestEvent = $currentIndex->get($action->identityHash);
         $rawEvent = is_array($action->event) ? $action->event : [];
         $rawIdentity = is_array($rawEvent['identity'] ?? null) ? $rawEvent['identity'] : [];
         $out[] = [
@@ -1559,17 +1631,64 @@ function cs_google_disconnect(): void
     }
 }
 
-function cs_apply(SchedulerRunResult $result, ?string $syncMode = null): array
+/**
+ * @return array<int,string>
+ */
+function cs_apply_targets(string $syncMode): array
 {
-    $syncMode = cs_normalize_sync_mode($syncMode ?? cs_get_sync_mode());
     if ($syncMode === CS_SYNC_MODE_CALENDAR) {
-        $targets = [ApplyTargets::TARGET_FPP];
-    } elseif ($syncMode === CS_SYNC_MODE_FPP) {
-        $targets = [ApplyTargets::TARGET_CALENDAR];
-    } else {
-        $targets = ApplyTargets::all();
+        return [ApplyTargets::TARGET_FPP];
+    }
+    if ($syncMode === CS_SYNC_MODE_FPP) {
+        return [ApplyTargets::TARGET_CALENDAR];
+    }
+    return ApplyTargets::all();
+}
+
+function cs_build_applier(?\Closure $onStage = null): ApplyRunner
+{
+    return new ApplyRunner(
+        new ManifestWriter(CS_MANIFEST_PATH),
+        new FppScheduleAdapter(),
+        new FppScheduleWriter(CS_SCHEDULE_PATH, CS_FPP_STAGE_DIR),
+        ProviderRuntimeFactory::createApply(cs_get_calendar_provider()),
+        new ApplyJournal(CS_APPLY_JOURNAL_DIR),
+        $onStage
+    );
+}
+
+/**
+ * Finish an interrupted apply (only unacknowledged mutations are sent) so the
+ * next plan starts from a finalized manifest.
+ *
+ * The stored targets and options are replayed, fail-closed, as on the CLI; a
+ * stale journal is refused unless $confirmed (see ApplyRunner::resume()).
+ */
+function cs_resume_pending_apply(string $syncMode, ?\Closure $onStage = null, bool $confirmed = false): bool
+{
+    if (!(new ApplyJournal(CS_APPLY_JOURNAL_DIR))->hasPending()) {
+        return false;
     }
 
+    if ($onStage !== null) {
+        $onStage('resume');
+    }
+    return cs_build_applier($onStage)->resume(cs_apply_targets(cs_normalize_sync_mode($syncMode)), $confirmed);
+}
+
+/**
+ * @param ApplyOutcome|null $outcome receives what the apply executed
+ * @return array{create:int,update:int,delete:int}
+ */
+function cs_apply(
+    SchedulerRunResult $result,
+    ?string $syncMode = null,
+    ?\Closure $onStage = null,
+    ?ApplyOutcome &$outcome = null
+): array {
+    $syncMode = cs_normalize_sync_mode($syncMode ?? cs_get_sync_mode());
+    $targets = cs_apply_targets($syncMode);
+
     // Fail closed in one-way sync modes: never allow opposite-side executable writes.
     if ($syncMode !== CS_SYNC_MODE_BOTH) {
         $allowed = array_fill_keys($targets, true);
@@ -1584,147 +1703,298 @@ function cs_apply(SchedulerRunResult $result, ?string $syncMode = null): array
 
     $options = ApplyOptions::apply($targets, false);
 
-    $provider = cs_get_calendar_provider();
-    $calendarRuntime = ProviderRuntimeFactory::createApply($provider);
-
-    $applier = new ApplyRunner(
-        new ManifestWriter(CS_MANIFEST_PATH),
-        new FppScheduleAdapter(CS_SCHEDULE_PATH),
-        new FppScheduleWriter(CS_SCHEDULE_PATH, CS_FPP_STAGE_DIR),
-        $calendarRuntime
-    );
-
-    $applier->apply($result->reconciliationResult(), $options);
+    $outcome = cs_build_applier($onStage)->apply($result->reconciliationResult(), $options);
 
     return $result->totalCounts();
 }
 
 /**
- * @return array<string,int|string>
+ * Start (or join) the apply job and launch its detached worker.
+ *
+ * @return array<string,mixed>
  */
-function cs_reset_managed_colors(string $provider): array
+function cs_start_apply_job(string $syncMode, bool $confirmResume = false): array
 {
-    $provider = strtolower(trim($provider));
-    if ($provider === 'outlook') {
-        return cs_reset_outlook_managed_colors();
+    $job = ApplyJob::start($syncMode, CS_APPLY_JOBS_DIR, $confirmResume);
+    if ($job->created) {
+        try {
+            cs_spawn_apply_worker($job);
+        } catch (\Throwable $e) {
+            $job->fail($e->getMessage());
+            throw $e;
+        }
     }
 
-    return cs_reset_google_managed_colors();
+    return cs_apply_job_payload($job);
+}
+
+function cs_spawn_apply_worker(ApplyJob $job): void
+{
+    // PHP_BINARY is php-fpm under the web server; the worker needs the CLI binary.
+    $php = PHP_BINDIR . '/php';
+    if (!is_executable($php)) {
+        $php = 'php';
+    }
+
+    $command = sprintf(
+        'nohup %s %s --apply-job=%s > /dev/null 2>&1 &',
+        escapeshellarg($php),
+        escapeshellarg(__FILE__),
+        escapeshellarg($job->id)
+    );
+    $output = [];
+    $code = 0;
+    exec($command, $output, $code);
+    if ($code !== 0) {
+        throw new \RuntimeException("Unable to start apply worker (exit {$code})");
+    }
 }
 
 /**
- * @return array<string,int|string>
+ * Worker entrypoint: resume, fetch + plan, apply, then verify. Every stage is
+ * recorded on the job for apply_progress.
+ *
+ * Verification projects the post-apply preview from the plan and the apply
+ * outcome and re-reads only the provider events the apply touched. It falls
+ * back to a full fetch + plan when that check finds a mismatch, or always with
+ * the apply_full_verify preference on.
  */
-function cs_reset_google_managed_colors(): array
+function cs_run_apply_job(string $jobId): int
 {
-    cs_bootstrap_google_config_if_missing();
-    $config = new GoogleConfig(CS_GOOGLE_CONFIG_DIR);
-    $client = new GoogleApiClient($config);
-    $calendarId = $config->getCalendarId();
-    $events = $client->listEvents($calendarId);
+    $job = ApplyJob::open($jobId, CS_APPLY_JOBS_DIR);
+    if ($job === null || $job->isFinished()) {
+        fwrite(STDERR, "Unknown or finished apply job: {$jobId}\n");
+        return 1;
+    }
 
-    $scanned = 0;
-    $managed = 0;
-    $updated = 0;
+    $job->markRunning((int)getmypid());
+    $syncMode = cs_normalize_sync_mode($job->state()['syncMode'] ?? null);
+    $onStage = static function (string $stage, array $data = []) use ($job): void {
+        $job->emit($stage, $data);
+    };
+    $tracePath = cs_trace_start('apply');
 
-    foreach ($events as $event) {
-        if (!is_array($event)) {
-            continue;
-        }
-        $scanned++;
+    try {
+        Trace::begin('resume', 'apply');
+        $resumed = cs_resume_pending_apply($syncMode, $onStage, ($job->state()['confirmResume'] ?? false) === true);
+        Trace::end();
 
-        $meta = GoogleEventMetadataSchema::decodeFromGoogleEvent($event);
-        $settings = is_array($meta['settings'] ?? null) ? $meta['settings'] : [];
-        $type = is_string($settings['type'] ?? null) ? trim((string)$settings['type']) : '';
-        if ($type === '') {
-            continue;
-        }
-        $managed++;
+        $fetchStartedAt = time();
+        $job->emit('fetch');
+        $runResult = cs_run_preview_engine($syncMode);
+        $job->emit('plan', [
+            'actions' => count($runResult->reconciliationResult()->executableActions()),
+        ]);
 
-        $enabled = array_key_exists('enabled', $settings)
-            ? (bool)($settings['enabled'] ?? false)
-            : true;
-        $desiredColorId = MapperShared::managedGoogleColorId($type, $enabled);
-        $currentColorId = is_string($event['colorId'] ?? null) ? trim((string)$event['colorId']) : '';
-        if ($currentColorId === $desiredColorId) {
-            continue;
+        Trace::begin('apply', 'apply');
+        $outcome = null;
+        $applied = cs_apply($runResult, $syncMode, $onStage, $outcome);
+        Trace::end();
+        $appliedAt = time();
+
+        $verification = ['mode' => 'full'];
+        $post = null;
+        if (!cs_get_ui_pref_bool('apply_full_verify', false)) {
+            $job->emit('verify', ['mode' => 'touched']);
+            Trace::begin('verify touched', 'apply', ['links' => count($outcome->links)]);
+            $verification = ['mode' => 'touched'] + PostApplyProjection::verifyTouched(
+                $outcome,
+                ProviderRuntimeFactory::createEventLookup(cs_get_calendar_provider())
+            );
+            Trace::end(['mismatches' => count($verification['mismatches'])]);
+            if ($verification['mismatches'] === []) {
+                $post = PostApplyProjection::project($runResult, $outcome);
+            }
         }
-
-        $eventId = is_string($event['id'] ?? null) ? trim((string)$event['id']) : '';
-        if ($eventId === '') {
-            continue;
+        if ($post === null) {
+            $job->emit('verify', ['mode' => 'full']);
+            $post = cs_run_preview_engine($syncMode);
+        }
+        // Runs before finish(): while the job is active no other preview or
+        // apply can refresh the calendar snapshot the migration rewrites.
+        // A projected preview leaves the pre-apply snapshot in place; it is
+        // still current except for the events the apply touched.
+        if ($verification['mode'] === 'touched' && $verification['mismatches'] === []) {
+            cs_migrate_managed_metadata($fetchStartedAt, $verification['eventIds']);
+        } else {
+            cs_migrate_managed_metadata($appliedAt);
         }
+        cs_trace_finish($tracePath);
+        $job->finish([
+            'resumed' => $resumed,
+            'applied' => $applied,
+            'preview' => cs_preview_payload($post, $syncMode),
+            'verification' => $verification,
+            'trace' => $tracePath !== null ? basename($tracePath) : null,
+        ]);
+        return 0;
+    } catch (\Throwable $e) {
+        cs_trace_finish($tracePath);
+        $correlationId = cs_generate_correlation_id();
+        cs_log_correlated_error('apply', $e, $correlationId);
+        $job->fail($e->getMessage(), $correlationId);
+        return 1;
+    }
+}
 
-        $client->updateEvent($calendarId, $eventId, ['colorId' => $desiredColorId]);
-        $updated++;
+/**
+ * Pack a bounded batch of legacy-encoded managed event metadata from the
+ * calendar snapshot, skipping the events the apply just touched when that
+ * snapshot predates it. Runs once the job has finished, so it never delays or
+ * fails an apply; a later apply picks up what is left.
+ *
+ * @param array<int,string> $skipEventIds
+ */
+function cs_migrate_managed_metadata(int $notBefore, array $skipEventIds = []): void
+{
+    try {
+        $summary = (new ManagedMetadataMigration(CS_CALENDAR_SNAPSHOT_PATH))
+            ->run(cs_get_calendar_provider(), $notBefore, $skipEventIds);
+        if (($summary['failed'] ?? 0) > 0) {
+            error_log(sprintf(
+                '[CalendarScheduler] metadata migration: %d failed, first error: %s',
+                (int)$summary['failed'],
+                (string)($summary['firstError'] ?? '')
+            ));
+        }
+    } catch (\Throwable $e) {
+        cs_log_correlated_error('migrate_metadata', $e, cs_generate_correlation_id());
     }
+}
 
+/**
+ * @return array<string,mixed>
+ */
+function cs_apply_job_payload(ApplyJob $job): array
+{
+    $state = $job->state() ?? [];
     return [
-        'provider' => 'google',
-        'scanned' => $scanned,
-        'managed' => $managed,
-        'updated' => $updated,
+        'id' => $job->id,
+        'status' => $state['status'] ?? null,
+        'createdAt' => $state['createdAt'] ?? null,
+        'updatedAt' => $state['updatedAt'] ?? null,
+        'error' => $state['error'] ?? null,
+        'correlationId' => $state['correlationId'] ?? null,
     ];
 }
 
 /**
- * @return array<string,int|string>
+ * Stream job events as Server-Sent Events for one bounded window. The browser
+ * reconnects with Last-Event-ID, so a long apply never pins a PHP worker or
+ * trips proxy idle timeouts; the terminal "done"/"failed" event ends the job.
  */
-function cs_reset_outlook_managed_colors(): array
+function cs_stream_apply_progress(ApplyJob $job, int $after): void
 {
-    cs_bootstrap_outlook_config_if_missing();
-    $config = new OutlookConfig(CS_OUTLOOK_CONFIG_DIR);
-    $client = new OutlookApiClient($config);
-    cs_ensure_outlook_managed_master_categories($client);
-    $calendarId = $config->getCalendarId();
-    $events = $client->listEvents($calendarId);
-
-    $scanned = 0;
-    $managed = 0;
-    $updated = 0;
-
-    foreach ($events as $event) {
-        if (!is_array($event)) {
-            continue;
+    if (session_status() === PHP_SESSION_ACTIVE) {
+        session_write_close();
+    }
+    while (ob_get_level() > 0) {
+        ob_end_flush();
+    }
+
+    http_response_code(200);
+    header('Content-Type: text/event-stream');
+    header('Cache-Control: no-cache');
+    header('X-Accel-Buffering: no');
+    echo "retry: 1000\n\n";
+    flush();
+
+    $deadline = microtime(true) + CS_APPLY_PROGRESS_WINDOW_SECONDS;
+    $lastSentAt = microtime(true);
+    while (!connection_aborted()) {
+        $finished = $job->isFinished();
+        foreach ($job->events($after) as $seq => $event) {
+            if (($event['stage'] ?? null) === ApplyJob::STATUS_DONE) {
+                $event['result'] = $job->state()['result'] ?? null;
+            }
+            echo 'id: ' . $seq . "\n";
+            echo 'data: ' . json_encode($event, JSON_UNESCAPED_SLASHES) . "\n\n";
+            $after = $seq;
+            $lastSentAt = microtime(true);
         }
-        $scanned++;
+        flush();
 
-        $meta = OutlookEventMetadataSchema::decodeFromOutlookEvent($event);
-        $settings = is_array($meta['settings'] ?? null) ? $meta['settings'] : [];
-        $type = is_string($settings['type'] ?? null) ? trim((string)$settings['type']) : '';
-        if ($type === '') {
-            continue;
+        if ($finished || microtime(true) >= $deadline) {
+            break;
         }
-        $managed++;
-
-        $enabled = array_key_exists('enabled', $settings)
-            ? (bool)($settings['enabled'] ?? false)
-            : true;
-        $desired = MapperShared::managedOutlookCategories($type, $enabled);
-        sort($desired, SORT_STRING);
-
-        $current = is_array($event['categories'] ?? null) ? array_values($event['categories']) : [];
-        $current = array_values(array_filter($current, static fn ($v): bool => is_string($v) && trim((string)$v) !== ''));
-        sort($current, SORT_STRING);
-        if ($current === $desired) {
-            continue;
+        if (microtime(true) - $lastSentAt >= 10) {
+            echo ": keepalive\n\n";
+            flush();
+            $lastSentAt = microtime(true);
         }
+        usleep(250000);
+    }
+    exit;
+}
 
-        $eventId = is_string($event['id'] ?? null) ? trim((string)$event['id']) : '';
-        if ($eventId === '') {
-            continue;
-        }
+/**
+ * @return array<string,int|string>
+ */
+function cs_reset_managed_colors(string $provider, bool $refresh = false): array
+{
+    $provider = strtolower(trim($provider));
+    if ($provider === 'outlook') {
+        cs_bootstrap_outlook_config_if_missing();
+        cs_ensure_outlook_managed_master_categories(
+            new OutlookApiClient(new OutlookConfig(CS_OUTLOOK_CONFIG_DIR))
+        );
+    } else {
+        $provider = 'google';
+        cs_bootstrap_google_config_if_missing();
+    }
+
+    // Delta-only reset against the cached calendar snapshot while it is
+    // reusable; $refresh (an explicit reset) fetches a fresh one, since the
+    // cache may predate edits made in the calendar. Progress is persisted
+    // while the reset runs so the UI can poll it via reset_managed_colors_progress.
+    $reset = new ManagedColorReset(
+        CS_CALENDAR_SNAPSHOT_PATH,
+        ManagedColorReset::DEFAULT_SNAPSHOT_MAX_AGE_SECONDS,
+        null,
+        CS_MANIFEST_PATH
+    );
+    try {
+        return $reset->run(
+            $provider,
+            static function (array $progress): void {
+                cs_write_color_reset_progress($progress);
+            },
+            $refresh
+        );
+    } finally {
+        @unlink(CS_COLOR_RESET_PROGRESS_PATH);
+    }
+}
 
-        $client->updateEvent($calendarId, $eventId, ['categories' => $desired]);
-        $updated++;
+/**
+ * @param array{phase:string,done:int,total:int} $progress
+ */
+function cs_write_color_reset_progress(array $progress): void
+{
+    $progress['updatedAtUtc'] = gmdate(DATE_ATOM);
+    $json = json_encode($progress, JSON_UNESCAPED_SLASHES);
+    if (!is_string($json)) {
+        return;
     }
+    $tmp = CS_COLOR_RESET_PROGRESS_PATH . '.tmp';
+    if (@file_put_contents($tmp, $json . PHP_EOL) !== false) {
+        @rename($tmp, CS_COLOR_RESET_PROGRESS_PATH);
+    }
+}
 
-    return [
-        'provider' => 'outlook',
-        'scanned' => $scanned,
-        'managed' => $managed,
-        'updated' => $updated,
-    ];
+/**
+ * Progress of the running reset, or null when none is running.
+ *
+ * @return array<string,mixed>|null
+ */
+function cs_read_color_reset_progress(): ?array
+{
+    $raw = @file_get_contents(CS_COLOR_RESET_PROGRESS_PATH);
+    if (!is_string($raw) || trim($raw) === '') {
+        return null;
+    }
+    $decoded = json_decode($raw, true);
+    return is_array($decoded) ? $decoded : null;
 }
 
 function cs_ensure_outlook_managed_master_categories(OutlookApiClient $client): void
@@ -1766,6 +2036,14 @@ function cs_ensure_outlook_managed_master_categories(OutlookApiClient $client):
     }
 }
 
+// Detached apply worker (started by the apply action).
+if (PHP_SAPI === 'cli') {
+    $workerOpts = getopt('', ['apply-job:']);
+    if (isset($workerOpts['apply-job'])) {
+        exit(cs_run_apply_job((string)$workerOpts['apply-job']));
+    }
+}
+
 try {
     // Action dispatch for all UI-facing operations.
     $input = cs_read_json_input();
@@ -1806,6 +2084,7 @@ try {
             $hints[] = 'Unable to read managed color preference; using default disabled.';
             $google['setup']['hints'] = $hints;
         }
+        $applyJob = ApplyJob::active(CS_APPLY_JOBS_DIR);
         cs_respond([
             'ok' => true,
             'provider' => $provider,
@@ -1816,6 +2095,8 @@ try {
                 'connectionCollapsed' => $connectionCollapsed,
                 'enforceManagedColors' => $enforceManagedColors,
             ],
+            'pendingApply' => (new ApplyJournal(CS_APPLY_JOURNAL_DIR))->pendingSummary(),
+            'applyJob' => $applyJob !== null ? cs_apply_job_payload($applyJob) : null,
         ]);
     }
 
@@ -1877,13 +2158,14 @@ try {
             );
         }
         $key = trim($key);
-        if (!in_array($key, ['connection_collapsed', 'enforce_managed_colors'], true)) {
+        $allowedKeys = ['connection_collapsed', 'enforce_managed_colors', 'trace_runs', 'apply_full_verify'];
+        if (!in_array($key, $allowedKeys, true)) {
             cs_respond_error(
                 'unsupported key',
                 422,
-                'Only connection_collapsed and enforce_managed_colors are currently supported.',
+                'Only connection_collapsed, enforce_managed_colors, trace_runs and apply_full_verify are currently supported.',
                 'validation_error',
-                ['field' => 'key', 'allowed' => ['connection_collapsed', 'enforce_managed_colors']]
+                ['field' => 'key', 'allowed' => $allowedKeys]
             );
         }
         $rawValue = $input['value'] ?? false;
@@ -1906,13 +2188,23 @@ try {
 
     if ($action === 'reset_managed_colors') {
         $provider = cs_get_calendar_provider();
-        $summary = cs_reset_managed_colors($provider);
+        // An explicit reset fetches fresh; the UI's on-load reconcile passes
+        // refresh=false to reuse the cached snapshot.
+        $refresh = ($input['refresh'] ?? true) !== false;
+        $summary = cs_reset_managed_colors($provider, $refresh);
         cs_respond([
             'ok' => true,
             'summary' => $summary,
         ]);
     }
 
+    if ($action === 'reset_managed_colors_progress') {
+        cs_respond([
+            'ok' => true,
+            'progress' => cs_read_color_reset_progress(),
+        ]);
+    }
+
     if ($action === 'auth_device_start') {
         $provider = cs_resolve_provider_for_auth($input);
         if ($provider === 'outlook') {
@@ -2033,20 +2325,85 @@ try {
 
     if ($action === 'apply') {
         $syncMode = cs_normalize_sync_mode($input['sync_mode'] ?? cs_get_sync_mode());
-        $runResult = cs_run_preview_engine($syncMode);
-        $applied = cs_apply($runResult, $syncMode);
-        $post = cs_run_preview_engine($syncMode);
         cs_respond([
             'ok' => true,
-            'applied' => $applied,
-            'preview' => cs_preview_payload($post, $syncMode),
+            'job' => cs_start_apply_job($syncMode, ($input['confirm_resume'] ?? false) === true),
+        ], 202);
+    }
+
+    if ($action === 'discard_pending_apply') {
+        if (ApplyJob::active(CS_APPLY_JOBS_DIR) !== null) {
+            cs_respond_error('An apply is running', 409, 'Wait for the running apply to finish.', 'conflict');
+        }
+        $journal = new ApplyJournal(CS_APPLY_JOURNAL_DIR);
+        $discarded = $journal->hasPending();
+        $journal->discard();
+        cs_respond([
+            'ok' => true,
+            'discarded' => $discarded,
         ]);
     }
 
+    if ($action === 'apply_progress') {
+        $jobId = $input['job'] ?? $_GET['job'] ?? '';
+        $job = is_string($jobId) ? ApplyJob::open($jobId, CS_APPLY_JOBS_DIR) : null;
+        if ($job === null) {
+            cs_respond_error(
+                'Unknown apply job',
+                404,
+                'Start a new apply; job history keeps only recent jobs.',
+                'not_found',
+                ['field' => 'job']
+            );
+        }
+
+        $accept = (string)($_SERVER['HTTP_ACCEPT'] ?? '');
+        if (str_contains($accept, 'text/event-stream')) {
+            $after = (int)($_SERVER['HTTP_LAST_EVENT_ID'] ?? ($_GET['after'] ?? 0));
+            cs_stream_apply_progress($job, max(0, $after));
+        }
+
+        // Plain JSON snapshot for clients without EventSource.
+        $after = max(0, (int)($input['after'] ?? $_GET['after'] ?? 0));
+        $events = [];
+        foreach ($job->events($after) as $seq => $event) {
+            $events[] = ['seq' => $seq] + $event;
+        }
+        $payload = cs_apply_job_payload($job);
+        if ($payload['status'] === ApplyJob::STATUS_DONE) {
+            $payload['result'] = $job->state()['result'] ?? null;
+        }
+        cs_respond([
+            'ok' => true,
+            'job' => $payload,
+            'events' => $events,
+        ]);
+    }
+
+    if ($action === 'trace_download') {
+        $name = $input['name'] ?? $_GET['name'] ?? '';
+        $path = is_string($name) && preg_match('/^(preview|apply)-[0-9]{8}T[0-9]{6}Z-[0-9a-f]{6}\.json$/', $name) === 1
+            ? CS_TRACE_DIR . '/' . $name
+            : null;
+        if ($path === null || !is_file($path)) {
+            cs_respond_error(
+                'Unknown trace',
+                404,
+                'Pick a trace listed under diagnostics; only recent traces are kept.',
+                'not_found',
+                ['field' => 'name']
+            );
+        }
+
+        header('Content-Disposition: attachment; filename="' . $name . '"');
+        readfile($path);
+        exit;
+    }
+
     cs_respond_error(
         "Unknown action: {$action}",
         404,
-        'Use one of: status, diagnostics, preview, apply, auth_device_start, auth_device_poll, auth_disconnect, auth_outlook_save_config, set_provider.',
+        'Use one of: status, diagnostics, preview, apply, apply_progress, auth_device_start, auth_device_poll, auth_disconnect, auth_outlook_save_config, set_provider.',
         'unknown_action',
         ['action' => $action]
     );